@@ -21,10 +21,14 @@ namespace nana{	namespace audio
 			~audio_device();
 
 			bool empty() const;
-			bool open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample);
+			//The buffer_ms specifies the size of the device buffer in milliseconds, 0 for the default of the driver.
+			bool open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample, std::size_t buffer_ms = 0);
 			void close();
 			void prepare(buffer_preparation & buf_prep);
 			void write(buffer_preparation::meta * m);
+
+			//Writes the interleaved frames which are not held by a buffer_preparation, it blocks until the device accepts them.
+			void write(const void * frames, std::size_t bytes);
 			void wait_for_drain() const;
 		private:
 #if defined(NANA_WINDOWS)
@@ -36,6 +40,11 @@ namespace nana{	namespace audio
 			HWAVEOUT handle_;
 			std::recursive_mutex queue_lock_;
 			std::vector<buffer_preparation::meta*> done_queue_;
+
+			//The blocks for the write of frames, they are recycled in turn.
+			std::vector<WAVEHDR> raw_headers_;
+			std::vector<std::vector<char> > raw_blocks_;
+			std::size_t raw_next_;
 #elif defined(NANA_LINUX)
 			snd_pcm_t * handle_;
 			std::size_t rate_;
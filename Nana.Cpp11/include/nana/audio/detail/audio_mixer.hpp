@@ -0,0 +1,131 @@
+#ifndef NANA_AUDIO_DETAIL_AUDIO_MIXER_HPP
+#define NANA_AUDIO_DETAIL_AUDIO_MIXER_HPP
+#include <nana/traits.hpp>
+#include <nana/audio/mixer.hpp>
+#include <nana/audio/detail/audio_stream.hpp>
+#include <nana/audio/detail/buffer_preparation.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace nana{	namespace audio
+{
+	namespace detail
+	{
+		//struct pcm_data
+		//	The samples of a sound which are converted into floats in the range [-1, 1], interleaved by channels.
+		struct pcm_data
+		{
+			std::size_t channels;
+			std::size_t rate;
+			std::size_t frames;
+			std::vector<float> samples;
+
+			pcm_data();
+
+			//Reads all the PCM of the stream and converts them.
+			bool load(audio_stream&);
+		};
+
+		//class pcm_stream
+		//	A pcm_stream reads a long sound from its own file while it is played, a buffer_preparation reads
+		//	the file ahead of the mixer, the mixer never waits for the file.
+		class pcm_stream
+			: nana::noncopyable
+		{
+		public:
+			pcm_stream();
+
+			bool open(const nana::string& file);
+			std::size_t channels() const;
+			std::size_t rate() const;
+
+			//Converts the prepared PCM into floats without waiting, returns the number of frames.
+			std::size_t read(float* frames, std::size_t count);
+
+			//Returns true if all the PCM is read.
+			bool eof() const;
+		private:
+			audio_stream stream_;
+			std::unique_ptr<buffer_preparation> buffer_;
+			buffer_preparation::meta * block_;	//The block being converted.
+			std::size_t offset_;				//The bytes of block_ which are converted.
+			std::size_t bits_;
+		};
+
+		//class pcm_cache
+		//	The pcm_cache keeps the PCM of the short sounds which are played, keyed by the file name, so that
+		//	playing a sound again does not read the file. An entry is discarded if the size or the modified time
+		//	of its file is changed, and the least recently used entries are discarded beyond the capacity.
+		class pcm_cache
+			: nana::noncopyable
+		{
+			struct implementation;
+			pcm_cache();
+		public:
+			static pcm_cache& instance();
+
+			//Returns nullptr if the file is not cached or it is changed.
+			std::shared_ptr<const pcm_data> find(const nana::string& file);
+			void insert(const nana::string& file, const std::shared_ptr<const pcm_data>&);
+
+			//Returns true if a sound of the specified size is short enough to be cached, otherwise it is streamed.
+			bool cacheable(std::size_t bytes) const;
+			void capacity(std::size_t bytes);
+		private:
+			implementation * impl_;
+		};
+
+		//class audio_sink
+		//	The output of the mixer, it consumes the interleaved 16-bit frames. A sink of sound device
+		//	blocks until the frames are accepted, it paces the mixer.
+		class audio_sink
+		{
+		public:
+			virtual ~audio_sink(){}
+			virtual void write(const short* frames, std::size_t count) = 0;
+
+			//Returns the number of the frames which are buffered after they are written, a written frame is heard
+			//after this number of frames are written behind it.
+			virtual std::size_t latency() const
+			{
+				return 0;
+			}
+		};
+
+		//class audio_mixer
+		//	The audio_mixer mixes the voices by one thread. Each voice refers to a pcm_data which may be shared
+		//	by other voices, it is converted into the rate and channels of the output while it is mixed.
+		class audio_mixer
+			: nana::noncopyable
+		{
+			struct implementation;
+			audio_mixer();
+		public:
+			typedef std::function<void()> complete_handler;
+
+			//The mixer is kept alive until the program exits.
+			static audio_mixer& instance();
+
+			//Starts a voice, the handler is invoked in the thread of the mixer when the last frame of the voice
+			//is drained by the output, the handler must not wait for another voice. It is also invoked when the
+			//voice is stopped. Returns false if the voice has nothing to play, the handler is not invoked.
+			bool play(const std::shared_ptr<const pcm_data>&, float gain, const complete_handler&);
+			bool play(const std::shared_ptr<pcm_stream>&, float gain, const complete_handler&);
+
+			//Replaces the output, a nullptr is replaced by the sound device when a voice is played.
+			void output(std::unique_ptr<audio_sink>, std::size_t rate, std::size_t channels);
+			bool open_device(std::size_t rate, std::size_t channels);
+
+			void latency(std::size_t milliseconds);
+			void stop_all();
+			mixer::statistics_t statistics() const;
+		private:
+			void _m_run();
+		private:
+			implementation * impl_;
+		};
+	}//end namespace detail
+}//end namespace audio
+}//end namespace nana
+#endif
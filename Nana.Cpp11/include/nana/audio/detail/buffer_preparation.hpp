@@ -13,6 +13,8 @@
     #include <thread>
 #endif
 
+#include <atomic>
+
 #include <sstream>
 #include <vector>
 
@@ -24,6 +26,10 @@ namespace nana{	namespace audio
 {
 	namespace detail
 	{
+		//class buffer_preparation
+		//	The buffer_preparation reads the PCM ahead by a thread. The blocks form a single-producer/single-consumer
+		//	ring, the producer and the consumer exchange them through atomic counters without locking. A side waits
+		//	on a condition variable only when the ring is full or empty.
 		class buffer_preparation
 		{
 		public:
@@ -38,26 +44,45 @@ namespace nana{	namespace audio
 #endif
 
 		public:
-			buffer_preparation(audio_stream& as, std::size_t seconds);
+			//The blocks hold the PCM of latency_ms milliseconds.
+			buffer_preparation(audio_stream& as, std::size_t latency_ms, std::size_t blocks = 4);
 
 			~buffer_preparation();
 
+			//Waits for a block, returns nullptr if the PCM is drained.
 			meta * read();
-			//Revert the meta that returned by read()
+
+			//Returns a block without waiting, returns nullptr if no block is prepared.
+			meta * try_read();
+
+			//Revert the meta that returned by read(), the metas must be reverted in the order they are read.
 			void revert(meta * m);
+
+			//Returns true if all the PCM is read and all the blocks are reverted.
 			bool data_finished() const;
+
+			//Returns true if all the PCM is read.
+			bool drained() const;
 		private:
 			void _m_prepare_routine();
+
+			template<typename Predicate>
+			void _m_wait(std::atomic<bool>& waiting, Predicate);
+			void _m_signal(std::atomic<bool>& waiting);
 		private:
-			volatile bool running_;
-			volatile bool wait_for_buffer_;
-			std::thread thr_;
-			mutable std::mutex token_buffer_, token_prepared_;
-			mutable std::condition_variable	cond_buffer_, cond_prepared_;
+			std::vector<meta*> ring_;
+
+			//The counters of the blocks which are prepared, read and reverted. Only the producer increases
+			//prepared_, only the consumer increases read_ and reverted_.
+			std::atomic<std::size_t> prepared_, read_, reverted_;
+			std::atomic<bool> running_, finished_;
+			std::atomic<bool> producer_waiting_, consumer_waiting_;
+			std::mutex doorbell_;
+			std::condition_variable cond_;
 
-			std::vector<meta*> buffer_, prepared_;
 			std::size_t block_size_;
 			audio_stream & as_;
+			std::thread thr_;
 		};
 	}//end namespace detail
 }//end namespace audio
@@ -0,0 +1,46 @@
+#ifndef NANA_AUDIO_MIXER_HPP
+#define NANA_AUDIO_MIXER_HPP
+#include <nana/deploy.hpp>
+#include <cstddef>
+
+namespace nana{	namespace audio
+{
+	///	The mixer plays all the sounds of player::play_async through one output by one thread.
+	///	The output is the sound device by default, it is opened when the first sound is played.
+	class mixer
+	{
+	public:
+		struct statistics_t
+		{
+			std::size_t voices;				///< The number of the sounds which are playing.
+			std::size_t periods;			///< The number of the periods which are mixed.
+			unsigned long long frames;		///< The number of the frames which are mixed.
+			double mix_seconds;				///< The time spent in mixing, the writes to the output are excluded.
+			double period_seconds;			///< The duration of a period.
+		};
+
+		///	Plays through the sound device. If the device fails to open, the sounds are discarded at the rate of the device.
+		static bool output_device(std::size_t rate = 44100, std::size_t channels = 2);
+
+		///	Discards the mixed frames, at the rate of a device if it is paced, otherwise as fast as possible.
+		static void output_null(bool paced, std::size_t rate = 44100, std::size_t channels = 2);
+
+		///	Writes the mixed frames into a 16-bit WAV file as fast as possible, the file is finished when the output is changed.
+		static bool output_file(const nana::string& file, std::size_t rate = 44100, std::size_t channels = 2);
+
+		///	Sets the duration of a period in milliseconds, the sound device buffers 4 periods.
+		///	It takes effect when the output is opened.
+		static void latency(std::size_t milliseconds);
+
+		///	Sets the memory capacity of the decoded short sounds, a sound larger than 1/8 of the capacity
+		///	is read from its file while it is played.
+		static void cache_capacity(std::size_t bytes);
+
+		///	Stops all the sounds, their completion handlers are invoked in the calling thread.
+		static void stop_all();
+
+		static statistics_t statistics();
+	};
+}//end namespace audio
+}//end namespace nana
+#endif
@@ -2,6 +2,7 @@
 #define NANA_AUDIO_PLAYER_HPP
 #include <nana/traits.hpp>
 #include <nana/deploy.hpp>
+#include <functional>
 
 namespace nana{	namespace audio
 {
@@ -10,16 +11,28 @@ namespace nana{	namespace audio
 	{
 		struct implementation;
 	public:
+		///	The handler is invoked in the thread of the mixer when the sound is drained by the output, or when it is stopped
+		///	by mixer::stop_all. It should return quickly.
+		typedef std::function<void()> complete_handler;
+
 		player();
 		player(const nana::string& file);
 		~player();
 
 		bool open(const nana::string& file);
+
+		///	Plays the sound and waits until it is heard or stopped. It must not be called by a complete_handler.
 		void play();
+
+		///	Plays the sound through the mixer and returns immediately, the sounds played by this function may overlap.
+		///	The sound keeps playing even if the player is closed or destroyed.
+		bool play_async(float gain = 1.0f);
+		bool play_async(float gain, const complete_handler&);
+
 		void close();
 	private:
 		implementation* impl_;
 	};
 }//end namespace audio
 }//end namespace nana
-#endif
\ No newline at end of file
+#endif
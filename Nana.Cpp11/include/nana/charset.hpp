@@ -1,6 +1,7 @@
 #ifndef NANA_CHARSET_HPP
 #define NANA_CHARSET_HPP
 #include <string>
+#include <cstddef>
 
 namespace nana
 {
@@ -9,6 +10,25 @@ namespace nana
 		utf8, utf16, utf32
 	};
 
+	/// The transcoding functions between the UTF encodings. They append the result into an existing
+	/// string, so a caller can reuse its buffer. The invalid code units are replaced with U+FFFD.
+	namespace utf
+	{
+		/// Returns the number of the leading ASCII bytes.
+		std::size_t ascii_prefix(const char* s, std::size_t len);
+
+		/// Returns true if the bytes are a well-formed UTF-8 sequence.
+		bool validate_utf8(const char* s, std::size_t len);
+
+		void append_utf8(std::string& dst, const char32_t* s, std::size_t len);
+
+		/// Appends the UTF-8 of wide characters, the wide characters are UTF-32 if wchar_t is 4 bytes, otherwise UTF-16.
+		void append_utf8(std::string& dst, const wchar_t* s, std::size_t len);
+
+		void append_utf32(std::u32string& dst, const char* utf8, std::size_t len);
+		void append_wstring(std::wstring& dst, const char* utf8, std::size_t len);
+	}
+
 	namespace detail
 	{
 		class charset_encoding_interface;
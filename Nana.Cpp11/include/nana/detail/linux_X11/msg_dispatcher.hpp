@@ -19,11 +19,15 @@
 #define NANA_DETAIL_MSG_DISPATCHER_HPP
 #include "msg_packet.hpp"
 #include <nana/system/platform.hpp>
+#include <nana/gui/detail/task_queue.hpp>
 #include <list>
 #include <set>
 #include <map>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <cstddef>
 #include <memory>
 #include <thread>
 
@@ -33,29 +37,174 @@ namespace detail
 {
 	class msg_dispatcher
 	{
+		//class msg_ring
+		//@brief: A bounded multiple-producer single-consumer ring of messages. Every cell has a sequence number,
+		//	a producer claims a cell by a CAS on the tail and publishes it by the sequence, and the consumer
+		//	reads the cells in order, so neither of them takes a lock.
+		class msg_ring
+			: nana::noncopyable
+		{
+			struct cell
+			{
+				std::atomic<std::size_t> seq;
+				msg_packet_tag msg;
+			};
+		public:
+			enum{capacity = 1024};	//It must be a power of 2.
+
+			msg_ring()
+				: cells_(new cell[capacity]), head_(0), tail_(0)
+			{
+				for(std::size_t i = 0; i < capacity; ++i)
+					cells_[i].seq.store(i, std::memory_order_relaxed);
+			}
+
+			~msg_ring()
+			{
+				delete [] cells_;
+			}
+
+			//Returns false if the ring is full.
+			bool push(const msg_packet_tag& msg)
+			{
+				std::size_t pos = tail_.load(std::memory_order_relaxed);
+				while(true)
+				{
+					cell & c = cells_[pos & (capacity - 1)];
+					const std::size_t seq = c.seq.load(std::memory_order_acquire);
+					if(seq == pos)
+					{
+						if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							c.msg = msg;
+							c.seq.store(pos + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if(static_cast<std::ptrdiff_t>(seq - pos) < 0)
+						return false;
+					else
+						pos = tail_.load(std::memory_order_relaxed);
+				}
+			}
+
+			//The following functions are only called by the consumer.
+			bool pop(msg_packet_tag& msg)
+			{
+				cell & c = cells_[head_ & (capacity - 1)];
+				if(c.seq.load(std::memory_order_acquire) != head_ + 1)
+					return false;
+
+				msg = c.msg;
+				c.seq.store(head_ + capacity, std::memory_order_release);
+				++head_;
+				return true;
+			}
+
+			bool empty() const
+			{
+				return (cells_[head_ & (capacity - 1)].seq.load(std::memory_order_acquire) != head_ + 1);
+			}
+		private:
+			cell * const cells_;
+			std::size_t head_;
+			std::atomic<std::size_t> tail_;
+		};
+
+		//class thread_channel
+		//@brief: The channel of the tasks posted to a thread, the thread waits for the msgs and the tasks by its cond.
+		//	It is shared with the post targets, so it outlives the thread binder.
+		class thread_channel
+			: public nana::gui::detail::post_channel
+		{
+		public:
+			std::mutex	mutex;						//It is locked while the thread waits for the cond.
+			std::condition_variable	cond;
+			std::atomic<bool>	waiting;				//The thread is waiting for the cond.
+
+			thread_channel()
+				: waiting(false)
+			{}
+
+			//Wakes up the thread if it is waiting. The fence pairs with the fence in _m_wait_for_queue,
+			//either the waiting thread sees the new msg or this sees the waiting flag.
+			void notify()
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(waiting.load(std::memory_order_relaxed))
+				{
+					std::lock_guard<decltype(mutex)> lock(mutex);
+					cond.notify_one();
+				}
+			}
+		private:
+			bool wake()
+			{
+				notify();
+				return true;
+			}
+		};
+
 		struct thread_binder
 		{
 			unsigned tid;
 			std::mutex	mutex;
-			std::condition_variable	cond;
-			std::list<msg_packet_tag>	msg_queue;
-			std::set<Window> window;
+			msg_ring	ring;
+			std::list<msg_packet_tag>	overflow;	//The messages which are pushed while the ring is full, it is guarded by the mutex.
+			std::atomic<std::size_t>	overflow_size;
+			std::set<Window> window;					//It is guarded by the mutex.
+			std::atomic<std::size_t>	windows;		//The size of window.
+			std::atomic<std::size_t>	erasing;		//The number of cleanup msgs which are not read.
+			std::size_t depth;							//The number of nested dispatch loops.
+			std::shared_ptr<thread_channel> channel;	//The tasks which are posted by other threads.
+			bool task_turn;	//The tasks are run once between two messages.
+
+			thread_binder(unsigned tid)
+				: tid(tid), overflow_size(0), windows(0), erasing(0), depth(0), channel(std::make_shared<thread_channel>()), task_turn(true)
+			{}
 		};
 
+		//The msg driver caches the binding of window and thread, the cache is valid while the generation of
+		//the table is not changed. The generation is changed when a window or a thread binder is removed.
+		struct binding_cache
+		{
+			enum{size = 16};
+
+			std::size_t generation;
+			struct entry
+			{
+				Window wd;
+				thread_binder * thr;
+			}entries[size];
+
+			binding_cache()
+				: generation(0)
+			{
+				clear();
+			}
+
+			void clear()
+			{
+				for(auto & e : entries)
+				{
+					e.wd = 0;
+					e.thr = nullptr;
+				}
+			}
+		};
 	public:
 		typedef msg_packet_tag	msg_packet;
 		typedef void (*timer_proc_type)(unsigned tid);
 		typedef void (*event_proc_type)(Display*, msg_packet_tag&);
 		typedef int (*event_filter_type)(XEvent&, msg_packet_tag&);
 
-		typedef std::list<msg_packet_tag> msg_queue_type;
-
 		msg_dispatcher(Display* disp)
 			: display_(disp), is_work_(false)
 		{
 			proc_.event_proc = 0;
 			proc_.timer_proc = 0;
 			proc_.filter_proc = 0;
+			table_.generation = 1;
 		}
 
 		void set(timer_proc_type timer_proc, event_proc_type event_proc, event_filter_type filter)
@@ -81,8 +230,7 @@ namespace detail
 				std::map<unsigned, thread_binder*>::iterator i = table_.thr_table.find(tid);
 				if(i == table_.thr_table.end())
 				{
-					thr = new thread_binder;
-					thr->tid = tid;
+					thr = new thread_binder(tid);
 					table_.thr_table.insert(std::make_pair(tid, thr));
 				}
 				else
@@ -90,6 +238,7 @@ namespace detail
 
 				thr->mutex.lock();
 				thr->window.insert(wd);
+				thr->windows = thr->window.size();
 				thr->mutex.unlock();
 			
 				table_.wnd_table[wd] = thr;
@@ -110,56 +259,91 @@ namespace detail
 
 		void erase(Window wd)
 		{
-			std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
-			
-			auto i = table_.wnd_table.find(wd);
-			if(i != table_.wnd_table.end())
+			thread_binder * thr = nullptr;
 			{
-				thread_binder * const thr = i->second;
-				std::lock_guard<decltype(thr->mutex)> lock(thr->mutex);
-				for(auto li = thr->msg_queue.begin(); li != thr->msg_queue.end();)
+				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+				
+				auto i = table_.wnd_table.find(wd);
+				if(i != table_.wnd_table.end())
 				{
-					if(wd == _m_window(*li))
-						li = thr->msg_queue.erase(li);
+					thr = i->second;
+					table_.wnd_table.erase(i);
+					++table_.generation;
+
+					std::lock_guard<decltype(thr->mutex)> lock(thr->mutex);
+					thr->window.erase(wd);
+					thr->windows = thr->window.size();
+
+					//The queued msgs of the window are skipped by the reader while a cleanup msg is not read.
+					if(0 == thr->window.size())
+						thr = nullptr;
 					else
-						++li;
+						++thr->erasing;
 				}
 
-				table_.wnd_table.erase(i);
-				thr->window.erase(wd);
-				
 				//There still is at least one window alive.
-				if(thr->window.size())
+				if(thr)
 				{
 					//Make a cleanup msg packet to infor the dispatcher the window is closed.
 					msg_packet_tag msg;
 					msg.kind = msg.kind_cleanup;
 					msg.u.packet_window = wd;
-					thr->msg_queue.push_back(msg);
+					_m_push(thr, msg);
 				}
 			}
 		}
 
+		//channel
+		//@brief: Returns the channel of the thread which the window belongs to, the tasks posted to it are run in
+		//	the dispatch loop of the thread. It returns nullptr if the window is not registered.
+		std::shared_ptr<nana::gui::detail::post_channel> channel(Window wd)
+		{
+			std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+			auto i = table_.wnd_table.find(wd);
+			if(i == table_.wnd_table.end())
+				return nullptr;
+			return i->second->channel;
+		}
+
 		void dispatch(Window modal)
 		{
-			unsigned tid = nana::system::this_thread_id();
+			//The binder is only removed by its own thread when the outermost dispatch loop exits,
+			//so the loop reads its queue without looking up the table.
+			thread_binder * thr;
+			{
+				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+				auto i = table_.thr_table.find(nana::system::this_thread_id());
+				if(i == table_.thr_table.end())
+					return;
+				thr = i->second;
+			}
+
+			++thr->depth;
+
 			msg_packet_tag msg;
 			int qstate;
 			
 			//Test whether the thread is registered for window, and retrieve the queue state for event
-			while((qstate = _m_read_queue(tid, msg, modal)))
+			while((qstate = _m_read_queue(thr, msg, modal)))
 			{
 				//the queue is empty
 				if(-1 == qstate)
 				{
-					if(false == _m_wait_for_queue(tid))
-						proc_.timer_proc(tid);
+					if(false == _m_wait_for_queue(thr))
+						proc_.timer_proc(thr->tid);
+				}
+				else if(2 == qstate)
+				{
+					thr->channel->run();
 				}
 				else
 				{
 					proc_.event_proc(display_, msg);
 				}
 			}
+
+			if((0 == --thr->depth) && (0 == thr->windows))
+				_m_retire(thr);
 		}
 	private:
 		void _m_msg_driver()
@@ -168,6 +352,7 @@ namespace detail
 
 			msg_packet_tag msg_pack;
 			XEvent event;
+			binding_cache cache;
 			while(is_work_)
 			{
 				int pending;
@@ -201,7 +386,7 @@ namespace detail
 						msg_pack.kind = msg_pack.kind_xevent;
 						msg_pack.u.xevent = event;
 					case 1:
-						_m_msg_dispatch(msg_pack);
+						_m_msg_dispatch(msg_pack, cache);
 					}
 				}
 			}
@@ -232,87 +417,196 @@ namespace detail
 			return 0;
 		}
 
-		void _m_msg_dispatch(const msg_packet_tag &msg)
+		//Discards a msg which is not dispatched.
+		static void _m_discard(msg_packet_tag& msg)
 		{
-			std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
-			auto i = table_.wnd_table.find(_m_window(msg));
-			if(i != table_.wnd_table.end())
+			if(msg_packet_tag::kind_mouse_drop == msg.kind)
+				delete msg.u.mouse_drop.files;
+		}
+
+		static void _m_delete(thread_binder* thr)
+		{
+			msg_packet_tag msg;
+			while(thr->ring.pop(msg))
+				_m_discard(msg);
+
+			for(auto & m : thr->overflow)
+				_m_discard(m);
+			delete thr;
+		}
+
+		//Pushes a msg into the queue of the thread. When the ring is full, the msgs are kept in the overflow
+		//until the reader drains it, so the msgs from a producer are always read in order.
+		void _m_push(thread_binder* thr, const msg_packet_tag& msg)
+		{
+			if((0 == thr->overflow_size) && thr->ring.push(msg))
+			{
+				_m_signal(thr);
+				return;
+			}
+
 			{
-				thread_binder * const thr = i->second;
-				
 				std::lock_guard<decltype(thr->mutex)> lock(thr->mutex);
-				thr->msg_queue.push_back(msg);
-				thr->cond.notify_one();
+				thr->overflow.push_back(msg);
+				++thr->overflow_size;
 			}
+			_m_signal(thr);
 		}
 
-		//_m_read_queue
-		//@brief:Read the event from a specified thread queue.
-		//@return: 0 = exit the queue, 1 = fetch the msg, -1 = no msg
-		int _m_read_queue(unsigned tid, msg_packet_tag& msg, Window modal)
+		bool _m_pop(thread_binder* thr, msg_packet_tag& msg)
 		{
-			bool stop_driver = false;
+			if(thr->ring.pop(msg))
+				return true;
 
+			if(thr->overflow_size)
 			{
-				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
-				//Find the thread whether it is registered for the window.
-				auto i = table_.thr_table.find(tid);
-				if(i != table_.thr_table.end())
+				std::lock_guard<decltype(thr->mutex)> lock(thr->mutex);
+				if(thr->overflow.size())
 				{
-					if(i->second->window.size())
-					{
-						msg_queue_type & queue = i->second->msg_queue;
-						if(queue.size())
-						{
-							msg = queue.front();
-							queue.pop_front();
+					msg = thr->overflow.front();
+					thr->overflow.pop_front();
+					--thr->overflow_size;
+					return true;
+				}
+			}
+			return false;
+		}
 
-							//Check whether the event dispatcher is used for the modal window
-							//and when the modal window is closing, the event dispatcher would
-							//stop event pumping.
-							if((modal == msg.u.packet_window) && (msg.kind == msg.kind_cleanup))
-								return 0;
+		void _m_signal(thread_binder* thr)
+		{
+			thr->channel->notify();
+		}
 
-							return 1;
-						}
-						else
-							return -1;
-					}
+		void _m_msg_dispatch(const msg_packet_tag &msg, binding_cache& cache)
+		{
+			const std::size_t generation = table_.generation;
+			if(cache.generation != generation)
+			{
+				cache.clear();
+				cache.generation = generation;
 
-					delete i->second;
-					table_.thr_table.erase(i);
-					stop_driver = (table_.thr_table.size() == 0);
-				}
+				//The driver does not refer to any retired binder after clearing the cache.
+				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+				for(auto thr : table_.retired)
+					_m_delete(thr);
+				table_.retired.clear();
 			}
-			if(stop_driver)
+
+			const Window wd = _m_window(msg);
+			auto & e = cache.entries[wd & (binding_cache::size - 1)];
+			if(e.wd != wd || (nullptr == e.thr))
 			{
-				is_work_ = false;
-				thrd_->join();
-				thrd_.reset();
+				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+				auto i = table_.wnd_table.find(wd);
+				if(i == table_.wnd_table.end())
+					return;
+
+				e.wd = wd;
+				e.thr = i->second;
 			}
-			return 0;
+
+			_m_push(e.thr, msg);
 		}
 
-		//_m_wait_for_queue
-		//	wait for the insertion of queue.
-		//return@ it returns true if the queue is not empty, otherwise the wait is timeout.
-		bool _m_wait_for_queue(unsigned tid)
+		//Removes the binder of a thread which has no window, it is deleted by the msg driver.
+		void _m_retire(thread_binder* thr)
 		{
-			thread_binder * thr;
+			bool stop_driver = false;
+			//The tasks which are posted later are discarded.
+			thr->channel->close();
 			{
 				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
-				auto i = table_.thr_table.find(tid);
-				if(i != table_.thr_table.end())
+				table_.thr_table.erase(thr->tid);
+				table_.retired.push_back(thr);
+				++table_.generation;
+				stop_driver = (table_.thr_table.size() == 0);
+			}
+
+			if(stop_driver)
+			{
+				if(thrd_)
 				{
-					if(i->second->msg_queue.size())
-						return true;
-					thr = i->second;
+					is_work_ = false;
+					thrd_->join();
+					thrd_.reset();
 				}
+
+				std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+				for(auto thr : table_.retired)
+					_m_delete(thr);
+				table_.retired.clear();
 			}
-			
+		}
+
+		//_m_read_queue
+		//@brief:Read the event from the queue of a thread, it does not take a lock unless the ring is overflowed
+		//	or a window is being erased.
+		//@return: 0 = exit the queue, 1 = fetch the msg, 2 = run the posted tasks of thr, -1 = no msg
+		int _m_read_queue(thread_binder* thr, msg_packet_tag& msg, Window modal)
+		{
+			if(0 == thr->windows)
+				return 0;
+
+			if(thr->task_turn || thr->ring.empty())
+			{
+				thr->task_turn = false;
+				if(false == thr->channel->empty())
+					return 2;
+			}
+
+			while(_m_pop(thr, msg))
+			{
+				thr->task_turn = true;
+				if(msg.kind == msg.kind_cleanup)
+				{
+					--thr->erasing;
+
+					//Check whether the event dispatcher is used for the modal window
+					//and when the modal window is closing, the event dispatcher would
+					//stop event pumping.
+					if(modal == msg.u.packet_window)
+						return 0;
+				}
+				else if(thr->erasing)
+				{
+					//Skip the msg whose window has been erased.
+					std::unique_lock<decltype(thr->mutex)> lock(thr->mutex);
+					if(0 == thr->window.count(_m_window(msg)))
+					{
+						lock.unlock();
+						_m_discard(msg);
+						continue;
+					}
+				}
+				return 1;
+			}
+			return -1;
+		}
+
+		bool _m_ready(thread_binder* thr) const
+		{
+			return ((false == thr->ring.empty()) || thr->overflow_size || (false == thr->channel->empty()) || (0 == thr->windows));
+		}
+
+		//_m_wait_for_queue
+		//	wait for the insertion of queue.
+		//return@ it returns true if the queue is not empty, otherwise the wait is timeout.
+		bool _m_wait_for_queue(thread_binder* thr)
+		{
 			//Waits for notifying the condition variable, it indicates a new msg is pushing into the queue.
-			std::unique_lock<decltype(thr->mutex)> lock(thr->mutex);
-			return (thr->cond.wait_for(lock, std::chrono::milliseconds(10)) != std::cv_status::timeout);
+			auto & chn = *(thr->channel);
+			std::unique_lock<decltype(chn.mutex)> lock(chn.mutex);
+			chn.waiting = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			bool ready = _m_ready(thr);
+			if(false == ready)
+			{
+				chn.cond.wait_for(lock, std::chrono::milliseconds(10));
+				ready = _m_ready(thr);
+			}
+			chn.waiting = false;
+			return ready;
 		}
 		
 	private:
@@ -325,6 +619,8 @@ namespace detail
 			std::recursive_mutex mutex;
 			std::map<unsigned, thread_binder*> thr_table;
 			std::map<Window, thread_binder*> wnd_table;
+			std::vector<thread_binder*> retired;	//The binders which are removed, but may be referred by the msg driver.
+			std::atomic<std::size_t> generation;
 		}table_;
 
 		struct proc_tag
@@ -29,6 +29,7 @@
 #include <vector>
 #include <map>
 #include "msg_packet.hpp"
+#include <nana/gui/detail/task_queue.hpp>
 #if defined(NANA_UNICODE)
 	#include <X11/Xft/Xft.h>
 	#include <iconv.h>
@@ -235,6 +236,7 @@ namespace detail
 		void msg_insert(nana::gui::native_window_type);
 		void msg_set(timer_proc_type, event_proc_type);
 		void msg_dispatch(nana::gui::native_window_type modal);
+		std::shared_ptr<nana::gui::detail::post_channel> msg_channel(nana::gui::native_window_type);
 
 		//X Selections
 		void* request_selection(nana::gui::native_window_type requester, Atom type, size_t & bufsize);
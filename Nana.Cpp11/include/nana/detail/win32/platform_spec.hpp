@@ -63,6 +63,7 @@ namespace detail
 			operate_caret,	//wParam: 1=Destroy, 2=SetPos
 			remote_thread_set_window_pos,
 			remote_thread_set_window_text,
+			post_task,		//Runs the tasks which are posted by API::post
 			user,
 		};
 	};
@@ -40,6 +40,9 @@ namespace filesystem
 		fileinfo(const WIN32_FIND_DATA& wfd);
 #elif NANA_LINUX
 		fileinfo(const nana::string& filename, const struct stat &);
+
+		//The size is unknown, it is used when the type of file is known without a stat.
+		fileinfo(const nana::string& filename, bool directory);
 #endif
 		nana::string name;
 
@@ -54,10 +57,13 @@ namespace filesystem
 	public:
 		typedef FileInfo value_type;
 
-		basic_file_iterator():end_(true), handle_(nullptr){}
+		basic_file_iterator():end_(true), fetch_size_(true), handle_(nullptr){}
 
-		basic_file_iterator(const nana::string& file_path)
-			:end_(false), handle_(nullptr)
+		//On Linux, the type of an entry is taken from d_type of dirent if it is available, then an entry is
+		//stated only if its type is unknown or it is a symbolic link. If fetch_size is true, the regular files
+		//are stated for their sizes too, otherwise the size is 0 and the caller should stat the file if it needs.
+		basic_file_iterator(const nana::string& file_path, bool fetch_size = true)
+			:end_(false), fetch_size_(fetch_size), handle_(nullptr)
 		{
 			_m_prepare(file_path);
 		}
@@ -140,17 +146,8 @@ namespace filesystem
 						}
 					}
 
-					struct stat fst;
-					if(stat((path_ + dnt->d_name).c_str(), &fst) == 0)
-					{
-						value_ = value_type(nana::charset(dnt->d_name), fst);
-					}
-					else
-					{
-						value_.name = nana::charset(dnt->d_name);
-						value_.size = 0;
-						value_.directory = false;
-					}
+					path_size_ = path_.size();
+					_m_assign(dnt);
 					end_ = false;
 				}
 			}
@@ -194,17 +191,34 @@ namespace filesystem
 							return;
 						}
 					}
-					struct stat fst;
-					if(stat((path_ + "/" + dnt->d_name).c_str(), &fst) == 0)
-						value_ = value_type(nana::charset(dnt->d_name), fst);
-					else
-						value_.name = nana::charset(dnt->d_name);
+					_m_assign(dnt);
 				}
 				else
 					end_ = true;
 			#endif
 			}
 		}
+
+	#if defined(NANA_LINUX)
+		void _m_assign(const struct dirent * dnt)
+		{
+		#if defined(_DIRENT_HAVE_D_TYPE)
+			if((DT_DIR == dnt->d_type) || ((DT_REG == dnt->d_type) && (false == fetch_size_)))
+			{
+				value_ = value_type(nana::charset(dnt->d_name), (DT_DIR == dnt->d_type));
+				return;
+			}
+		#endif
+			//The path_ is reused as a buffer for the full path of the entry.
+			struct stat fst;
+			path_.resize(path_size_);
+			path_ += dnt->d_name;
+			if(stat(path_.c_str(), &fst) == 0)
+				value_ = value_type(nana::charset(dnt->d_name), fst);
+			else
+				value_ = value_type(nana::charset(dnt->d_name), false);
+		}
+	#endif
 	private:
 		struct inner_handle_deleter
 		{
@@ -223,12 +237,14 @@ namespace filesystem
 		};
 	private:
 		bool	end_;
+		bool	fetch_size_;
 
 #if defined(NANA_WINDOWS)
 		WIN32_FIND_DATA		wfd_;
 		nana::string	path_;
 #elif defined(NANA_LINUX)
 		std::string	path_;
+		std::size_t	path_size_;
 #endif
 		std::shared_ptr<find_handle_t> find_ptr_;
 
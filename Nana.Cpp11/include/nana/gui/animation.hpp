@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 
 namespace nana{	namespace gui
@@ -35,6 +36,15 @@ namespace nana{	namespace gui
 		void push_back(paint::image&&);
 		void push_back(framebuilder& fb, std::size_t length);
 		void push_back(framebuilder&& fb, std::size_t length);
+
+		/// Pushes a framebuilder whose frames are cached by a key. The framebuilders pushed with the same key share
+		/// the cached frames, e.g. the spinners of many windows are built once, so they must build the same frames.
+		void push_back(const framebuilder& fb, std::size_t length, const std::string& cache_key);
+
+		/// Sets the capacity in bytes of the cache of frames built by framebuilders, the default capacity is 32MB.
+		/// The frames built by a framebuilder are cached and shared by all the animations which play it or a framebuilder
+		/// pushed with the same cache key, therefore a framebuilder should build the same frame for the same position.
+		static void cache_capacity(std::size_t bytes);
 	private:
 		std::shared_ptr<impl> impl_;
 	};
@@ -48,8 +58,18 @@ namespace nana{	namespace gui
 		};
 		
 		struct impl;
-		class performance_manager;
+		class frame_scheduler;
 	public:
+		/// The frame-time statistics of an animation.
+		struct statistics_t
+		{
+			std::size_t rendered;	///< The number of rendered frames.
+			std::size_t skipped;	///< The number of frames skipped for keeping up with the clock.
+			double last_ms;			///< The time of rendering the last frame, in milliseconds.
+			double average_ms;		///< The average time of rendering a frame, in milliseconds.
+			double max_ms;			///< The maximum time of rendering a frame, in milliseconds.
+		};
+
 		animation();
 
 		void push_back(const frameset& frms);
@@ -74,6 +94,12 @@ namespace nana{	namespace gui
 		void pause();
 
 		void output(window wd, const nana::point& pos);
+
+		/// Sets the target frame rate, the default frame rate is 23 frames per second.
+		void fps(unsigned);
+		unsigned fps() const;
+
+		statistics_t statistics() const;
 	private:
 		impl * impl_;
 	};
@@ -16,12 +16,14 @@
 #include <nana/basic_types.hpp>
 #include <nana/system/platform.hpp>
 #include <nana/gui/effects.hpp>
+#include <atomic>
 
 namespace nana{	namespace gui{
 
 namespace detail
 {
 	struct basic_window;
+	struct event_table;
 
 	class caret_descriptor
 	{
@@ -96,7 +98,7 @@ namespace detail
 
 		template<typename Category>
 		basic_window(basic_window* parent, const rectangle& r, Category**)
-			: other(Category::value)
+			: other(Category::value), events(nullptr)
 		{
 			drawer.attached(this);
 			if(parent)
@@ -198,6 +200,7 @@ namespace detail
 			basic_window *active_window;	//if flags.take_active is false, the active_window still keeps the focus,
 											//if the active_window is null, the parent of this window keeps focus.
 			paint::graphics glass_buffer;	//if effect.bground is avaiable. Refer to window_layout::make_bground.
+			paint::pixel_buffer glass_source;	//The background under the glass window before taking the effect.
 			update_state	upd_state;
 
 			union
@@ -212,8 +215,13 @@ namespace detail
 
 		native_window_type	root;		//root Window handle
 		unsigned			thread_id;		//the identifier of the thread that created the window.
+		std::size_t			uid;			//the identifier of the window, it is never reused even if the address is reused.
 		unsigned			index;
 		container			children;
+
+		//The event handlers of the window, they are dispatched without a lock. It is created by the event_manager
+		//when the first handler is made. Refer to event_manager.
+		std::atomic<event_table*>	events;
 	};
 
 }//end namespace detail
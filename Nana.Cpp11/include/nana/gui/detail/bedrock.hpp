@@ -14,6 +14,7 @@
 #include "window_manager.hpp"
 #include "event_manager.hpp"
 #include "runtime_manager.hpp"
+#include "task_queue.hpp"
 
 namespace nana
 {
@@ -45,6 +46,11 @@ namespace detail
 		~bedrock();
 		void pump_event(window);
 		void map_thread_root_buffer(core_window_t* );
+
+		//channel
+		//@brief: returns the channel of the thread which the window belongs to, the tasks posted to the channel
+		//	are run in its event loop. The window must be available.
+		std::shared_ptr<post_channel> channel(core_window_t*);
 		static int inc_window(unsigned tid = 0);
 		thread_context* open_thread_context(unsigned tid = 0);
 		thread_context* get_thread_context(unsigned tid = 0);
@@ -67,6 +67,7 @@ namespace gui
 		{
 			//declaration
 			class object;
+			class layer;
 		}
 
 		//@brief:	Every window has a drawer, the drawer holds a drawer_trigger for
@@ -100,6 +101,7 @@ namespace gui
 			void key_up(const eventinfo&);
 			void shortkey(const eventinfo&);
 			void map(window);	//Copy the root buffer to screen
+			void map(window, const nana::rectangle& area);	//Copy an area of the root buffer to screen
 			void refresh();
 			drawer_trigger* realizer() const;
 			void attached(drawer_trigger&);
@@ -121,12 +123,14 @@ namespace gui
 			void _m_bground_pre();
 			void _m_bground_end();
 			void _m_draw_dynamic_drawing_object();
+			void _m_append(dynamic_drawing::object*);
 		public:
 			nana::paint::graphics graphics;
 		private:
 			basic_window*	core_window_;
 			drawer_trigger*	realizer_;
 			std::vector<dynamic_drawing::object*>	dynamic_drawing_objects_;
+			dynamic_drawing::layer*	layer_;	//It retains the objects when there are many of them.
 			bool refreshing_;
 		};
 	}//end namespace detail
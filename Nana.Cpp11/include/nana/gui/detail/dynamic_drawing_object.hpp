@@ -16,6 +16,9 @@
 
 #include <nana/paint/graphics.hpp>
 #include <nana/paint/image.hpp>
+#include <nana/paint/pixel_buffer.hpp>
+#include <vector>
+#include <algorithm>
 
 namespace nana
 {
@@ -36,6 +39,18 @@ namespace dynamic_drawing
 		{
 			return false;
 		}
+
+		//Returns false if the object can not be retained in a layer, because it may draw differently every time.
+		virtual bool retainable() const
+		{
+			return true;
+		}
+
+		//Retrieves the area where the object draws, it returns false if the area is unknown.
+		virtual bool area(const nana::paint::graphics&, nana::rectangle&) const
+		{
+			return false;
+		}
 		
 		virtual void draw(nana::paint::graphics&) const = 0;
 	};
@@ -58,6 +73,11 @@ namespace dynamic_drawing
 		{
 			return diehard_;
 		}
+
+		bool retainable() const
+		{
+			return false;
+		}
 	private:
 		bool diehard_;
 		std::function<void(paint::graphics&)> fn_;
@@ -84,6 +104,18 @@ namespace dynamic_drawing
 			delete [] text_;
 		}
 
+		bool area(const nana::paint::graphics& graph, nana::rectangle& r) const
+		{
+			if(graph.empty())
+				return false;
+
+			nana::size sz;
+			if(text_)
+				sz = graph.text_extent_size(text_);
+			r = nana::rectangle(x_, y_, sz.width, sz.height);
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			if(text_)	graph.string(x_, y_, color_, text_);
@@ -104,6 +136,15 @@ namespace dynamic_drawing
 		{
 		}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r.x = (std::min)(x_, x2_);
+			r.y = (std::min)(y_, y2_);
+			r.width = static_cast<unsigned>((std::max)(x_, x2_) - r.x) + 1;
+			r.height = static_cast<unsigned>((std::max)(y_, y2_) - r.y) + 1;
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			graph.line(x_, y_, x2_, y2_, color_);
@@ -122,6 +163,12 @@ namespace dynamic_drawing
 		{
 		}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r = nana::rectangle(x_, y_, width_, height_);
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			graph.rectangle(x_, y_, width_, height_, color_, issolid_);
@@ -142,6 +189,12 @@ namespace dynamic_drawing
 		{
 		}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r = nana::rectangle(x_, y_, width_, height_);
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			graph.shadow_rectangle(x_, y_, width_, height_, beg_, end_, vertical_);
@@ -161,10 +214,22 @@ namespace dynamic_drawing
 			:r_dst_(x, y, width, height), p_src_(srcx, srcy), graph_(source)
 		{}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r = r_dst_;
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			graph.bitblt(r_dst_, graph_, p_src_);
 		}
+
+		//The source graphics is shared with the caller, it may be changed after the object is made.
+		bool retainable() const
+		{
+			return false;
+		}
 	private:
 		nana::rectangle r_dst_;
 		nana::point p_src_;
@@ -179,10 +244,22 @@ namespace dynamic_drawing
 			: r_(srcx, srcy, width, height), p_dst_(x, y), img_(img)
 		{}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r = nana::rectangle(p_dst_.x, p_dst_.y, r_.width, r_.height);
+			return true;
+		}
+
 		void draw(nana::paint::graphics& graph) const
 		{
 			img_.paste(r_, graph, p_dst_);
 		}
+
+		//The source image is shared with the caller, it may be changed after the object is made.
+		bool retainable() const
+		{
+			return false;
+		}
 	private:
 		nana::rectangle r_;
 		nana::point p_dst_;
@@ -221,6 +298,12 @@ namespace dynamic_drawing
 			}
 		}
 
+		bool area(const nana::paint::graphics&, nana::rectangle& r) const
+		{
+			r = r_dst_;
+			return true;
+		}
+
 		void draw(nana::paint::graphics & graph) const
 		{
 			if(kind_ == kind_graph)
@@ -228,6 +311,12 @@ namespace dynamic_drawing
 			else
 				reinterpret_cast<const nana::paint::image*>(buffer)->stretch(r_src_, graph, r_dst_);
 		}
+
+		//The source graphics or image is shared with the caller, it may be changed after the object is made.
+		bool retainable() const
+		{
+			return false;
+		}
 	private:
 		nana::rectangle r_dst_;
 		nana::rectangle r_src_;
@@ -236,6 +325,294 @@ namespace dynamic_drawing
 		char buffer[fixed_buffer_size];
 	};
 
+	//class layer
+	//@brief: The layer retains the leading retainable drawing objects of a window. It rasterizes them into a surface
+	//	with alpha channel and composites the surface, instead of drawing every object for every refresh. The surface
+	//	is divided into tiles, and only the tiles covered by an appended or erased object are rasterized again.
+	//	The objects are rasterized on black and on white, the difference gives the alpha of a pixel, so that the
+	//	antialiased text is blended with what the widget draws under the objects.
+	class layer
+		: nana::noncopyable
+	{
+		enum{tile_size = 128, padding = 2};
+	public:
+		typedef std::vector<object*> container;
+
+		enum{threshold = 64};	//A window uses a layer when it has so many leading retainable objects.
+
+		//Returns the number of the leading retainable objects.
+		static std::size_t retainable(const container& objs)
+		{
+			std::size_t n = 0;
+			while(n < objs.size() && objs[n]->retainable())
+				++n;
+			return n;
+		}
+
+		layer(const container& objs, const paint::graphics& graph)
+			: retained_(0), dirty_all_(true), columns_(0), rows_(0)
+		{
+			_m_extend(objs, graph);
+		}
+
+		//Returns the number of the objects which are retained, they are the leading objects of the container.
+		std::size_t retained() const
+		{
+			return retained_;
+		}
+
+		//Rasterizes all the objects again, e.g. the typeface is changed.
+		void reset(const container& objs, const paint::graphics& graph)
+		{
+			retained_ = 0;
+			areas_.clear();
+			_m_extend(objs, graph);
+			dirty_all_ = true;
+		}
+
+		//An object is appended to the container.
+		void append(const container& objs, const paint::graphics& graph)
+		{
+			if(retained_ + 1 == objs.size())
+				_m_extend(objs, graph);
+		}
+
+		//The object at the position has been erased from the container.
+		void erase(const container& objs, std::size_t pos, const paint::graphics& graph)
+		{
+			if(pos < retained_)
+			{
+				_m_dirty(areas_[pos]);
+				areas_.erase(areas_.begin() + pos);
+				--retained_;
+			}
+
+			//The objects after an erased unretainable object may be retained.
+			if(pos <= retained_)
+				_m_extend(objs, graph);
+		}
+
+		//Rasterizes the dirty tiles and composites the surface onto the graphics.
+		void render(const container& objs, paint::graphics& graph)
+		{
+			const nana::size sz = graph.size();
+			if(sz != size_)
+				_m_resize(sz);
+
+			if(dirty_all_)
+			{
+				std::fill(dirty_.begin(), dirty_.end(), true);
+				dirty_all_ = false;
+			}
+
+			if(std::find(dirty_.begin(), dirty_.end(), true) != dirty_.end())
+				_m_rasterize(objs, graph);
+
+			if(content_.width && content_.height)
+				surface_.paste(content_, graph.handle(), content_.x, content_.y);
+		}
+	private:
+		void _m_extend(const container& objs, const paint::graphics& graph)
+		{
+			for(; retained_ < objs.size() && objs[retained_]->retainable(); ++retained_)
+			{
+				nana::rectangle r;
+				if(objs[retained_]->area(graph, r))
+				{
+					//The antialiased edges may be out of the area.
+					r.x -= padding;
+					r.y -= padding;
+					r.width += padding * 2;
+					r.height += padding * 2;
+				}
+				else
+					r = nana::rectangle(0, 0, 0x7FFFFFFF, 0x7FFFFFFF);
+
+				areas_.push_back(r);
+				_m_dirty(r);
+			}
+		}
+
+		void _m_resize(const nana::size& sz)
+		{
+			size_ = sz;
+			columns_ = (sz.width + tile_size - 1) / tile_size;
+			rows_ = (sz.height + tile_size - 1) / tile_size;
+			dirty_.assign(columns_ * rows_, true);
+			filled_.assign(columns_ * rows_, false);
+			content_ = nana::rectangle();
+
+			if(sz.width && sz.height)
+			{
+				black_.make(sz.width, sz.height);
+				white_.make(sz.width, sz.height);
+				surface_.open(sz.width, sz.height);
+				surface_.alpha_channel(true);
+			}
+			else
+			{
+				black_.release();
+				white_.release();
+				surface_.close();
+			}
+		}
+
+		//Retrieves the range of tiles which are covered by the area, it returns false if none.
+		bool _m_tiles(const nana::rectangle& r, unsigned& left, unsigned& top, unsigned& right, unsigned& bottom) const
+		{
+			const long long x_end = static_cast<long long>(r.x) + r.width;
+			const long long y_end = static_cast<long long>(r.y) + r.height;
+			if(0 == columns_ || 0 == rows_ || x_end <= 0 || y_end <= 0 || r.x >= static_cast<int>(size_.width) || r.y >= static_cast<int>(size_.height))
+				return false;
+
+			left = (r.x > 0 ? r.x / tile_size : 0);
+			top = (r.y > 0 ? r.y / tile_size : 0);
+			right = static_cast<unsigned>((std::min)(x_end, static_cast<long long>(size_.width)) - 1) / tile_size;
+			bottom = static_cast<unsigned>((std::min)(y_end, static_cast<long long>(size_.height)) - 1) / tile_size;
+			return true;
+		}
+
+		void _m_dirty(const nana::rectangle& r)
+		{
+			unsigned left, top, right, bottom;
+			if(dirty_all_ || (false == _m_tiles(r, left, top, right, bottom)))
+				return;
+
+			for(unsigned row = top; row <= bottom; ++row)
+			{
+				for(unsigned col = left; col <= right; ++col)
+					dirty_[row * columns_ + col] = true;
+			}
+		}
+
+		bool _m_covers_dirty(const nana::rectangle& r) const
+		{
+			unsigned left, top, right, bottom;
+			if(false == _m_tiles(r, left, top, right, bottom))
+				return false;
+
+			for(unsigned row = top; row <= bottom; ++row)
+			{
+				for(unsigned col = left; col <= right; ++col)
+				{
+					if(dirty_[row * columns_ + col])
+						return true;
+				}
+			}
+			return false;
+		}
+
+		nana::rectangle _m_tile_rectangle(std::size_t tile) const
+		{
+			nana::rectangle r(static_cast<int>(tile % columns_) * tile_size, static_cast<int>(tile / columns_) * tile_size, tile_size, tile_size);
+			r.width = (std::min)(r.width, size_.width - r.x);
+			r.height = (std::min)(r.height, size_.height - r.y);
+			return r;
+		}
+
+		void _m_rasterize(const container& objs, const paint::graphics& graph)
+		{
+			black_.typeface(graph.typeface());
+			white_.typeface(graph.typeface());
+
+			for(std::size_t tile = 0; tile < dirty_.size(); ++tile)
+			{
+				if(dirty_[tile])
+				{
+					const nana::rectangle r = _m_tile_rectangle(tile);
+					black_.rectangle(r, 0x0, true);
+					white_.rectangle(r, 0xFFFFFF, true);
+				}
+			}
+
+			//The objects may draw out of the dirty tiles, but only the dirty tiles are read.
+			for(std::size_t i = 0; i < retained_; ++i)
+			{
+				if(_m_covers_dirty(areas_[i]))
+				{
+					objs[i]->draw(black_);
+					objs[i]->draw(white_);
+				}
+			}
+
+			for(std::size_t tile = 0; tile < dirty_.size(); ++tile)
+			{
+				if(dirty_[tile])
+				{
+					filled_[tile] = _m_extract(_m_tile_rectangle(tile));
+					dirty_[tile] = false;
+				}
+			}
+
+			content_ = nana::rectangle();
+			for(std::size_t tile = 0; tile < filled_.size(); ++tile)
+			{
+				if(filled_[tile])
+				{
+					const nana::rectangle r = _m_tile_rectangle(tile);
+					if(content_.width)
+					{
+						const int right = (std::max)(content_.x + static_cast<int>(content_.width), r.x + static_cast<int>(r.width));
+						const int bottom = (std::max)(content_.y + static_cast<int>(content_.height), r.y + static_cast<int>(r.height));
+						content_.x = (std::min)(content_.x, r.x);
+						content_.y = (std::min)(content_.y, r.y);
+						content_.width = static_cast<unsigned>(right - content_.x);
+						content_.height = static_cast<unsigned>(bottom - content_.y);
+					}
+					else
+						content_ = r;
+				}
+			}
+		}
+
+		//Computes the pixels of a tile from the black and the white rasterization, it returns false if the tile is transparent.
+		bool _m_extract(const nana::rectangle& r)
+		{
+			paint::pixel_buffer black, white;
+			if((false == black.open(black_.handle(), r)) || (false == white.open(white_.handle(), r)))
+				return false;
+
+			bool filled = false;
+			for(unsigned y = 0; y < r.height; ++y)
+			{
+				const pixel_rgb_t * b = black.raw_ptr(y);
+				const pixel_rgb_t * w = white.raw_ptr(y);
+				pixel_rgb_t * px = surface_.raw_ptr(r.y + y) + r.x;
+				for(unsigned x = 0; x < r.width; ++x, ++b, ++w, ++px)
+				{
+					const int diff = (static_cast<int>(w->u.element.red) - static_cast<int>(b->u.element.red)
+									+ static_cast<int>(w->u.element.green) - static_cast<int>(b->u.element.green)
+									+ static_cast<int>(w->u.element.blue) - static_cast<int>(b->u.element.blue)) / 3;
+
+					const unsigned alpha = static_cast<unsigned>(255 - (std::min)((std::max)(diff, 0), 255));
+					if(alpha)
+					{
+						px->u.element.red = (std::min)(b->u.element.red * 255 / alpha, 255u);
+						px->u.element.green = (std::min)(b->u.element.green * 255 / alpha, 255u);
+						px->u.element.blue = (std::min)(b->u.element.blue * 255 / alpha, 255u);
+						px->u.element.alpha_channel = alpha;
+						filled = true;
+					}
+					else
+						px->u.color = 0;
+				}
+			}
+			return filled;
+		}
+	private:
+		std::size_t retained_;
+		std::vector<nana::rectangle> areas_;	//The areas of the retained objects.
+		bool dirty_all_;
+
+		nana::size size_;
+		unsigned columns_, rows_;
+		std::vector<bool> dirty_;
+		std::vector<bool> filled_;	//Whether a tile has a pixel which is not transparent.
+		nana::rectangle content_;	//The area of the filled tiles.
+
+		paint::graphics black_, white_;
+		paint::pixel_buffer surface_;
+	};
 }//end namespace dynamic_drawing
 }//end namespace detail
 }//end namespace gui
@@ -14,9 +14,10 @@
 
 #include <vector>
 #include <map>
+#include <set>
+#include <atomic>
 #include "../basis.hpp"
 #include "eventinfo.hpp"
-#include "handle_manager.hpp"
 #include <functional>
 
 #if defined(STD_THREAD_NOT_SUPPORTED)
@@ -45,7 +46,24 @@ namespace detail
 		unsigned						event_identifier;	//What event it is
 		nana::gui::window				window;				//Which window creates this event
 		nana::gui::window				listener;			//Which window listens this event
-		std::vector<abstract_handler*>*	container;			//refer to the container which contains this object's address
+		bool							for_drawer;			//Whether it is a handler of drawer or a user callback
+		std::atomic<bool>				alive;				//It is false when the handler is deleted while it is being dispatched
+	};
+
+	//handler_array
+	//@brief: an array of handlers is never changed after it is published, making or deleting a handler
+	//	publishes a new array, so that the handlers are dispatched without a lock.
+	typedef std::vector<abstract_handler*> handler_array;
+
+	//struct event_table
+	//@brief: event_table keeps the handlers of a window, the drawer handlers and the user handlers of an event
+	//	are kept in two arrays. It is referred by basic_window::events.
+	struct event_table
+	{
+		std::atomic<const handler_array*> handlers[event_tag::count][2];
+		bool on_window;		//Whether basic_window::events refers to the table
+
+		event_table();
 	};
 
 	//struct handler
@@ -91,7 +109,8 @@ namespace detail
 			both, trigger, user
 		};
 
-		typedef nana::gui::detail::handle_manager<abstract_handler*, nana::null_type> handle_manager_type;
+		event_manager();
+		~event_manager();
 
 		template<typename Function>
 		event_handle make_for_drawer(unsigned evtid, window wd, category::flags categ, Function function)
@@ -121,6 +140,8 @@ namespace detail
 		//If only_for_drawer is true, it only deletes user events.
 		void umake(window, bool only_for_drawer);
 		bool answer(unsigned eventid, window, eventinfo&, event_kind);
+
+		//Deletes the handlers and arrays which are retired, if no thread is dispatching them.
 		void remove_trash_handle(unsigned tid);
 
 		void write_off_bind(event_handle);
@@ -223,10 +244,33 @@ namespace detail
 			}
 		};
 	private:
+		struct reader_guard;
+		struct retired_t
+		{
+			unsigned epoch;
+			const handler_array * array;
+			event_table * table;
+			abstract_handler * handler;
+		};
+
 		event_handle _m_make(unsigned evtid, window, abstract_handler* abs_handler, bool drawer_handler, window listener);
+		event_table* _m_table(unsigned evtid, window, bool create);
+		void _m_remove(abstract_handler*);
+		void _m_publish(std::atomic<const handler_array*>&, handler_array*);
+		void _m_retire(const handler_array*, event_table*, abstract_handler*);
+		void _m_reclaim();
 	private:
 		static std::recursive_mutex mutex_;
-		handle_manager_type handle_manager_;
+
+		//The handlers are dispatched in an epoch, the retired objects are deleted after the threads which are
+		//dispatching in the epoch when they are retired leave.
+		std::atomic<unsigned> epoch_;
+		std::atomic<std::size_t> readers_[2];
+		std::vector<retired_t>	retired_;
+		std::atomic<std::size_t> retired_size_;
+
+		std::set<abstract_handler*>	handlers_;
+		std::map<window, event_table*>	tables_;	//The tables of windows and timers, an elapse handler is dispatched by this map.
 		std::map<window, std::vector<event_handle> >	bind_cont_;
 	};
 }//end namespace detail
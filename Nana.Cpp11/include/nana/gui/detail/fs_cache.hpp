@@ -0,0 +1,362 @@
+/*
+ *	Filesystem Listing Cache Implementation
+ *	Copyright(C) 2003-2013 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/gui/detail/fs_cache.hpp
+ *
+ *	The fs_cache keeps the listings of the directories which are shown by the filebox on Linux,
+ *	and watches them by inotify.
+ */
+
+#ifndef NANA_GUI_DETAIL_FS_CACHE_HPP
+#define NANA_GUI_DETAIL_FS_CACHE_HPP
+
+#include <nana/basic_types.hpp>
+#include <nana/charset.hpp>
+#include <nana/traits.hpp>
+#include <algorithm>
+#include <mutex>
+#include <ctime>
+#include <list>
+#include <map>
+#include <vector>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nana{	namespace gui{	namespace detail
+{
+	struct item_fs
+	{
+		nana::string name;
+		::tm modified_time;
+		bool directory;
+		nana::long_long_t bytes;
+		bool detailed;	//The size and time are unknown until it is stated by the scanner.
+	};
+
+	//insert_fs
+	//@brief: The directories come before the files in a listing. A directory is inserted before the first file
+	//	and a file is appended, it returns the position of the entry.
+	inline std::size_t insert_fs(std::vector<item_fs>& items, const item_fs& m)
+	{
+		if(false == m.directory)
+		{
+			items.push_back(m);
+			return items.size() - 1;
+		}
+
+		auto i = std::partition_point(items.begin(), items.end(), [](const item_fs& fs){ return fs.directory; });
+		return (items.insert(i, m) - items.begin());
+	}
+
+	//class fs_cache
+	//	The fs_cache keeps the listings of the scanned directories, so that revisiting a directory does not scan
+	//	it again. A cached directory is watched by inotify, a changed entry is stated again and applied to the
+	//	listing, and a directory which is changed too much is dropped. The listings are shared by the fileboxes
+	//	of the process, they are bounded by the number of entries. The events are read by whichever filebox
+	//	asks first, so the changes are queued for every listener until it polls them.
+	class fs_cache
+		: nana::noncopyable
+	{
+		struct listing
+		{
+			nana::string path;
+			int watch;
+			bool complete;
+			std::vector<item_fs> items;
+		};
+
+		//The most recently used listing is at the front.
+		typedef std::list<listing> container;
+
+		enum{capacity = 200000, changes_per_listing = 64};
+	public:
+		struct change
+		{
+			nana::string path;
+			nana::string name;	//It is empty if the whole directory is changed.
+		};
+
+		//The fileboxes share the instance of the process, an object which is created elsewhere is independent of it.
+		static fs_cache& instance()
+		{
+			static fs_cache * object = new fs_cache;
+			return *object;
+		}
+
+		fs_cache()
+			: fd_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), entries_(0), listener_(0)
+		{}
+
+		~fs_cache()
+		{
+			if(fd_ >= 0)
+				::close(fd_);
+		}
+
+		//Copies the listing of a directory, returns false if it is not cached.
+		bool fetch(const nana::string& path, std::vector<item_fs>& items)
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+			//Apply the pending events, so that a change which is made just now is not missed.
+			_m_read_events();
+
+			auto i = index_.find(path);
+			if((i == index_.end()) || (false == i->second->complete))
+				return false;
+
+			listings_.splice(listings_.begin(), listings_, i->second);
+			items = i->second->items;
+			return true;
+		}
+
+		//Starts watching a directory before it is scanned, so that a change during the scan is not missed.
+		void watch(const nana::string& path)
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			if(fd_ < 0)
+				return;
+
+			auto i = index_.find(path);
+			if(i != index_.end())
+			{
+				listings_.splice(listings_.begin(), listings_, i->second);
+				return;
+			}
+
+			const int wd = ::inotify_add_watch(fd_, static_cast<std::string>(nana::charset(path)).c_str(),
+								IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE |
+								IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+
+			//A directory which is reached by another path shares the watch, it is not cached twice.
+			if((wd < 0) || (watches_.count(wd)))
+				return;
+
+			listing l;
+			l.path = path;
+			l.watch = wd;
+			l.complete = false;
+			listings_.push_front(l);
+			index_[path] = listings_.begin();
+			watches_[wd] = listings_.begin();
+			++entries_;
+			_m_shrink();
+		}
+
+		//Stores the listing of a scanned directory, it is ignored if the directory is not watched.
+		void store(const nana::string& path, const std::vector<item_fs>& items)
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			auto i = index_.find(path);
+			if(i == index_.end())
+				return;
+
+			auto & l = *(i->second);
+			entries_ += items.size();
+			entries_ -= l.items.size();
+			l.items = items;
+			l.complete = true;
+			_m_shrink();
+		}
+
+		//Registers a listener, it returns the identifier which is passed to poll and unlisten.
+		std::size_t listen()
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			queues_[++listener_];
+			return listener_;
+		}
+
+		void unlisten(std::size_t listener)
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			queues_.erase(listener);
+		}
+
+		//Reads the events of inotify, applies them to the listings and reports the changes which are queued
+		//for the listener since its last poll.
+		void poll(std::size_t listener, std::vector<change>& changes)
+		{
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			_m_read_events();
+
+			auto i = queues_.find(listener);
+			if(i != queues_.end())
+				changes.swap(i->second);
+		}
+
+		static bool stat_entry(const nana::string& path, const nana::string& name, item_fs& m)
+		{
+			struct stat fst;
+			if(0 != ::stat(static_cast<std::string>(nana::charset(path + name)).c_str(), &fst))
+				return false;
+
+			m.name = name;
+			m.directory = (0 != S_ISDIR(fst.st_mode));
+			m.bytes = fst.st_size;
+			m.detailed = true;
+			::localtime_r(&fst.st_ctime, &m.modified_time);
+			return true;
+		}
+	private:
+		//Reads the events of inotify and queues the changes for every listener.
+		void _m_read_events()
+		{
+			std::vector<change> changes;
+			_m_read_events(changes);
+			if(changes.empty())
+				return;
+
+			for(auto & q : queues_)
+				q.second.insert(q.second.end(), changes.begin(), changes.end());
+		}
+
+		void _m_read_events(std::vector<change>& changes)
+		{
+			if(fd_ < 0)
+				return;
+
+			struct pending_t
+			{
+				bool whole;
+				std::vector<nana::string> names;
+			};
+
+			std::map<int, pending_t> pending;
+			bool overflow = false;
+
+			alignas(struct inotify_event) char buf[4096];
+			while(true)
+			{
+				const ssize_t len = ::read(fd_, buf, sizeof(buf));
+				if(len <= 0)
+					break;
+
+				for(const char * p = buf; p < buf + len; )
+				{
+					auto ev = reinterpret_cast<const struct inotify_event*>(p);
+					p += sizeof(struct inotify_event) + ev->len;
+
+					if(ev->mask & IN_Q_OVERFLOW)
+					{
+						overflow = true;
+						continue;
+					}
+
+					if(0 == watches_.count(ev->wd))
+						continue;
+
+					auto & pd = pending[ev->wd];
+					if(ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+						pd.whole = true;
+					else if(ev->len && (ev->name[0] != '.'))
+						pd.names.push_back(nana::charset(std::string(ev->name)));
+				}
+			}
+
+			//The events are lost, every cached directory is considered to be changed.
+			if(overflow)
+			{
+				for(auto & l : listings_)
+				{
+					change ch;
+					ch.path = l.path;
+					changes.push_back(ch);
+				}
+
+				while(listings_.size())
+					_m_drop(listings_.begin());
+				return;
+			}
+
+			for(auto & wp : pending)
+			{
+				auto & pd = wp.second;
+				auto li = watches_[wp.first];
+
+				std::sort(pd.names.begin(), pd.names.end());
+				pd.names.erase(std::unique(pd.names.begin(), pd.names.end()), pd.names.end());
+
+				change ch;
+				ch.path = li->path;
+				if(pd.whole || (pd.names.size() > changes_per_listing))
+				{
+					changes.push_back(ch);
+					_m_drop(li);
+					continue;
+				}
+
+				for(auto & name : pd.names)
+				{
+					ch.name = name;
+					changes.push_back(ch);
+
+					//An incomplete listing is being scanned, the filebox which scans it applies the change.
+					if(li->complete)
+					{
+						entries_ -= li->items.size();
+						_m_apply(*li, name);
+						entries_ += li->items.size();
+					}
+				}
+			}
+		}
+
+		static void _m_apply(listing& l, const nana::string& name)
+		{
+			auto i = std::find_if(l.items.begin(), l.items.end(), [&name](const item_fs& m){ return (m.name == name); });
+
+			item_fs m;
+			if(stat_entry(l.path, name, m))
+			{
+				if((i != l.items.end()) && (i->directory == m.directory))
+				{
+					*i = m;
+					return;
+				}
+
+				//An entry which is replaced by another type is moved to the position of the type.
+				if(i != l.items.end())
+					l.items.erase(i);
+				insert_fs(l.items, m);
+			}
+			else if(i != l.items.end())
+				l.items.erase(i);
+		}
+
+		void _m_shrink()
+		{
+			//The most recently used listing is kept even if it exceeds the capacity.
+			while((entries_ > capacity) && (listings_.size() > 1))
+				_m_drop(--listings_.end());
+		}
+
+		void _m_drop(container::iterator i)
+		{
+			::inotify_rm_watch(fd_, i->watch);
+			entries_ -= (1 + i->items.size());
+			index_.erase(i->path);
+			watches_.erase(i->watch);
+			listings_.erase(i);
+		}
+	private:
+		std::mutex mutex_;
+		const int fd_;
+		std::size_t entries_;	//A listing counts its entries and itself.
+		container listings_;
+		std::map<nana::string, container::iterator> index_;
+		std::map<int, container::iterator> watches_;
+		std::size_t listener_;	//The last identifier of the listeners.
+		std::map<std::size_t, std::vector<change> > queues_;
+	};
+}//end namespace detail
+}//end namespace gui
+}//end namespace nana
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ *	Task Queue Implementation
+ *	Copyright(C) 2003-2013 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/gui/detail/task_queue.hpp
+ *
+ *	The task_queue keeps the tasks that are posted to a GUI thread by API::post, and the post_channel
+ *	shares it between the thread and the producers.
+ */
+
+#ifndef NANA_GUI_DETAIL_TASK_QUEUE_HPP
+#define NANA_GUI_DETAIL_TASK_QUEUE_HPP
+
+#include <nana/traits.hpp>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace nana{	namespace gui{	namespace detail
+{
+	//class task_queue
+	//@brief: task_queue is a multiple-producer single-consumer queue. A producer pushes the tasks by a CAS on
+	//	the head of a list, and the consumer takes the whole list at once, so neither of them takes a lock.
+	//	A task that has a coalescing key is discarded if a later task with the same owner and key is taken
+	//	in the same batch, so a burst of updates collapses into the last one.
+	class task_queue
+		: nana::noncopyable
+	{
+		struct node
+		{
+			node * next;
+			const void * owner;
+			std::size_t key;	//0 means the task is not coalesced.
+			std::function<void()> task;
+		};
+	public:
+		typedef std::function<void()> task_type;
+
+		task_queue()
+			: head_(nullptr)
+		{}
+
+		~task_queue()
+		{
+			_m_delete(head_.exchange(nullptr));
+		}
+
+		//Returns true if the queue was empty, then the consumer should be woken up.
+		bool push(const void* owner, std::size_t key, const task_type& task)
+		{
+			node * n = new node;
+			n->owner = owner;
+			n->key = key;
+			n->task = task;
+			return _m_push(n, n);
+		}
+
+		//Pushes the tasks as a batch, they are taken together by the consumer.
+		bool push(const void* owner, const std::vector<task_type>& tasks)
+		{
+			node * first = nullptr;
+			node * last = nullptr;
+			for(auto & task : tasks)
+			{
+				node * n = new node;
+				n->next = first;
+				n->owner = owner;
+				n->key = 0;
+				n->task = task;
+				first = n;
+				if(nullptr == last)
+					last = n;
+			}
+			return (first ? _m_push(first, last) : false);
+		}
+
+		bool empty() const
+		{
+			return (nullptr == head_.load(std::memory_order_acquire));
+		}
+
+		//Runs the tasks which are posted, in the order they were posted. Returns the number of the tasks that are run.
+		std::size_t run()
+		{
+			node * n = head_.exchange(nullptr, std::memory_order_acquire);
+			if(nullptr == n)
+				return 0;
+
+			//The list is the reverse order of posting, the latest task of a key is met first.
+			std::vector<node*> tasks;
+			std::vector<node*> keyed;
+			for(; n; n = n->next)
+			{
+				if(n->key)
+				{
+					bool coalesced = false;
+					for(auto t : keyed)
+					{
+						if(t->key == n->key && t->owner == n->owner)
+						{
+							coalesced = true;
+							break;
+						}
+					}
+
+					if(coalesced)
+						n->task = nullptr;
+					else
+						keyed.push_back(n);
+				}
+				tasks.push_back(n);
+			}
+
+			std::size_t count = 0;
+			for(auto i = tasks.rbegin(); i != tasks.rend(); ++i)
+			{
+				node * t = *i;
+				if(t->task)
+				{
+					try
+					{
+						t->task();
+					}
+					catch(...)
+					{
+						//The rest tasks are deleted
+						for(; i != tasks.rend(); ++i)
+							delete *i;
+						throw;
+					}
+					++count;
+				}
+				delete t;
+			}
+			return count;
+		}
+	private:
+		bool _m_push(node * first, node * last)
+		{
+			node * head = head_.load(std::memory_order_relaxed);
+			do
+			{
+				last->next = head;
+			}while(false == head_.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+			return (nullptr == head);
+		}
+
+		static void _m_delete(node * n)
+		{
+			while(n)
+			{
+				node * next = n->next;
+				delete n;
+				n = next;
+			}
+		}
+	private:
+		std::atomic<node*> head_;
+	};
+
+	//class post_channel
+	//@brief: post_channel is the entry of the tasks that are posted to a GUI thread. It is shared by the thread and the
+	//	post targets, so a producer posts through it without finding the thread or taking a lock. The thread is woken
+	//	once for the tasks that are posted before it runs them, and if it can't be woken, the next post tries again.
+	//	The thread closes the channel when it exits, a task posted to a closed channel is discarded.
+	class post_channel
+		: nana::noncopyable
+	{
+	public:
+		typedef task_queue::task_type task_type;
+
+		post_channel()
+			: closed_(false), signaled_(false)
+		{}
+
+		virtual ~post_channel(){}
+
+		//Returns false if the channel is closed.
+		bool post(const void* owner, std::size_t key, const task_type& task)
+		{
+			if(closed_.load(std::memory_order_acquire))
+				return false;
+
+			tasks_.push(owner, key, task);
+			signal();
+			return true;
+		}
+
+		bool post(const void* owner, const std::vector<task_type>& tasks)
+		{
+			if(closed_.load(std::memory_order_acquire))
+				return false;
+
+			if(tasks.size())
+			{
+				tasks_.push(owner, tasks);
+				signal();
+			}
+			return true;
+		}
+
+		//Wakes up the thread unless it is signaled and has not run the tasks yet.
+		void signal()
+		{
+			if((false == signaled_.exchange(true)) && (false == wake()))
+				signaled_.store(false);
+		}
+
+		//Signals the thread again if there are tasks, it is called when the signal may be lost,
+		//e.g. the window which receives the signal is destroyed.
+		void rearm()
+		{
+			signaled_.store(false);
+			if(false == tasks_.empty())
+				signal();
+		}
+
+		//The following functions are only called by the thread of the channel.
+		bool empty() const
+		{
+			return tasks_.empty();
+		}
+
+		std::size_t run()
+		{
+			//It is cleared before the tasks are taken, so a task which is not taken signals the thread again.
+			signaled_.store(false);
+			return tasks_.run();
+		}
+
+		void close()
+		{
+			closed_.store(true, std::memory_order_release);
+		}
+	protected:
+		//Wakes up the thread, returns false if it fails.
+		virtual bool wake() = 0;
+	private:
+		task_queue tasks_;
+		std::atomic<bool> closed_;
+		std::atomic<bool> signaled_;
+	};
+}//end namespace detail
+}//end namespace gui
+}//end namespace nana
+
+#endif
@@ -18,6 +18,7 @@
 #include "native_window_interface.hpp"
 #include "basic_window.hpp"
 #include "../layout_utility.hpp"
+#include <cstring>
 
 namespace nana{	namespace gui{
 namespace detail
@@ -190,6 +191,7 @@ namespace detail
 				//Disable the effect.
 				data_sect.effects_bground_windows.erase(i);
 				wd->other.glass_buffer.release();
+				wd->other.glass_source.close();
 				return true;
 			}
 			//No such effect has registered.
@@ -206,8 +208,95 @@ namespace detail
 		//		update the glass buffer of a glass window.
 		static void make_bground(core_window_t* const wd)
 		{
-			nana::point rpos(wd->pos_root);
 			auto & glass_buffer = wd->other.glass_buffer;
+			_m_compose_bground(wd, glass_buffer, rectangle(wd->dimension));
+
+			//Keep the background before taking the effect, it is used for finding out the changes.
+			wd->other.glass_source.open(glass_buffer.handle());
+
+			if(wd->effect.bground)
+				wd->effect.bground->take_effect(reinterpret_cast<window>(wd), glass_buffer);
+		}
+
+		//update_bground
+		//@brief:	Updates the glass buffer of a glass window when the windows under the damaged area are repainted, the damaged
+		//			area is in the coordinate of the glass window. The effect is retaken only around the pixels which are
+		//			actually changed. It returns false if the background is not changed.
+		static bool update_bground(core_window_t* const wd, const nana::rectangle& damaged)
+		{
+			auto & source = wd->other.glass_source;
+			if(source.empty() || (source.size() != wd->dimension) || (nullptr == wd->effect.bground))
+			{
+				make_bground(wd);
+				return true;
+			}
+
+			nana::rectangle dr;
+			if(false == overlap(damaged, rectangle(wd->dimension), dr))
+				return false;
+
+			paint::graphics fresh(dr.width, dr.height);
+			_m_compose_bground(wd, fresh, dr);
+
+			//Find out the rows which are changed.
+			paint::pixel_buffer fresh_pixels(fresh.handle(), nana::rectangle(fresh.size()));
+			const std::size_t row_bytes = dr.width * sizeof(pixel_rgb_t);
+			int top = -1, bottom = -1;
+			for(unsigned row = 0; row < dr.height; ++row)
+			{
+				pixel_rgb_t * px_src = source.raw_ptr(dr.y + row) + dr.x;
+				const pixel_rgb_t * px_fresh = fresh_pixels.raw_ptr(row);
+				if(std::memcmp(px_src, px_fresh, row_bytes))
+				{
+					std::memcpy(px_src, px_fresh, row_bytes);
+					if(top < 0)
+						top = static_cast<int>(row);
+					bottom = static_cast<int>(row);
+				}
+			}
+
+			if(top < 0)
+				return false;
+
+			dr.y += top;
+			dr.height = static_cast<unsigned>(bottom - top + 1);
+
+			nana::rectangle area, affected;
+			effect_areas(dr, wd->dimension, wd->effect.bground->reach(), area, affected);
+
+			paint::graphics effected(area.width, area.height);
+			source.paste(area, effected.handle(), 0, 0);
+			wd->effect.bground->take_effect(reinterpret_cast<window>(wd), effected);
+
+			wd->other.glass_buffer.bitblt(affected, effected, nana::point(affected.x - area.x, affected.y - area.y));
+			return true;
+		}
+
+		//effect_areas
+		//@brief:	Computes the areas of a glass window for retaking the effect around the changed pixels. The changed pixels
+		//			affect the pixels within the reach of the effect around them, and these pixels read the pixels within the
+		//			reach around themselves. So the effect is taken for the changed area grown by twice the reach, and the
+		//			changed area grown by the reach is copied back, from the offset (affected.x - area.x, affected.y - area.y)
+		//			of the effected pixels. Both areas are clipped to the window, they are the whole window if the reach is
+		//			not less than the larger side of the window.
+		static void effect_areas(const nana::rectangle& changed, const nana::size& dimension, std::size_t reach, nana::rectangle& area, nana::rectangle& affected)
+		{
+			area = affected = nana::rectangle(dimension);
+			if(reach < (dimension.width > dimension.height ? dimension.width : dimension.height))
+			{
+				const int ext = static_cast<int>(reach);
+				overlap(rectangle(changed.x - 2 * ext, changed.y - 2 * ext, changed.width + 4 * ext, changed.height + 4 * ext), rectangle(dimension), area);
+				overlap(rectangle(changed.x - ext, changed.y - ext, changed.width + 2 * ext, changed.height + 2 * ext), rectangle(dimension), affected);
+			}
+		}
+	private:
+		//_m_compose_bground
+		//@brief:	Composes the windows under a glass window into the graphics, the area is in the coordinate of
+		//			the glass window and it is drawn at (0, 0) of the graphics.
+		static void _m_compose_bground(core_window_t* const wd, nana::paint::graphics& graph, const nana::rectangle& area)
+		{
+			const nana::point rpos(wd->pos_root.x + area.x, wd->pos_root.y + area.y);
+			const nana::rectangle graph_r(0, 0, area.width, area.height);
 
 			if(wd->parent->other.category == category::lite_widget_tag::value)
 			{
@@ -219,9 +308,9 @@ namespace detail
 					beg = beg->parent;
 				}
 
-				glass_buffer.bitblt(wd->dimension, beg->drawer.graphics, nana::point(wd->pos_root.x - beg->pos_root.x, wd->pos_root.y - beg->pos_root.y));
+				graph.bitblt(graph_r, beg->drawer.graphics, nana::point(rpos.x - beg->pos_root.x, rpos.y - beg->pos_root.y));
 
-				nana::rectangle r(wd->pos_owner, wd->dimension);
+				nana::rectangle r(0, 0, area.width, area.height);
 				for(auto i = layers.rbegin(), layers_rend = layers.rend(); i != layers_rend; ++i)
 				{
 					core_window_t * pre = *i;
@@ -229,8 +318,8 @@ namespace detail
 						continue;
 
 					core_window_t * term = ((i + 1 != layers_rend) ? *(i + 1) : wd);
-					r.x = wd->pos_root.x - pre->pos_root.x;
-					r.y = wd->pos_root.y - pre->pos_root.y;
+					r.x = rpos.x - pre->pos_root.x;
+					r.y = rpos.y - pre->pos_root.y;
 					for(auto child: pre->children)
 					{
 						if(child->index >= term->index)
@@ -240,39 +329,35 @@ namespace detail
 						if(child->visible && overlap(r, rectangle(child->pos_owner, child->dimension), ovlp))
 						{
 							if(child->other.category != category::lite_widget_tag::value)
-								glass_buffer.bitblt(nana::rectangle(ovlp.x - pre->pos_owner.x, ovlp.y - pre->pos_owner.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
+								graph.bitblt(nana::rectangle(ovlp.x - r.x, ovlp.y - r.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
 							ovlp.x += pre->pos_root.x;
 							ovlp.y += pre->pos_root.y;
-							_m_paste_children(child, false, ovlp, glass_buffer, rpos);
+							_m_paste_children(child, false, ovlp, graph, rpos);
 						}
 					}
 				}
 			}
 			else
-				glass_buffer.bitblt(wd->dimension, wd->parent->drawer.graphics, wd->pos_owner);
+				graph.bitblt(graph_r, wd->parent->drawer.graphics, nana::point(wd->pos_owner.x + area.x, wd->pos_owner.y + area.y));
 
-			rectangle r_of_wd(wd->pos_owner, wd->dimension);
+			rectangle r_of_area(wd->pos_owner.x + area.x, wd->pos_owner.y + area.y, area.width, area.height);
 			for(auto child : wd->parent->children)
 			{
 				if(child->index >= wd->index)
 					break;
 
 				nana::rectangle ovlp;
-				if(child->visible && overlap(r_of_wd, rectangle(child->pos_owner, child->dimension), ovlp))
+				if(child->visible && overlap(r_of_area, rectangle(child->pos_owner, child->dimension), ovlp))
 				{
 					if(child->other.category != category::lite_widget_tag::value)
-						glass_buffer.bitblt(nana::rectangle(ovlp.x - wd->pos_owner.x, ovlp.y - wd->pos_owner.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
+						graph.bitblt(nana::rectangle(ovlp.x - r_of_area.x, ovlp.y - r_of_area.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
 
-					ovlp.x += wd->pos_root.x;
-					ovlp.y += wd->pos_root.y;
-					_m_paste_children(child, false, ovlp, glass_buffer, rpos);
+					ovlp.x += wd->parent->pos_root.x;
+					ovlp.y += wd->parent->pos_root.y;
+					_m_paste_children(child, false, ovlp, graph, rpos);
 				}
 			}
-
-			if(wd->effect.bground)
-				wd->effect.bground->take_effect(reinterpret_cast<window>(wd), glass_buffer);
 		}
-	private:
 
 		//_m_paste_children
 		//@brief:paste children window to the root graphics directly. just paste the visual rectangle
@@ -305,9 +390,9 @@ namespace detail
 			}
 		}
 
-		static void _m_paint_glass_window(core_window_t* wd, bool is_redraw, bool is_child_refreshed, bool called_by_notify)
+		static void _m_paint_glass_window(core_window_t* wd, bool is_redraw, bool is_child_refreshed, bool called_by_notify, const nana::rectangle* damaged_r = nullptr)
 		{
-			if(wd->flags.refreshing && is_redraw)	return;
+			if(wd->flags.refreshing && (is_redraw || called_by_notify))	return;
 
 			nana::rectangle vr;
 			if(read_visual_rectangle(wd, vr))
@@ -315,30 +400,49 @@ namespace detail
 				if(is_redraw || called_by_notify)
 				{
 					if(called_by_notify)
-						make_bground(wd);
+					{
+						//Only the area under the notifier is changed.
+						nana::rectangle damaged;
+						if(nullptr == damaged_r || (false == overlap(*damaged_r, rectangle(wd->pos_root, wd->dimension), damaged)))
+							damaged = rectangle(wd->pos_root, wd->dimension);
+
+						damaged.x -= wd->pos_root.x;
+						damaged.y -= wd->pos_root.y;
+						if(false == update_bground(wd, damaged) && (false == is_redraw))
+						{
+							//The background is not changed, the glass window just covers the notifier again.
+							_m_map_glass_window(wd, vr, is_child_refreshed);
+							return;
+						}
+					}
 
 					wd->flags.refreshing = true;
 					wd->drawer.refresh();
 					wd->flags.refreshing = false;
 				}
 
-				auto & root_graph = *(wd->root_graph);
-				//Map root
-				root_graph.bitblt(vr, wd->drawer.graphics, nana::point(vr.x - wd->pos_root.x, vr.y - wd->pos_root.y));
-				_m_paste_children(wd, is_child_refreshed, vr, root_graph, nana::point());
+				_m_map_glass_window(wd, vr, is_child_refreshed);
+			}
+		}
 
-				if(wd->parent)
+		static void _m_map_glass_window(core_window_t* wd, const nana::rectangle& vr, bool is_child_refreshed)
+		{
+			auto & root_graph = *(wd->root_graph);
+			//Map root
+			root_graph.bitblt(vr, wd->drawer.graphics, nana::point(vr.x - wd->pos_root.x, vr.y - wd->pos_root.y));
+			_m_paste_children(wd, is_child_refreshed, vr, root_graph, nana::point());
+
+			if(wd->parent)
+			{
+				std::vector<wd_rectangle>	blocks;
+				read_overlaps(wd, vr, blocks);
+				for(auto & n : blocks)
 				{
-					std::vector<wd_rectangle>	blocks;
-					read_overlaps(wd, vr, blocks);
-					for(auto & n : blocks)
-					{
-						root_graph.bitblt(n.r, (n.window->drawer.graphics), nana::point(n.r.x - n.window->pos_root.x, n.r.y - n.window->pos_root.y));
-					}
+					root_graph.bitblt(n.r, (n.window->drawer.graphics), nana::point(n.r.x - n.window->pos_root.x, n.r.y - n.window->pos_root.y));
 				}
-
-				_m_notify_glasses(wd, vr);
 			}
+
+			_m_notify_glasses(wd, vr);
 		}
 
 		//_m_notify_glasses
@@ -360,11 +464,11 @@ namespace detail
 				if(sigwd->parent == wd->parent)
 				{
 					if(sigwd->index < wd->index)
-						_m_paint_glass_window(wd, true, false, true);
+						_m_paint_glass_window(wd, false, false, true, &r_visual);
 				}
 				else if(sigwd == wd->parent)
 				{
-					_m_paint_glass_window(wd, true, false, true);
+					_m_paint_glass_window(wd, false, false, true, &r_visual);
 				}
 				else
 				{
@@ -374,7 +478,7 @@ namespace detail
 						signode = signode->parent;
 
 					if(signode->parent && (signode->index < wd->index))
-						_m_paint_glass_window(wd, true, false, true);
+						_m_paint_glass_window(wd, false, false, true, &r_visual);
 				}
 			}
 		}
@@ -308,7 +308,9 @@ namespace detail
 
 		//show
 		//@brief: show or hide a window
-		bool show(core_window_t* wd, bool visible);
+		//@param: deferred, if it is true, the function would not refresh the parent of a widget, the caller
+		//			is responsible for refreshing it, e.g, a layout transaction refreshes the parent only once.
+		bool show(core_window_t* wd, bool visible, bool deferred = false);
 
 		core_window_t* find_window(native_window_type root, int x, int y);
 
@@ -327,6 +329,9 @@ namespace detail
 		bool belong_to_lazy(core_window_t *) const;
 
 		bool update(core_window_t*, bool redraw, bool force);
+
+		//Displays the windows without refreshing them, a root window is copied to the screen once for all its windows.
+		void update(const std::vector<core_window_t*>&);
 		void refresh_tree(core_window_t*);
 
 		bool do_lazy_refresh(core_window_t*, bool force_copy_to_screen);
@@ -29,6 +29,10 @@ namespace nana{	namespace gui{
 
 			virtual ~bground_interface() = 0;
 			virtual void take_effect(window, graph_reference) const = 0;
+
+			///	Returns how many pixels around a pixel are read by the effect. The background of a glass window is
+			///	recomputed only around the changed area if it is known, the default is unknown.
+			virtual std::size_t reach() const;
 		};
 
 		class bground_factory_interface
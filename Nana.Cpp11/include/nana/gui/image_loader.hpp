@@ -0,0 +1,97 @@
+/*
+ *	An Asynchronous Image Loader Implementation
+ *	Copyright(C) 2003-2013 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/gui/image_loader.hpp
+ *	@description:
+ *		The image_loader decodes image files in the worker threads of a thread pool, so that opening
+ *		many images does not block the GUI thread. A load returns a ticket which draws a placeholder
+ *		until the image is ready, the completion handler is posted to the GUI thread of the owner window.
+ */
+
+#ifndef NANA_GUI_IMAGE_LOADER_HPP
+#define NANA_GUI_IMAGE_LOADER_HPP
+
+#include <nana/gui/basis.hpp>
+#include <nana/paint/image.hpp>
+#include <nana/paint/graphics.hpp>
+#include <functional>
+#include <memory>
+
+namespace nana{	namespace gui
+{
+	class image_loader
+		: nana::noncopyable
+	{
+		struct request;
+		struct implement;
+	public:
+		///	The handler is invoked in the GUI thread when a load is finished, the image is empty if the file fails to open.
+		typedef std::function<void(const paint::image&)> complete_handler;
+
+		///	The loads with higher priority are decoded first, e.g. the images which are visible.
+		enum class priority
+		{
+			background, normal, visible
+		};
+
+		enum class state
+		{
+			pending, decoding, ready, failed, canceled
+		};
+
+		class ticket
+		{
+			friend class image_loader;
+		public:
+			ticket();
+
+			bool empty() const;
+			state status() const;
+
+			///	Returns the loaded image, it is empty until the ticket is ready.
+			paint::image image() const;
+
+			///	Changes the priority of a pending load.
+			void priority(image_loader::priority);
+
+			///	Cancels the load, the completion handler will not be invoked.
+			void cancel();
+
+			///	Draws the image into the rectangle, or draws the placeholder of the loader if the image is not ready.
+			void draw(paint::graphics&, const nana::rectangle&) const;
+		private:
+			std::shared_ptr<request> request_;
+		};
+
+		///	Creates a loader, the completion handlers are run in the GUI thread of the owner window. The completions
+		///	which are not delivered when the owner is destroyed are discarded.
+		explicit image_loader(window owner);
+		image_loader(window owner, std::size_t threads);
+
+		///	Cancels the pending loads and waits for the loads which are being decoded.
+		~image_loader();
+
+		ticket load(const nana::string& file, priority = priority::normal);
+		ticket load(const nana::string& file, priority, const complete_handler&);
+
+		///	Sets the placeholder which is drawn while an image is not ready.
+		void placeholder(const paint::image&);
+		void placeholder(color_t);
+
+		///	Cancels all the loads which are not finished.
+		void cancel_all();
+
+		///	Returns the number of the loads which are not finished.
+		std::size_t outstanding() const;
+	private:
+		std::shared_ptr<implement> impl_;
+	};
+}//end namespace gui
+}//end namespace nana
+
+#endif
@@ -37,8 +37,8 @@ namespace gui
 		void fasten(window);
 	private:
 		void _m_resize();
-		void _m_adjust_children();
-		void _m_adjust_elements();
+		void _m_adjust_children(API::layout_transaction&);
+		void _m_adjust_elements(API::layout_transaction&);
 	private:
 		struct ref_owner_tag
 		{
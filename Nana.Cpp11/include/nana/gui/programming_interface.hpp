@@ -76,6 +76,35 @@ namespace API
 
 	void exit();
 
+	//class post_target
+	//@brief: A post_target refers to the GUI thread of a window. The window is looked up when the target is made,
+	//	then the tasks are posted through the target from any thread without a lock. A task is discarded if the
+	//	window is destroyed before the task is run, even if another window is created at the same address.
+	class post_target
+	{
+	public:
+		post_target();
+		post_target(window);
+
+		bool empty() const;
+
+		//Returns false if the target is empty or the thread of the window has exited.
+		bool post(const std::function<void()>&, std::size_t coalescing_key = 0) const;
+		bool post(const std::vector<std::function<void()> >&) const;
+	private:
+		std::shared_ptr<gui::detail::post_channel> channel_;
+		gui::detail::bedrock::core_window_t* window_;
+		std::size_t uid_;
+	};
+
+	//post
+	//@brief: Posts a task from any thread to the GUI thread which the window belongs to. It returns immediately,
+	//	the task is run in the event loop of that thread, and it is discarded if the window is destroyed before.
+	//	The tasks of the window with the same nonzero coalescing_key, which are not run yet, collapse into the last one.
+	//	It looks up the window under the lock of the window manager, a post_target avoids the lookup for every task.
+	bool post(window, const std::function<void()>&, std::size_t coalescing_key = 0);
+	bool post(window, const std::vector<std::function<void()> >&);
+
 	nana::string transform_shortkey_text(nana::string text, nana::string::value_type &shortkey, nana::string::size_type *skpos);
 	bool register_shortkey(window, unsigned long);
 	void unregister_shortkey(window);
@@ -151,6 +180,37 @@ namespace API
 		move_window(wd, r.x, r.y, r.width, r.height);
 	}
 
+	/**	@brief	A layout transaction collects the geometry and visibility changes of windows and applies them all at once.
+	 *	The changes are applied under one lock of the window manager when the transaction is committed, and every
+	 *	affected parent window is refreshed only once rather than once per changed window.
+	 */
+	class layout_transaction
+		: nana::noncopyable
+	{
+		struct action
+		{
+			window handle;
+			bool is_show;
+			bool visible;
+			rectangle r;
+		};
+	public:
+		layout_transaction();
+
+		///	Commits the changes which are not committed yet.
+		~layout_transaction();
+
+		void move(window, const rectangle&);
+		void move(window, int x, int y, unsigned width, unsigned height);
+		void show(window, bool visible);
+
+		///	Applies the collected changes and refreshes the affected parent windows.
+		void commit();
+		bool empty() const;
+	private:
+		std::vector<action> actions_;
+	};
+
 	bool set_window_z_order(window wd, window wd_after, z_order_action action_if_no_wd_after);
 
 	nana::size window_size(window);
@@ -171,6 +231,10 @@ namespace API
 	void refresh_window_tree(window);
 	void update_window(window);
 
+	/**	@brief	Displays the windows immediately without refreshing, the windows which share a root window are copied to the screen at once.
+	 */
+	void update_windows(const std::vector<window>&);
+
 	void window_caption(window, const nana::string& title);
 	nana::string window_caption(window);
 
@@ -0,0 +1,139 @@
+/*
+ *	A Scroll-Aware Backing Store
+ *	Copyright(C) 2003-2013 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/gui/widgets/detail/scroll_store.hpp
+ */
+
+#ifndef NANA_GUI_WIDGETS_DETAIL_SCROLL_STORE_HPP
+#define NANA_GUI_WIDGETS_DETAIL_SCROLL_STORE_HPP
+
+#include <nana/paint/graphics.hpp>
+
+namespace nana{	namespace gui { namespace widgets{ namespace detail
+{
+	/// A backing store for a drawer_trigger whose view scrolls vertically over a tall content.
+	///
+	///	The store keeps what the trigger painted in a band three views tall, it covers the view and one view
+	///	above and below it. When the view scrolls, the rows which are in the band are copied back, and the
+	///	trigger only paints the rows exposed for the first time, so the rows scrolled out and back by small
+	///	scrolls are not painted again. The band is moved by a copy within itself when the view leaves it.
+	///	The band keeps the pixels the trigger painted, not the pixels drawn over them by effects or drawing
+	///	objects, because the view is copied into the band before the drawer draws them.
+	class scroll_store
+	{
+	public:
+		scroll_store()
+			: valid_(false), band_origin_(0), valid_begin_(0), valid_end_(0)
+		{}
+
+		/// Forgets the content, e.g. the content is changed. The trigger must paint the whole view.
+		void invalidate()
+		{
+			valid_ = false;
+		}
+
+		/// Records the view after the trigger paints the whole view.
+		///@param origin	The content coordinate of the top of the view.
+		void painted(const paint::graphics& graph, const nana::rectangle& view, long long origin)
+		{
+			valid_ = false;
+			if(0 == view.width || 0 == view.height)
+				return;
+
+			if(band_.width() != view.width || band_.height() != view.height * 3)
+				band_.make(view.width, view.height * 3);
+
+			if(band_.empty())
+				return;
+
+			view_ = view;
+			band_origin_ = origin - view.height;
+			valid_begin_ = origin;
+			valid_end_ = origin + view.height;
+			band_.bitblt(nana::rectangle(0, view.height, view.width, view.height), graph, nana::point(view.x, view.y));
+			valid_ = true;
+		}
+
+		/// Scrolls the view to the origin. The rows kept in the band are copied to the graphics, and the painter is
+		/// invoked with each rectangle of the graphics which must be painted, as painter(const nana::rectangle&).
+		///@return	false if the store does not match the view, the trigger must paint the whole view and call painted().
+		template<typename Painter>
+		bool scroll(paint::graphics& graph, const nana::rectangle& view, long long origin, Painter painter)
+		{
+			if((false == valid_) || (view != view_))
+				return false;
+
+			const long long height = view.height;
+			if(origin < band_origin_ || origin + height > band_origin_ + height * 3)
+				_m_move_band(origin - height);
+
+			//Copies the rows which are kept in the band.
+			const long long keep_begin = (valid_begin_ > origin ? valid_begin_ : origin);
+			const long long keep_end = (valid_end_ < origin + height ? valid_end_ : origin + height);
+			if(keep_begin < keep_end)
+			{
+				graph.bitblt(nana::rectangle(view.x, view.y + static_cast<int>(keep_begin - origin), view.width, static_cast<unsigned>(keep_end - keep_begin)),
+							band_, nana::point(0, static_cast<int>(keep_begin - band_origin_)));
+
+				if(origin < keep_begin)
+					painter(nana::rectangle(view.x, view.y, view.width, static_cast<unsigned>(keep_begin - origin)));
+				if(keep_end < origin + height)
+					painter(nana::rectangle(view.x, view.y + static_cast<int>(keep_end - origin), view.width, static_cast<unsigned>(origin + height - keep_end)));
+			}
+			else
+				painter(view);
+
+			//Keeps the painted rows, the valid range remains contiguous.
+			band_.bitblt(nana::rectangle(0, static_cast<int>(origin - band_origin_), view.width, view.height), graph, nana::point(view.x, view.y));
+			if(keep_begin < keep_end)
+			{
+				if(origin < valid_begin_)
+					valid_begin_ = origin;
+				if(origin + height > valid_end_)
+					valid_end_ = origin + height;
+			}
+			else
+			{
+				valid_begin_ = origin;
+				valid_end_ = origin + height;
+			}
+			return true;
+		}
+	private:
+		//Moves the band to a new origin, the rows in both the old band and the new band are kept.
+		void _m_move_band(long long band_origin)
+		{
+			const long long height = view_.height * 3;
+			const long long begin = (valid_begin_ > band_origin ? valid_begin_ : band_origin);
+			const long long end = (valid_end_ < band_origin + height ? valid_end_ : band_origin + height);
+			if(begin < end)
+			{
+				band_.bitblt(nana::rectangle(0, static_cast<int>(begin - band_origin), view_.width, static_cast<unsigned>(end - begin)),
+							band_, nana::point(0, static_cast<int>(begin - band_origin_)));
+				valid_begin_ = begin;
+				valid_end_ = end;
+			}
+			else
+				valid_begin_ = valid_end_ = band_origin;
+
+			band_origin_ = band_origin;
+		}
+	private:
+		bool valid_;
+		nana::rectangle view_;
+
+		paint::graphics band_;
+		long long band_origin_;		//The content coordinate of the top of the band.
+		long long valid_begin_;		//The range of content which is kept in the band.
+		long long valid_end_;
+	};
+}//end namespace detail
+}//end namespace widgets
+}//end namespace gui
+}//end namespace nana
+#endif
@@ -15,6 +15,7 @@
 #include "widget.hpp"
 #include <nana/pat/cloneable.hpp>
 #include <nana/concepts.hpp>
+#include <type_traits>
 
 namespace nana{ namespace gui{
 	class listbox;
@@ -24,6 +25,123 @@ namespace nana{ namespace gui{
 		{
 			typedef std::size_t size_type;
 
+			/// The sort key of a cell, it is an integer, a floating-point number or a text. The numbers come before the texts,
+			/// two numbers are compared by their values, an integer and a floating-point number are compared exactly,
+			/// and two texts are compared by characters.
+			class sort_key
+			{
+			public:
+				struct kinds
+				{
+					enum t{integer, real, text};
+				};
+
+				sort_key()
+					: kind_(kinds::integer), integer_(0), real_(0)
+				{}
+
+				template<typename Integer>
+				sort_key(Integer n, typename std::enable_if<std::is_integral<Integer>::value>::type* = nullptr)
+					: kind_(kinds::integer), integer_(static_cast<long long>(n)), real_(0)
+				{}
+
+				sort_key(double n)
+					: kind_(kinds::real), integer_(0), real_(n)
+				{}
+
+				sort_key(nana::string s)
+					: kind_(kinds::text), integer_(0), real_(0), text_(std::move(s))
+				{}
+
+				kinds::t kind() const
+				{
+					return kind_;
+				}
+
+				long long integer() const
+				{
+					return integer_;
+				}
+
+				double real() const
+				{
+					return real_;
+				}
+
+				const nana::string& text() const
+				{
+					return text_;
+				}
+
+				/// Returns a negative number, zero or a positive number if the key is less than, equal to or greater than the other.
+				int compare(const sort_key& other) const
+				{
+					if(kinds::text == kind_ || kinds::text == other.kind_)
+					{
+						if(kind_ != other.kind_)
+							return (kinds::text == kind_ ? 1 : -1);
+						return text_.compare(other.text_);
+					}
+
+					if(kind_ == other.kind_)
+					{
+						if(kinds::integer == kind_)
+							return (integer_ < other.integer_ ? -1 : (other.integer_ < integer_ ? 1 : 0));
+						return _m_compare(real_, other.real_);
+					}
+					return (kinds::integer == kind_ ? _m_compare(integer_, other.real_) : -_m_compare(other.integer_, real_));
+				}
+
+				bool operator<(const sort_key& other) const
+				{
+					return (compare(other) < 0);
+				}
+			private:
+				//A NaN is greater than any number.
+				static int _m_compare(double a, double b)
+				{
+					if(a != a || b != b)
+						return (a != a ? (b != b ? 0 : 1) : -1);
+					return (a < b ? -1 : (b < a ? 1 : 0));
+				}
+
+				//Compares an integer and a floating-point number without converting the integer to double,
+				//which loses the precision of the integers beyond 2^53.
+				static int _m_compare(long long n, double r)
+				{
+					if(r != r)
+						return -1;
+					if(r >= 9223372036854775808.0)
+						return -1;
+					if(r < -9223372036854775808.0)
+						return 1;
+
+					const long long t = static_cast<long long>(r);	//Truncated toward zero, it is exact in the range.
+					if(n != t)
+						return (n < t ? -1 : 1);
+
+					const double frac = r - static_cast<double>(t);
+					return (frac > 0 ? -1 : (frac < 0 ? 1 : 0));
+				}
+			private:
+				kinds::t kind_;
+				long long integer_;
+				double real_;
+				nana::string text_;
+			};
+
+			/// The builtin kinds of the sort keys of a column.
+			struct sort_kinds
+			{
+				enum t{
+					text,		///< Compares the texts by characters, it is the default.
+					collation,	///< Compares the texts by the collation of the global locale.
+					integer,	///< Compares the leading integers of the texts.
+					real,		///< Compares the leading floating-point numbers of the texts.
+					datetime	///< Compares the texts in the form of "yyyy-mm-dd hh:mm:ss", any non-digit separates the fields.
+				};
+			};
+
 			//struct essence_t
 			//@brief:	this struct gives many data for listbox,
 			//			the state of the struct does not effect on member funcions, therefore all data members are public.
@@ -42,6 +160,7 @@ namespace nana{ namespace gui{
 				essence_t& essence() const;
 				void draw();
 			private:
+				void _m_draw_scrolled();
 				void _m_draw_border();
 			private:
 				void bind_window(widget_reference);
@@ -239,18 +358,37 @@ namespace nana{ namespace gui{
 					auto proxy = _m_resolver().template get<resolver_proxy<T> >();
 					if(proxy)
 					{
-						auto & res = proxy->res;
 						std::size_t pos = size();
-						push_back(res->decode(0, t));
-						item_proxy ip(ess_, pos_, pos);
-						const std::size_t headers = columns();
-						for(std::size_t i = 1; i < headers; ++i)
-							ip.text(i, res->decode(i, t));
-						return ip;
+						std::vector<std::vector<nana::string> > rows(1);
+						_m_decode(*proxy->res, t, rows.back());
+						append_bulk(std::move(rows));
+						return item_proxy(ess_, pos_, pos);
 					}
 					return item_proxy();
 				}
 
+				/// Appends the objects of a range at end of the category through the resolver.
+				template<typename InputIterator>
+				void append_bulk(InputIterator first, InputIterator last)
+				{
+					typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+					auto proxy = _m_resolver().template get<resolver_proxy<value_type> >();
+					if(nullptr == proxy)
+						throw std::invalid_argument("Nana.Listbox.CatProxy: the type passed to append_bulk() does not match the resolver.");
+
+					std::vector<std::vector<nana::string> > rows;
+					for(; first != last; ++first)
+					{
+						rows.emplace_back();
+						_m_decode(*proxy->res, *first, rows.back());
+					}
+					append_bulk(std::move(rows));
+				}
+
+				/// Appends the rows at end of the category, a row is the texts of an item. The category is sorted
+				/// once and the listbox is refreshed once for all the rows. The rows are moved into the listbox.
+				void append_bulk(std::vector<std::vector<nana::string> >&& rows);
+
 				std::size_t columns() const;
 
 				/// Behavior of a container
@@ -265,6 +403,11 @@ namespace nana{ namespace gui{
 
 				std::size_t size() const;
 
+				/// Returns the position of the item which is displayed at the display position, the items are displayed
+				/// in the order of the sort and only the items which pass the filter are displayed. It returns nana::npos
+				/// if the display position is not less than the number of the displayed items.
+				std::size_t displayed(std::size_t display_pos) const;
+
 				/// Behavior of Iterator
 				cat_proxy& operator=(const cat_proxy&);
 
@@ -292,6 +435,15 @@ namespace nana{ namespace gui{
 				/// Behavior of Iterator
 				bool operator!=(const cat_proxy&) const;
 			private:
+				template<typename T>
+				void _m_decode(const resolver_interface<T>& res, const T& t, std::vector<nana::string>& row) const
+				{
+					const std::size_t headers = columns();
+					row.reserve(headers);
+					for(std::size_t i = 0; i < headers; ++i)
+						row.emplace_back(res.decode(i, t));
+				}
+
 				const nana::any & _m_resolver() const;
 			private:
 				essence_t * ess_;
@@ -317,6 +469,8 @@ namespace nana{ namespace gui{
 		typedef drawerbase::listbox::cat_proxy	cat_proxy;
 		typedef drawerbase::listbox::item_proxy item_proxy;
 		typedef std::vector<index_pair_t> selection;
+		typedef drawerbase::listbox::sort_key sort_key;
+		typedef drawerbase::listbox::sort_kinds sort_kinds;
 
 		/// An interface that performances a translation between the object of T and an item of listbox.
 		template<typename T>
@@ -358,8 +512,40 @@ namespace nana{ namespace gui{
 			_m_resolver(nana::any(proxy));
 		}
 
+		/// Sorts the items by a column, the items appended later are put in the order. nana::npos stops sorting.
+		void sort_col(size_type sub, bool reverse = false);
+		size_type sort_col() const;	///< Returns the column which the items are sorted by, nana::npos if they are not sorted.
+
 		void set_sort_compare(size_type sub, std::function<bool(const nana::string&, nana::any*, const nana::string&, nana::any*, bool reverse)> strick_ordering);
 
+		/// Sets the kind of the sort keys of a column. The keys are extracted from the texts by the first sort by the column
+		/// and kept for the later sorts, a comparer set by set_sort_compare takes precedence over the keys.
+		void set_sort_key(size_type sub, sort_kinds::t);
+
+		/// Sets a custom key extractor of a column. The key of an item is extracted when it is appended or inserted and again
+		/// when its text of the column is changed, a change of its any object does not change the key until set_sort_key is called again.
+		void set_sort_key(size_type sub, std::function<sort_key(const nana::string&, nana::any*)> key_extractor);
+
+		/// Shows only the items which the predicate accepts, the other items are hidden and keep their states.
+		/// The filter is applied to the items appended later and the items whose texts are changed.
+		/// The predicate is invoked by multiple threads at the same time for a large category, it must be thread-safe.
+		void filter(std::function<bool(item_proxy)> pred);
+
+		/// Shows only the items which contain the text in the columns, all the columns are searched if columns is empty.
+		void filter(const nana::string& text, const std::vector<size_type>& columns = std::vector<size_type>(), bool case_sensitive = false);
+
+		/// Shows only the items which have a text in the columns that matches the regular expression.
+		///@exception std::regex_error if the pattern is invalid.
+		void filter_regex(const nana::string& pattern, const std::vector<size_type>& columns = std::vector<size_type>());
+
+		/// Shows all the items.
+		void clear_filter();
+		bool filtered() const;
+
+		/// Enables an index of the trigrams of the texts for the text filter. The filter only tests the items
+		/// that contain every trigram of the text, it keeps filtering a large listbox interactive while typing.
+		void filter_index(bool enable);
+
 		selection selected() const;
 
 		void show_header(bool);
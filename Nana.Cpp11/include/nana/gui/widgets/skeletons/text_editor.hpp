@@ -169,6 +169,7 @@ namespace nana{	namespace gui{	namespace widgets
 			nana::char_t mask_char_;
 
 			mutable ext_renderer_tag ext_renderer_;
+			mutable unicode_bidi bidi_;	//It keeps the buffers between the resolutions of lines.
 
 			struct attributes
 			{
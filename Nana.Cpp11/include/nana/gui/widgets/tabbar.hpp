@@ -234,7 +234,7 @@ namespace nana{ namespace gui{
 				API::refresh_window(this->handle());
 		}
 
-		pat::cloneable<item_renderer>& ext_renderer() const
+		const pat::cloneable<item_renderer>& ext_renderer() const
 		{
 			return get_drawer_trigger().ext_renderer();
 		}
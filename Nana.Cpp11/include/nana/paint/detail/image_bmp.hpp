@@ -2,6 +2,7 @@
 #define NANA_PAINT_DETAIL_IMAGE_BMP_HPP
 
 #include "image_impl_interface.hpp"
+#include "image_presentation.hpp"
 #include <memory>
 
 namespace nana{	namespace paint
@@ -100,6 +101,8 @@ namespace nana{	namespace paint
 							else
 								bytes_per_line = info->bmiHeader.biSizeImage / height_pixels;
 
+							presentation_.release();
+							variants_.release();
 							pixbuf_.open(info->bmiHeader.biWidth, height_pixels);
 
 							pixel_rgb_t * d = pixbuf_.raw_ptr(0);
@@ -330,6 +333,8 @@ namespace nana{	namespace paint
 
 			void close()
 			{
+				presentation_.release();
+				variants_.release();
 				pixbuf_.close();
 			}
 
@@ -341,16 +346,21 @@ namespace nana{	namespace paint
 			void paste(const nana::rectangle& src_r, graph_reference graph, int x, int y) const
 			{
 				if(graph && pixbuf_)
-					pixbuf_.paste(src_r, graph.handle(), x, y);
+				{
+					if(false == presentation_.paste(pixbuf_, src_r, graph.handle(), x, y))
+						pixbuf_.paste(src_r, graph.handle(), x, y);
+				}
 			}
 
 			void stretch(const nana::rectangle& src_r, graph_reference graph, const nana::rectangle& r) const
 			{
 				if(graph && pixbuf_)
-					pixbuf_.stretch(src_r, graph.handle(), r);
+					variants_.stretch(pixbuf_, src_r, graph.handle(), r);
 			}
 		private:
 			nana::paint::pixel_buffer pixbuf_;
+			mutable image_presentation presentation_;
+			mutable scaled_variants variants_;
 		};//end class bmpfile
 	}//end namespace detail
 }//end namespace paint
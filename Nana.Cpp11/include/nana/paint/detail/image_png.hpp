@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include "../pixel_buffer.hpp"
+#include "image_presentation.hpp"
 
 namespace nana
 {
@@ -20,11 +21,34 @@ namespace nana
 		class image_png
 			: public image::image_impl_interface
 		{
+			//The progress is reported every progress_rows rows.
+			static const unsigned progress_rows = 64;
+
+			struct read_struct
+			{
+				png_structp png_ptr;
+				png_infop info_ptr;
+
+				read_struct()
+					: png_ptr(nullptr), info_ptr(nullptr)
+				{}
+
+				~read_struct()
+				{
+					if(png_ptr)
+						::png_destroy_read_struct(&png_ptr, (info_ptr ? &info_ptr : nullptr), nullptr);
+				}
+			};
 		public:
 			image_png()
 			{
 			}
 
+			void progress(const image::progress_handler& handler)
+			{
+				progress_ = handler;
+			}
+
 			bool open(const nana::char_t* png_file)
 			{
 #ifdef NANA_UNICODE
@@ -42,101 +66,104 @@ namespace nana
 				//Test whether the file is a png.
 				if(0 == png_sig_cmp(png_sig, 0, 8))
 				{
-					png_structp png_ptr = ::png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-					if(png_ptr)
+					read_struct rs;
+					rs.png_ptr = ::png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+					if(rs.png_ptr)
 					{
-						png_infop info_ptr = ::png_create_info_struct(png_ptr);
+						rs.info_ptr = ::png_create_info_struct(rs.png_ptr);
 
-						if(info_ptr)
+						if(rs.info_ptr)
 						{
-							if(!setjmp(png_jmpbuf(png_ptr)))
+							if(!setjmp(png_jmpbuf(rs.png_ptr)))
 							{
 								//The following codes may longjmp while init_io error.
-								::png_init_io(png_ptr, fp);
-								::png_set_sig_bytes(png_ptr, 8);
-								::png_read_info(png_ptr, info_ptr);
-
-								const int png_width = ::png_get_image_width(png_ptr, info_ptr);
-								const int png_height = ::png_get_image_height(png_ptr, info_ptr);
-								png_byte color_type = ::png_get_color_type(png_ptr, info_ptr);
-								
-								//unused
-								//png_byte depth = ::png_get_bit_depth(png_ptr, info_ptr);
-
-								int number_of_passes = ::png_set_interlace_handling(png_ptr);
-								::png_read_update_info(png_ptr, info_ptr);
-
-								//The following codes may longjmp while image_read error.
-								png_bytep * row_ptrs = new png_bytep[png_height];
-								const std::size_t png_rowbytes = ::png_get_rowbytes(png_ptr, info_ptr);
-
-								pixbuf_.open(png_width, png_height);
-
-								const bool is_alpha_enabled = ((PNG_COLOR_MASK_ALPHA & color_type) != 0);
-								pixbuf_.alpha_channel(is_alpha_enabled);
-
-								if(is_alpha_enabled && (png_rowbytes == png_width * sizeof(pixel_rgb_t)))
+								::png_init_io(rs.png_ptr, fp);
+								::png_set_sig_bytes(rs.png_ptr, 8);
+								::png_read_info(rs.png_ptr, rs.info_ptr);
+
+								const png_uint_32 png_width = ::png_get_image_width(rs.png_ptr, rs.info_ptr);
+								const png_uint_32 png_height = ::png_get_image_height(rs.png_ptr, rs.info_ptr);
+								const png_byte color_type = ::png_get_color_type(rs.png_ptr, rs.info_ptr);
+								const png_byte depth = ::png_get_bit_depth(rs.png_ptr, rs.info_ptr);
+
+								//Let libpng transform every format into 8bit BGRA, then the rows can be decoded into
+								//the pixel buffer directly.
+								bool is_alpha_enabled = ((PNG_COLOR_MASK_ALPHA & color_type) != 0);
+								if(PNG_COLOR_TYPE_PALETTE == color_type)
+									::png_set_palette_to_rgb(rs.png_ptr);
+								else if((PNG_COLOR_TYPE_GRAY == color_type) && (depth < 8))
+									::png_set_expand_gray_1_2_4_to_8(rs.png_ptr);
+
+								if(::png_get_valid(rs.png_ptr, rs.info_ptr, PNG_INFO_tRNS))
 								{
-									for(int i = 0; i < png_height; ++i)
-										row_ptrs[i] = reinterpret_cast<png_bytep>(pixbuf_.raw_ptr(i));
-
-									::png_read_image(png_ptr, row_ptrs);
-									::png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+									::png_set_tRNS_to_alpha(rs.png_ptr);
+									is_alpha_enabled = true;
 								}
-								else
-								{
-									png_byte * png_pixbuf = new png_byte[png_height * png_rowbytes];
-
-									for(int i = 0; i < png_height; ++i)
-										row_ptrs[i] = reinterpret_cast<png_bytep>(png_pixbuf + png_rowbytes * i);
 
-									::png_read_image(png_ptr, row_ptrs);
-									::png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+								if(16 == depth)
+									::png_set_strip_16(rs.png_ptr);
 
-									std::size_t png_pixel_bytes = png_rowbytes / png_width;
+								if((PNG_COLOR_TYPE_GRAY == color_type) || (PNG_COLOR_TYPE_GRAY_ALPHA == color_type))
+									::png_set_gray_to_rgb(rs.png_ptr);
 
-									pixel_rgb_t * rgb_row_ptr = pixbuf_.raw_ptr(0);
-									for(int y = 0; y < png_height; ++y)
-									{
-										png_bytep png_ptr = row_ptrs[y];
+								::png_set_bgr(rs.png_ptr);
+								if(false == is_alpha_enabled)
+									::png_set_filler(rs.png_ptr, 0xFF, PNG_FILLER_AFTER);
 
-										pixel_rgb_t * rgb_end = rgb_row_ptr + png_width;
+								const int number_of_passes = ::png_set_interlace_handling(rs.png_ptr);
+								::png_read_update_info(rs.png_ptr, rs.info_ptr);
 
-										if(is_alpha_enabled)
+								if(::png_get_rowbytes(rs.png_ptr, rs.info_ptr) == png_width * sizeof(pixel_rgb_t))
+								{
+									presentation_.release();
+									variants_.release();
+									pixbuf_.open(png_width, png_height);
+									pixbuf_.alpha_channel(is_alpha_enabled);
+
+									image::decode_progress dp;
+									dp.dimension.width = png_width;
+									dp.dimension.height = png_height;
+									dp.passes = number_of_passes;
+
+									//The following codes may longjmp while image_read error.
+									//An interlaced image is read pass by pass, every pass refines the rows which are
+									//decoded by the previous passes.
+									for(int pass = 0; pass < number_of_passes; ++pass)
+									{
+										dp.pass = pass;
+										for(png_uint_32 row = 0; row < png_height; ++row)
 										{
-											for(pixel_rgb_t * i = rgb_row_ptr; i < rgb_end; ++i)
+											::png_read_row(rs.png_ptr, reinterpret_cast<png_bytep>(pixbuf_.raw_ptr(row)), nullptr);
+
+											if(progress_ && ((row + 1) % progress_rows == 0) && (row + 1 < png_height))
 											{
-												i->u.element.red = png_ptr[0];
-												i->u.element.green = png_ptr[1];
-												i->u.element.blue = png_ptr[2];
-												i->u.element.alpha_channel = png_ptr[3];
-												png_ptr += png_pixel_bytes;
+												dp.rows = row + 1;
+												_m_report(dp);
 											}
 										}
-										else
+
+										if(progress_)
 										{
-											for(pixel_rgb_t * i = rgb_row_ptr; i < rgb_end; ++i)
-											{
-												i->u.element.red = png_ptr[0];
-												i->u.element.green = png_ptr[1];
-												i->u.element.blue = png_ptr[2];
-												i->u.element.alpha_channel = 255;
-												png_ptr += png_pixel_bytes;
-											}
+											dp.rows = png_height;
+											_m_report(dp);
 										}
-										rgb_row_ptr = rgb_end;
 									}
 
-									delete [] png_pixbuf;
+									::png_read_end(rs.png_ptr, nullptr);
+									is_opened = true;
 								}
-								delete [] row_ptrs;
-								is_opened = true;
 							}
+							else
+								pixbuf_.close();	//The image is broken.
 						}
 					}
 				}
 
 				::fclose(fp);
+
+				//Discard the copies made while decoding.
+				presentation_.release();
+				variants_.release();
 				return is_opened;
 			}
 
@@ -152,6 +179,8 @@ namespace nana
 
 			virtual void close()
 			{
+				presentation_.release();
+				variants_.release();
 				pixbuf_.close();
 			}
 
@@ -162,16 +191,27 @@ namespace nana
 
 			void paste(const nana::rectangle& src_r, graph_reference graph, int x, int y) const
 			{
-				pixbuf_.paste(src_r, graph.handle(), x, y);
+				if(false == presentation_.paste(pixbuf_, src_r, graph.handle(), x, y))
+					pixbuf_.paste(src_r, graph.handle(), x, y);
 			}
 
 			void stretch(const nana::rectangle& src_r, graph_reference dst, const nana::rectangle& r) const
 			{
-				pixbuf_.stretch(src_r, dst.handle(), r);
+				variants_.stretch(pixbuf_, src_r, dst.handle(), r);
+			}
+		private:
+			void _m_report(const image::decode_progress& dp)
+			{
+				//The partially decoded pixels may be pasted by the handler, the copies of them must be refreshed later.
+				presentation_.release();
+				variants_.release();
+				progress_(dp);
 			}
 		private:
 			nana::paint::pixel_buffer pixbuf_;
-
+			mutable image_presentation presentation_;
+			mutable scaled_variants variants_;
+			image::progress_handler progress_;
 		};
 	}//end namespace detail
 	}//end namespace paint
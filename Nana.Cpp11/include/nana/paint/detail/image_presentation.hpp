@@ -0,0 +1,58 @@
+#ifndef NANA_PAINT_DETAIL_IMAGE_PRESENTATION_HPP
+#define NANA_PAINT_DETAIL_IMAGE_PRESENTATION_HPP
+
+#include "image_impl_interface.hpp"
+#include "../pixel_buffer.hpp"
+
+namespace nana{	namespace paint
+{
+	namespace detail
+	{
+		//class image_presentation
+		//	An image_presentation keeps a copy of decoded pixels on the display server, so that pasting the image
+		//	again does not transfer the pixels again. On X11, an opaque image is kept in a Pixmap and pasted by
+		//	XCopyArea, an image with alpha channel is kept in an XRender Picture and pasted by XRenderComposite.
+		//	The server-side copy is owned by the image implementation and it is released when the image is closed.
+		class image_presentation
+			: nana::noncopyable
+		{
+			struct server_image;
+		public:
+			image_presentation();
+			~image_presentation();
+
+			//Pastes the pixels through the server-side copy, uploads the pixels at the first time.
+			//Returns false if the paste is not supported, the caller should paste the pixel_buffer directly.
+			bool paste(const pixel_buffer&, const nana::rectangle& src_r, drawable_type, int x, int y);
+
+			//Releases the server-side copy, it must be called when the pixels are changed.
+			void release();
+
+			static image::presentation_statistics statistics();
+		private:
+			server_image * impl_;
+		};//end class image_presentation
+
+		//class scaled_variants
+		//	The scaled_variants keeps the stretched results of an image, keyed by the source rectangle, the target
+		//	size and the stretch algorithm, so that redrawing an image at the same size does not stretch it again.
+		//	A large image which is scaled down is stretched from the nearest half-size level rather than from the
+		//	full resolution. The variants of all images share one memory capacity.
+		class scaled_variants
+			: nana::noncopyable
+		{
+		public:
+			~scaled_variants();
+
+			void stretch(const pixel_buffer&, const nana::rectangle& src_r, drawable_type, const nana::rectangle& r);
+
+			//Discards the variants, it must be called when the pixels are changed.
+			void release();
+
+			static void capacity(std::size_t bytes);
+		};//end class scaled_variants
+	}
+}//end namespace paint
+}//end namespace nana
+
+#endif
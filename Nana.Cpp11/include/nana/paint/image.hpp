@@ -14,6 +14,7 @@
 #define NANA_PAINT_IMAGE_HPP
 
 #include "graphics.hpp"
+#include <functional>
 
 namespace nana
 {
@@ -26,6 +27,29 @@ namespace paint
 	public:
 		class image_impl_interface;
 
+		///	The counters of uploading the image pixels to the display server.
+		struct presentation_statistics
+		{
+			std::size_t uploads;		///< The number of images uploaded.
+			std::size_t upload_bytes;	///< The total bytes of the uploaded pixels.
+			std::size_t cached_pastes;	///< The number of pastes answered without uploading.
+			double bytes_per_second;	///< The upload throughput, measured over the time spent on uploading.
+		};
+
+		///	The progress of decoding an image file. The rows [0, rows) of the image are available when it is reported,
+		///	an interlaced image is decoded in several passes and every pass refines the rows decoded by the previous ones.
+		struct decode_progress
+		{
+			nana::size dimension;
+			unsigned rows;
+			unsigned pass;
+			unsigned passes;
+		};
+
+		///	The progress handler is invoked in the thread which opens the image, the image object may be pasted in the handler
+		///	to display the partial image.
+		typedef std::function<void(const decode_progress&)> progress_handler;
+
 		image();
 		image(const image&);
 		image(image&&);
@@ -35,6 +59,7 @@ namespace paint
 		image& operator=(const image& rhs);
 		image& operator=(image&&);
 		bool open(const nana::string& filename);
+		bool open(const nana::string& filename, const progress_handler&);
 		bool empty() const;
 		operator unspecified_bool_t() const;
 		void close();
@@ -42,6 +67,12 @@ namespace paint
 		void paste(graphics& dst, int x, int y) const;
 		void paste(const nana::rectangle& r_src, graphics& dst, const point& p_dst) const;
 		void stretch(const nana::rectangle& r_src, graphics& dst, const nana::rectangle& r_dst) const;
+
+		///	Returns the counters of uploading the pixels of images to the display server.
+		static presentation_statistics statistics();
+
+		///	Sets the memory capacity of the stretched results kept for the images, the default capacity is 16MB.
+		static void stretch_cache_capacity(std::size_t bytes);
 	private:
 		std::shared_ptr<image_impl_interface> image_ptr_;
 	};//end class image
@@ -4,6 +4,9 @@
 
 namespace nana
 {
+	//class unicode_bidi
+	//	An unicode_bidi object keeps its buffers between the calls of linestr, a caller which resolves
+	//	many lines should reuse the object.
 	class unicode_bidi
 	{
 	public:
@@ -48,7 +51,14 @@ namespace nana
 		};
 
 		void linestr(const char_type*, std::size_t len, std::vector<entity> & reordered);
+
+		//Returns the reordered entities, the reference is valid until the next call of linestr.
+		const std::vector<entity>& linestr(const char_type*, std::size_t len);
 	private:
+		//Returns true if the line has no right-to-left, arabic number and explicit embedding characters,
+		//such a line is a single left-to-right entity and the algorithm is skipped.
+		static bool _m_pure_ltr(const char_type * begin, const char_type * end);
+
 		static unsigned _m_paragraph_level(const char_type * begin, const char_type * end);
 
 		void _m_push_entity(const char_type * begin, const char_type *end, unsigned level, bidi_char);
@@ -68,6 +78,8 @@ namespace nana
 		void _m_output_bidi_char() const;
 	private:
 		std::vector<entity>	levels_;
+		std::vector<entity>	reordered_;
+		std::vector<remember> stack_;
 	};
 
 }
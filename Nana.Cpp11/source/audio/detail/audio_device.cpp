@@ -42,7 +42,7 @@ namespace nana{namespace audio
 		//class audio_device
 			audio_device::audio_device()
 #if defined(NANA_WINDOWS)
-				: handle_(nullptr), buf_prep_(nullptr)
+				: handle_(nullptr), raw_next_(0), buf_prep_(nullptr)
 #elif defined(NANA_LINUX)
 				: handle_(nullptr), buf_prep_(nullptr)
 #endif
@@ -58,7 +58,7 @@ namespace nana{namespace audio
 				return (nullptr == handle_);
 			}
 
-			bool audio_device::open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample)
+			bool audio_device::open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample, std::size_t buffer_ms)
 			{
 #if defined(NANA_WINDOWS)
 				close();
@@ -143,6 +143,13 @@ namespace nana{namespace audio
 						return false;
 					}
 
+					if(buffer_ms)
+					{
+						//The driver may choose a different size, a failure here is not fatal.
+						unsigned buffer_time = static_cast<unsigned>(buffer_ms * 1000);
+						::snd_pcm_hw_params_set_buffer_time_near(handle_, params, &buffer_time, 0);
+					}
+
 					if(::snd_pcm_hw_params(handle_, params) < 0)
 					{
 						close();
@@ -163,6 +170,16 @@ namespace nana{namespace audio
 				if(handle_)
 				{
 #if defined(NANA_WINDOWS)
+					for(auto & hdr : raw_headers_)
+					{
+						while((hdr.dwFlags & WHDR_PREPARED) && (0 == (hdr.dwFlags & WHDR_DONE)))
+							nana::system::sleep(1);
+						if(hdr.dwFlags & WHDR_PREPARED)
+							wave_native_if.out_unprepare(handle_, &hdr, sizeof(WAVEHDR));
+					}
+					raw_headers_.clear();
+					raw_blocks_.clear();
+					raw_next_ = 0;
 					wave_native_if.out_close(handle_);
 #elif defined(NANA_LINUX)
 					::snd_pcm_close(handle_);
@@ -204,6 +221,54 @@ namespace nana{namespace audio
 #endif
 			}
 
+			void audio_device::write(const void * frames, std::size_t bytes)
+			{
+#if defined(NANA_WINDOWS)
+				const std::size_t blocks = 4;
+				if(raw_headers_.empty())
+				{
+					WAVEHDR hdr;
+					memset(&hdr, 0, sizeof(hdr));
+					raw_headers_.assign(blocks, hdr);
+					raw_blocks_.resize(blocks);
+				}
+
+				//Wait for the oldest block, the device plays the blocks in the order they are written.
+				WAVEHDR & hdr = raw_headers_[raw_next_];
+				std::vector<char> & block = raw_blocks_[raw_next_];
+				raw_next_ = (raw_next_ + 1) % blocks;
+
+				while((hdr.dwFlags & WHDR_PREPARED) && (0 == (hdr.dwFlags & WHDR_DONE)))
+					nana::system::sleep(1);
+
+				if(hdr.dwFlags & WHDR_PREPARED)
+					wave_native_if.out_unprepare(handle_, &hdr, sizeof(WAVEHDR));
+
+				block.assign(reinterpret_cast<const char*>(frames), reinterpret_cast<const char*>(frames) + bytes);
+				memset(&hdr, 0, sizeof(hdr));
+				hdr.lpData = block.data();
+				hdr.dwBufferLength = static_cast<unsigned long>(bytes);
+				wave_native_if.out_prepare(handle_, &hdr, sizeof(WAVEHDR));
+				wave_native_if.out_write(handle_, &hdr, sizeof(WAVEHDR));
+#elif defined(NANA_LINUX)
+				const char * buf = reinterpret_cast<const char*>(frames);
+				std::size_t frame_count = bytes / bytes_per_frame_;
+				while(frame_count > 0)
+				{
+					int err = ::snd_pcm_writei(handle_, buf, frame_count);
+					if(err > 0)
+					{
+						frame_count -= err;
+						buf += err * bytes_per_frame_;
+					}
+					else if(-EPIPE == err)
+						::snd_pcm_prepare(handle_);
+					else if(-EAGAIN != err)
+						break;
+				}
+#endif
+			}
+
 			void audio_device::wait_for_drain() const
 			{
 #if defined(NANA_WINDOWS)
@@ -223,6 +288,10 @@ namespace nana{namespace audio
 					buffer_preparation::meta * m;
 					{
 						std::lock_guard<decltype(queue_lock_)> lock(self->queue_lock_);
+
+						//The blocks of write(frames, bytes) are not queued, they are recycled by the writer.
+						if(self->done_queue_.empty())
+							return;
 						m = self->done_queue_.front();
 						self->done_queue_.erase(self->done_queue_.begin());
 					}
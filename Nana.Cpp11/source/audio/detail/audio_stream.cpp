@@ -13,12 +13,16 @@ namespace nana{	namespace audio
 				{
 					wave_spec::master_riff_chunk riff;
 					fs_.read(reinterpret_cast<char*>(&riff), sizeof(riff));
-					if(riff.ckID == *reinterpret_cast<const unsigned long*>("RIFF") && riff.waveID == *reinterpret_cast<const unsigned long*>("WAVE"))
+					if(riff.ckID == *reinterpret_cast<const unsigned*>("RIFF") && riff.waveID == *reinterpret_cast<const unsigned*>("WAVE"))
 					{
 						fs_.read(reinterpret_cast<char*>(&ck_format_), sizeof(ck_format_));
-						if(ck_format_.ckID == *reinterpret_cast<const unsigned long*>("fmt ") && ck_format_.wFormatTag == 1)	//Only support PCM format
+						if(ck_format_.ckID == *reinterpret_cast<const unsigned*>("fmt ") && ck_format_.wFormatTag == 1)	//Only support PCM format
 						{
-							std::size_t cksize = _m_locate_chunck(*reinterpret_cast<const unsigned long*>("data"));
+							//The format chunk may have an extension after the PCM fields.
+							if(ck_format_.cksize > sizeof(ck_format_) - sizeof(chunck))
+								fs_.seekg(ck_format_.cksize - (sizeof(ck_format_) - sizeof(chunck)), std::ios::cur);
+
+							std::size_t cksize = _m_locate_chunck(*reinterpret_cast<const unsigned*>("data"));
 							if(cksize)
 							{
 								pcm_data_pos_ = static_cast<std::size_t>(fs_.tellg());
@@ -77,7 +81,7 @@ namespace nana{	namespace audio
 
 					if(ck.ckID == ckID)
 						return ck.cksize;
-					if(ck.ckID == *reinterpret_cast<const unsigned long*>("data"))
+					if(ck.ckID == *reinterpret_cast<const unsigned*>("data"))
 						fs_.seekg(ck.cksize + (ck.cksize & 1 ? 1 : 0), std::ios::cur);
 					else
 						fs_.seekg(ck.cksize, std::ios::cur);
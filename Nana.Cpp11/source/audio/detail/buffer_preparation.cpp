@@ -6,28 +6,35 @@ namespace nana{	namespace audio
 	namespace detail
 	{
 		//class buffer_preparation
-			buffer_preparation::buffer_preparation(audio_stream& as, std::size_t seconds)
-				: running_(true), wait_for_buffer_(false), as_(as)
+			buffer_preparation::buffer_preparation(audio_stream& as, std::size_t latency_ms, std::size_t blocks)
+				:	prepared_(0), read_(0), reverted_(0), running_(true), finished_(false),
+					producer_waiting_(false), consumer_waiting_(false), as_(as)
 			{
-				//Allocate the space
-				buffer_.reserve(seconds);
-				prepared_.reserve(seconds);
+				if(0 == blocks)
+					blocks = 1;
 
+				//The size of a block is rounded down to whole frames.
 				const wave_spec::format_chunck & ck = as.format();
-				block_size_ = ck.nAvgBytesPerSec;
-				for(std::size_t i = 0; i < seconds; ++i)
+				const std::size_t align = (ck.nBlockAlign ? ck.nBlockAlign : 1);
+				block_size_ = static_cast<std::size_t>(static_cast<unsigned long long>(ck.nAvgBytesPerSec) * latency_ms / 1000 / blocks);
+				block_size_ -= block_size_ % align;
+				if(block_size_ < align)
+					block_size_ = align;
+
+				ring_.reserve(blocks);
+				for(std::size_t i = 0; i < blocks; ++i)
 				{
-					char * rawbuf = new char[sizeof(meta) + ck.nAvgBytesPerSec];
+					char * rawbuf = new char[sizeof(meta) + block_size_];
 					meta * m = reinterpret_cast<meta*>(rawbuf);
 #if defined(NANA_WINDOWS)
 					memset(m, 0, sizeof(meta));
 					m->dwBufferLength = static_cast<unsigned long>(block_size_);
 					m->lpData = rawbuf + sizeof(meta);
 #elif defined(NANA_LINUX)
-					m->bufsize = ck.nAvgBytesPerSec;
+					m->bufsize = block_size_;
 					m->buf = rawbuf + sizeof(meta);
 #endif
-					prepared_.push_back(m);
+					ring_.push_back(m);
 				}
 
 				thr_ = std::move(std::thread([this](){this->_m_prepare_routine();}));
@@ -36,123 +43,119 @@ namespace nana{	namespace audio
 			buffer_preparation::~buffer_preparation()
 			{
 				running_ = false;
-
-				cond_prepared_.notify_one();
-				cond_buffer_.notify_one();
+				{
+					std::lock_guard<decltype(doorbell_)> lock(doorbell_);
+					cond_.notify_all();
+				}
 
 				if(thr_.joinable())
 					thr_.join();
 
-				for(auto metaptr : prepared_)
+				for(auto metaptr : ring_)
 					delete [] reinterpret_cast<char*>(metaptr);
 			}
 
 			buffer_preparation::meta * buffer_preparation::read()
 			{
-				std::unique_lock<decltype(token_buffer_)> lock(token_buffer_);
-
-				//Wait for the buffer
-				if(0 == buffer_.size())
-				{
-					//Before waiting, checks the thread whether it is finished
-					//it indicates the preparation is finished.
-					if(false == running_)
-						return nullptr;
+				_m_wait(consumer_waiting_, [this]{ return (read_ != prepared_) || finished_; });
+				return try_read();
+			}
 
-					wait_for_buffer_ = true;
-					cond_buffer_.wait(lock);
+			buffer_preparation::meta * buffer_preparation::try_read()
+			{
+				const std::size_t pos = read_.load(std::memory_order_relaxed);
+				if(pos == prepared_.load(std::memory_order_acquire))
+					return nullptr;
 
-					//NO more buffers
-					if(0 == buffer_.size())
-						return nullptr;
-				}
-				meta * m = buffer_.front();
-				buffer_.erase(buffer_.begin());
+				meta * m = ring_[pos % ring_.size()];
+				read_.store(pos + 1, std::memory_order_release);
 				return m;
 			}
 
 			//Revert the meta that returned by read()
-			void buffer_preparation::revert(meta * m)
+			void buffer_preparation::revert(meta *)
 			{
-				std::lock_guard<decltype(token_prepared_)> lock(token_prepared_);
-				bool if_signal = prepared_.empty();
-				prepared_.push_back(m);
-				if(if_signal)
-					cond_prepared_.notify_one();
+				//The blocks are reverted in the order they are read, the counter identifies the block.
+				reverted_.fetch_add(1);
+				_m_signal(producer_waiting_);
 			}
 
 			bool buffer_preparation::data_finished() const
 			{
-				std::lock_guard<decltype(token_prepared_)> lock(token_prepared_);
-				return ((prepared_.size() == prepared_.capacity()) && (running_ == false));
+				return (finished_ && (reverted_ == prepared_));
 			}
 
-			void buffer_preparation::_m_prepare_routine()
+			bool buffer_preparation::drained() const
 			{
-				const std::size_t fixed_bufsize = 1024;
-				char buf[fixed_bufsize];
-				const std::size_t block_size = block_size_;
+				return (finished_ && (read_ == prepared_));
+			}
 
-				while(running_)
+			void buffer_preparation::_m_prepare_routine()
+			{
+				const std::size_t blocks = ring_.size();
+				while(true)
 				{
-					meta * m = 0;
-					{
-						std::unique_lock<decltype(token_prepared_)> lock(token_prepared_);
-
-						if(prepared_.size() == 0)
-						{
-							cond_prepared_.wait(lock);
-
-							if(false == running_)
-								return;
-						}
-						m = prepared_.back();
-						prepared_.pop_back();
-					}
-
-					std::size_t buffered = 0;
-					while(buffered != block_size)
-					{
-						std::size_t want_bytes = block_size - buffered;
-						if(want_bytes > fixed_bufsize)	want_bytes = fixed_bufsize;
+					//Wait for a block which is reverted by the consumer.
+					_m_wait(producer_waiting_, [this, blocks]{ return (prepared_ - reverted_ < blocks) || !running_; });
+					if(false == running_)
+						break;
 
-						std::size_t read_bytes = as_.read(buf, want_bytes);
-						if(read_bytes)
-						{
+					const std::size_t pos = prepared_.load(std::memory_order_relaxed);
+					meta * m = ring_[pos % blocks];
 #if defined(NANA_WINDOWS)
-							memcpy(m->lpData + buffered, buf, read_bytes);
+					char * buf = m->lpData;
 #elif defined(NANA_LINUX)
-							memcpy(m->buf + buffered, buf, read_bytes);
+					char * buf = m->buf;
 #endif
-							buffered += read_bytes;
-						}
-						else if(0 == as_.data_length())
-						{
-							if(buffered == 0)
-							{
-								//PCM data is drained
-								std::lock_guard<decltype(token_buffer_)> lock(token_buffer_);
-								cond_buffer_.notify_one();
-								running_ = false;
-								return;
-							}
+					std::size_t buffered = 0;
+					while(buffered != block_size_)
+					{
+						std::size_t read_bytes = as_.read(buf + buffered, block_size_ - buffered);
+						if(0 == read_bytes)
 							break;
-						}
+						buffered += read_bytes;
 					}
+
+					//PCM data is drained
+					if(0 == buffered)
+						break;
 #if defined(NANA_WINDOWS)
 					m->dwBufferLength = static_cast<unsigned long>(buffered);
 #elif defined(NANA_LINUX)
 					m->bufsize = buffered;
 #endif
-					std::lock_guard<decltype(token_buffer_)> lock(token_buffer_);
-					buffer_.push_back(m);
-					if(wait_for_buffer_)
-					{
-						cond_buffer_.notify_one();
-						wait_for_buffer_ = false;
-					}
+					prepared_ = pos + 1;
+					_m_signal(consumer_waiting_);
+
 					if(0 == as_.data_length())
-						running_ = false;
+						break;
+				}
+
+				finished_ = true;
+				_m_signal(consumer_waiting_);
+			}
+
+			//The waiting flag is set before the predicate is checked, and the other side checks the flag after
+			//it changes the counters, both are sequentially consistent, so a wakeup is never lost.
+			template<typename Predicate>
+			void buffer_preparation::_m_wait(std::atomic<bool>& waiting, Predicate pred)
+			{
+				if(pred())
+					return;
+
+				std::unique_lock<decltype(doorbell_)> lock(doorbell_);
+				waiting = true;
+				while(!pred())
+					cond_.wait(lock);
+				waiting = false;
+			}
+
+			void buffer_preparation::_m_signal(std::atomic<bool>& waiting)
+			{
+				if(waiting)
+				{
+					std::lock_guard<decltype(doorbell_)> lock(doorbell_);
+					cond_.notify_all();
 				}
 			}
 		//end class buffer_preparation
@@ -0,0 +1,858 @@
+#include <nana/audio/mixer.hpp>
+#include <nana/audio/detail/audio_mixer.hpp>
+#include <nana/audio/detail/audio_device.hpp>
+#include <nana/system/platform.hpp>
+#include <nana/charset.hpp>
+#include <nana/filesystem/fs_utility.hpp>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+
+#if defined(NANA_MINGW) && defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_thread.hpp>
+	#include <nana/std_mutex.hpp>
+	#include <nana/std_condition_variable.hpp>
+#else
+	#include <mutex>
+	#include <condition_variable>
+	#include <thread>
+#endif
+
+namespace nana{	namespace audio
+{
+	namespace detail
+	{
+		//Converts the samples of WAV into floats. Every loop is a plain element-wise operation
+		//which is vectorized by the compiler.
+		static void to_float(const char* src, std::size_t bits, std::size_t count, float* dst)
+		{
+			switch(bits)
+			{
+			case 8:
+				{
+					auto s = reinterpret_cast<const unsigned char*>(src);
+					for(std::size_t i = 0; i < count; ++i)
+						dst[i] = (static_cast<int>(s[i]) - 128) * (1.0f / 128);
+				}
+				break;
+			case 16:
+				{
+					auto s = reinterpret_cast<const short*>(src);
+					for(std::size_t i = 0; i < count; ++i)
+						dst[i] = s[i] * (1.0f / 32768);
+				}
+				break;
+			case 24:
+				{
+					auto s = reinterpret_cast<const unsigned char*>(src);
+					for(std::size_t i = 0; i < count; ++i, s += 3)
+						dst[i] = static_cast<int>((static_cast<std::uint32_t>(s[0]) << 8) | (static_cast<std::uint32_t>(s[1]) << 16) | (static_cast<std::uint32_t>(s[2]) << 24)) * (1.0f / 2147483648.0f);
+				}
+				break;
+			case 32:
+				{
+					auto s = reinterpret_cast<const int*>(src);
+					for(std::size_t i = 0; i < count; ++i)
+						dst[i] = s[i] * (1.0f / 2147483648.0f);
+				}
+				break;
+			}
+		}
+
+		//Converts the mixed samples into 16-bit samples, the samples out of range are clipped.
+		static void to_s16(const float* src, std::size_t count, short* dst)
+		{
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				float s = src[i] * 32767.0f;
+				s = (s > 32767.0f ? 32767.0f : (s < -32768.0f ? -32768.0f : s));
+				dst[i] = static_cast<short>(s);
+			}
+		}
+
+		//struct pcm_data
+			pcm_data::pcm_data()
+				: channels(0), rate(0), frames(0)
+			{}
+
+			bool pcm_data::load(audio_stream& as)
+			{
+				const wave_spec::format_chunck & ck = as.format();
+				const std::size_t bits = ck.wBitsPerSample;
+				if((bits != 8 && bits != 16 && bits != 24 && bits != 32) || (0 == ck.nChannels) || (0 == ck.nSamplePerSec))
+					return false;
+
+				as.locate();
+				std::vector<char> raw(as.data_length());
+				const std::size_t bytes = as.read(raw.data(), raw.size());
+
+				channels = ck.nChannels;
+				rate = ck.nSamplePerSec;
+				frames = bytes / ((bits >> 3) * channels);
+				samples.resize(frames * channels);
+				to_float(raw.data(), bits, samples.size(), samples.data());
+				return (frames != 0);
+			}
+		//end struct pcm_data
+
+		//class pcm_stream
+			pcm_stream::pcm_stream()
+				: block_(nullptr), offset_(0), bits_(0)
+			{}
+
+			bool pcm_stream::open(const nana::string& file)
+			{
+				if(false == stream_.open(file))
+					return false;
+
+				const wave_spec::format_chunck & ck = stream_.format();
+				bits_ = ck.wBitsPerSample;
+				if((bits_ != 8 && bits_ != 16 && bits_ != 24 && bits_ != 32) || (0 == ck.nChannels) || (0 == ck.nSamplePerSec))
+					return false;
+
+				//Read ahead 200 milliseconds, it is far beyond a period of the mixer.
+				stream_.locate();
+				buffer_.reset(new buffer_preparation(stream_, 200));
+				return true;
+			}
+
+			std::size_t pcm_stream::channels() const
+			{
+				return (buffer_ ? stream_.format().nChannels : 0);
+			}
+
+			std::size_t pcm_stream::rate() const
+			{
+				return stream_.format().nSamplePerSec;
+			}
+
+			std::size_t pcm_stream::read(float* frames, std::size_t count)
+			{
+				const std::size_t channels = stream_.format().nChannels;
+				const std::size_t frame_bytes = (bits_ >> 3) * channels;
+
+				std::size_t done = 0;
+				while(done < count)
+				{
+					if(nullptr == block_)
+					{
+						block_ = buffer_->try_read();
+						if(nullptr == block_)
+							break;
+						offset_ = 0;
+					}
+#if defined(NANA_WINDOWS)
+					const char * buf = block_->lpData;
+					const std::size_t bytes = block_->dwBufferLength;
+#elif defined(NANA_LINUX)
+					const char * buf = block_->buf;
+					const std::size_t bytes = block_->bufsize;
+#endif
+					std::size_t n = (bytes - offset_) / frame_bytes;
+					if(n > count - done)
+						n = count - done;
+
+					to_float(buf + offset_, bits_, n * channels, frames + done * channels);
+					offset_ += n * frame_bytes;
+					done += n;
+
+					if(offset_ + frame_bytes > bytes)
+					{
+						buffer_->revert(block_);
+						block_ = nullptr;
+					}
+				}
+				return done;
+			}
+
+			bool pcm_stream::eof() const
+			{
+				return ((nullptr == block_) && buffer_->drained());
+			}
+		//end class pcm_stream
+
+		//class pcm_cache
+			struct pcm_cache::implementation
+			{
+				struct entry
+				{
+					nana::string file;
+					std::shared_ptr<const pcm_data> pcm;
+					std::size_t size;
+					long long file_bytes;
+					std::time_t file_modified;
+				};
+
+				std::mutex mutex;
+				std::list<entry> entries;	//The most recently used is the first.
+				std::map<nana::string, std::list<entry>::iterator> index;
+				std::size_t capacity;
+				std::size_t used;
+
+				implementation()
+					: capacity(8 * 1024 * 1024), used(0)
+				{}
+
+				static bool stamp(const nana::string& file, long long& bytes, std::time_t& modified)
+				{
+					filesystem::attribute attr;
+					if(false == filesystem::file_attrib(file, attr))
+						return false;
+					bytes = attr.bytes;
+					modified = std::mktime(&attr.modified);
+					return true;
+				}
+
+				void erase(std::map<nana::string, std::list<entry>::iterator>::iterator i)
+				{
+					used -= i->second->size;
+					entries.erase(i->second);
+					index.erase(i);
+				}
+
+				void shrink()
+				{
+					while(used > capacity && !entries.empty())
+						erase(index.find(entries.back().file));
+				}
+			};
+
+			pcm_cache::pcm_cache()
+				: impl_(new implementation)
+			{}
+
+			pcm_cache& pcm_cache::instance()
+			{
+				static pcm_cache * object = new pcm_cache;
+				return *object;
+			}
+
+			std::shared_ptr<const pcm_data> pcm_cache::find(const nana::string& file)
+			{
+				//The file is stamped without the lock.
+				long long bytes;
+				std::time_t modified;
+				const bool stamped = implementation::stamp(file, bytes, modified);
+
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				auto i = impl_->index.find(file);
+				if(i == impl_->index.end())
+					return nullptr;
+
+				if((false == stamped) || (i->second->file_bytes != bytes) || (i->second->file_modified != modified))
+				{
+					impl_->erase(i);
+					return nullptr;
+				}
+
+				impl_->entries.splice(impl_->entries.begin(), impl_->entries, i->second);
+				return i->second->pcm;
+			}
+
+			void pcm_cache::insert(const nana::string& file, const std::shared_ptr<const pcm_data>& pcm)
+			{
+				implementation::entry ent;
+				ent.size = pcm->samples.size() * sizeof(float);
+				if((false == cacheable(ent.size)) || (false == implementation::stamp(file, ent.file_bytes, ent.file_modified)))
+					return;
+
+				ent.file = file;
+				ent.pcm = pcm;
+
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				auto i = impl_->index.find(file);
+				if(i != impl_->index.end())
+					impl_->erase(i);
+
+				impl_->entries.push_front(ent);
+				impl_->index[file] = impl_->entries.begin();
+				impl_->used += ent.size;
+				impl_->shrink();
+			}
+
+			bool pcm_cache::cacheable(std::size_t bytes) const
+			{
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				return (bytes <= impl_->capacity / 8);
+			}
+
+			void pcm_cache::capacity(std::size_t bytes)
+			{
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				impl_->capacity = bytes;
+				impl_->shrink();
+			}
+		//end class pcm_cache
+
+		class device_sink
+			: public audio_sink
+		{
+		public:
+			bool open(std::size_t rate, std::size_t channels, std::size_t buffer_ms)
+			{
+				channels_ = channels;
+				buffered_ = rate * buffer_ms / 1000;
+				return dev_.open(channels, rate, 16, buffer_ms);
+			}
+
+			void write(const short* frames, std::size_t count)
+			{
+				dev_.write(frames, count * channels_ * sizeof(short));
+			}
+
+			std::size_t latency() const
+			{
+				return buffered_;
+			}
+		private:
+			audio_device dev_;
+			std::size_t channels_;
+			std::size_t buffered_;
+		};
+
+		class null_sink
+			: public audio_sink
+		{
+			typedef std::chrono::steady_clock clock_type;
+		public:
+			null_sink(bool paced, std::size_t rate)
+				: paced_(paced), rate_(rate ? rate : 44100), frames_(0), start_(clock_type::now())
+			{}
+
+			void write(const short*, std::size_t count)
+			{
+				if(false == paced_)
+					return;
+
+				//Sleep until the frames would be consumed by a device.
+				frames_ += count;
+				auto due = start_ + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(static_cast<double>(frames_) / rate_));
+				auto now = clock_type::now();
+				if(due > now)
+					nana::system::sleep(static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count()));
+				else if(now - due > std::chrono::seconds(1))
+				{
+					//It is idle for a while, restart the clock rather than catching up.
+					start_ = now;
+					frames_ = 0;
+				}
+			}
+		private:
+			const bool paced_;
+			const std::size_t rate_;
+			unsigned long long frames_;
+			clock_type::time_point start_;
+		};
+
+		class file_sink
+			: public audio_sink
+		{
+		public:
+			file_sink(std::size_t rate, std::size_t channels)
+				: rate_(rate), channels_(channels), bytes_(0)
+			{}
+
+			~file_sink()
+			{
+				if(fs_)
+				{
+					//Rewrite the header with the sizes.
+					fs_.seekp(0, std::ios::beg);
+					_m_header();
+				}
+			}
+
+			bool open(const nana::string& file)
+			{
+				fs_.open(static_cast<std::string>(nana::charset(file)), std::ios::binary | std::ios::trunc);
+				if(fs_)
+					_m_header();
+				return (fs_.good());
+			}
+
+			void write(const short* frames, std::size_t count)
+			{
+				const std::size_t bytes = count * channels_ * sizeof(short);
+				fs_.write(reinterpret_cast<const char*>(frames), static_cast<std::streamsize>(bytes));
+				bytes_ += bytes;
+			}
+		private:
+			void _m_put(unsigned value, std::size_t bytes)
+			{
+				for(std::size_t i = 0; i < bytes; ++i)
+					fs_.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+			}
+
+			void _m_header()
+			{
+				const unsigned block_align = static_cast<unsigned>(channels_ * sizeof(short));
+				fs_.write("RIFF", 4);
+				_m_put(static_cast<unsigned>(36 + bytes_), 4);
+				fs_.write("WAVEfmt ", 8);
+				_m_put(16, 4);
+				_m_put(1, 2);	//PCM
+				_m_put(static_cast<unsigned>(channels_), 2);
+				_m_put(static_cast<unsigned>(rate_), 4);
+				_m_put(static_cast<unsigned>(rate_ * block_align), 4);
+				_m_put(block_align, 2);
+				_m_put(16, 2);
+				fs_.write("data", 4);
+				_m_put(static_cast<unsigned>(bytes_), 4);
+			}
+		private:
+			std::ofstream fs_;
+			const std::size_t rate_;
+			const std::size_t channels_;
+			std::size_t bytes_;
+		};
+
+		//class audio_mixer
+			//struct implementation
+			//	The sink_mutex is held while a period is mixed and written, the mutex only guards the voices,
+			//	so that a voice can be played while the mixer thread is blocked by the device.
+			//	The lock order is sink_mutex then mutex.
+			struct audio_mixer::implementation
+			{
+				typedef std::chrono::steady_clock clock_type;
+
+				//A finished voice whose frames are still buffered by the sink.
+				struct draining
+				{
+					unsigned long long due;		//The voice is heard when the written frames reach the due.
+					complete_handler handler;
+				};
+
+				struct voice
+				{
+					std::shared_ptr<const pcm_data> pcm;
+					std::shared_ptr<pcm_stream> stream;
+					std::vector<float> window;		//The frames of the stream which are read but not mixed.
+					float gain;
+					complete_handler handler;
+					unsigned long long position;	//The position in the source frames, in 32.32 fixed point.
+				};
+
+				std::mutex sink_mutex;
+				std::unique_ptr<audio_sink> sink;
+				std::size_t rate;
+				std::size_t channels;
+				std::size_t period_ms;
+				std::vector<float> mixbuf;
+				std::vector<short> outbuf;
+
+				mutable std::mutex mutex;
+				std::condition_variable cond;
+				std::vector<voice> voices;
+				std::vector<draining> drains;
+				unsigned long long written;		//The number of the frames which are mixed for the sink.
+				mixer::statistics_t stat;
+
+				std::thread thread;
+
+				implementation()
+					: rate(44100), channels(2), period_ms(10), written(0)
+				{
+					stat.voices = stat.periods = 0;
+					stat.frames = 0;
+					stat.mix_seconds = stat.period_seconds = 0;
+				}
+
+				std::size_t period_frames() const
+				{
+					std::size_t frames = rate * period_ms / 1000;
+					return (frames < 64 ? 64 : frames);
+				}
+
+				//Mixes a voice into the mix buffer, returns false if the voice is finished.
+				bool render(voice& v, float* mix, std::size_t frames) const
+				{
+					const float * src;
+					std::size_t src_frames, src_channels, src_rate;
+					bool eof = true;
+
+					if(v.pcm)
+					{
+						src = v.pcm->samples.data();
+						src_frames = v.pcm->frames;
+						src_channels = v.pcm->channels;
+						src_rate = v.pcm->rate;
+					}
+					else
+					{
+						src_channels = v.stream->channels();
+						src_rate = v.stream->rate();
+
+						//Read the frames which are required by this period, and one more for the interpolation.
+						const unsigned long long step = (static_cast<unsigned long long>(src_rate) << 32) / rate;
+						const std::size_t required = static_cast<std::size_t>((v.position + step * frames) >> 32) + 2;
+						std::size_t have = v.window.size() / src_channels;
+						if(have < required)
+						{
+							v.window.resize(required * src_channels);
+							have += v.stream->read(v.window.data() + have * src_channels, required - have);
+							v.window.resize(have * src_channels);
+						}
+						src = v.window.data();
+						src_frames = have;
+						eof = v.stream->eof();
+					}
+
+					_m_render(v, src, src_frames, src_channels, src_rate, eof, mix, frames);
+
+					const std::size_t idx = static_cast<std::size_t>(v.position >> 32);
+					if(eof && (idx >= src_frames))
+						return false;
+
+					if(v.stream && idx)
+					{
+						//Discard the frames which are mixed, the position is relative to the window.
+						v.window.erase(v.window.begin(), v.window.begin() + (idx < src_frames ? idx : src_frames) * src_channels);
+						v.position -= static_cast<unsigned long long>(idx) << 32;
+					}
+					return true;
+				}
+
+				//Mixes the frames of a source. If the source is not at its end, the mixing stops at the last frame of
+				//the source, the rest of the period is silent for the voice until the source is read.
+				void _m_render(voice& v, const float* src, std::size_t src_frames, std::size_t src_channels, std::size_t src_rate, bool eof, float* mix, std::size_t frames) const
+				{
+					const float gain = v.gain;
+
+					if((src_rate == rate) && (src_channels == channels))
+					{
+						//Neither resampling nor channel mapping, it is a multiply-add which is vectorized.
+						const std::size_t begin = static_cast<std::size_t>(v.position >> 32);
+						if(begin >= src_frames)
+							return;
+
+						const std::size_t count = (src_frames - begin < frames ? src_frames - begin : frames);
+						const float * s = src + begin * channels;
+						const std::size_t n = count * channels;
+						for(std::size_t i = 0; i < n; ++i)
+							mix[i] += s[i] * gain;
+
+						v.position += static_cast<unsigned long long>(count) << 32;
+						return;
+					}
+
+					//Resample by linear interpolation. A mono source is copied to every channel,
+					//the channels of the output which the source does not have are taken from its last channel.
+					const unsigned long long step = (static_cast<unsigned long long>(src_rate) << 32) / rate;
+					for(std::size_t f = 0; f < frames; ++f, mix += channels)
+					{
+						const std::size_t idx = static_cast<std::size_t>(v.position >> 32);
+						if(idx >= src_frames)
+							return;
+
+						const float * a = src + idx * src_channels;
+						const float * b = a;
+						if(idx + 1 < src_frames)
+							b += src_channels;
+						else if(false == eof)
+							return;
+
+						const float t = static_cast<float>(v.position & 0xFFFFFFFF) * (1.0f / 4294967296.0f);
+
+						for(std::size_t c = 0; c < channels; ++c)
+						{
+							const std::size_t sc = (c < src_channels ? c : src_channels - 1);
+							mix[c] += (a[sc] + (b[sc] - a[sc]) * t) * gain;
+						}
+						v.position += step;
+					}
+				}
+
+				//Returns true if there is a voice to be mixed or drained.
+				bool busy() const
+				{
+					return !(voices.empty() && drains.empty());
+				}
+
+				//Moves the handlers of the voices and the drains into handlers, it is called when the voices are stopped
+				//or the sink is replaced.
+				void drop(std::vector<complete_handler>& handlers)
+				{
+					for(auto & v : voices)
+					{
+						if(v.handler)
+							handlers.push_back(std::move(v.handler));
+					}
+					voices.clear();
+
+					for(auto & d : drains)
+						handlers.push_back(std::move(d.handler));
+					drains.clear();
+				}
+
+				//Mixes a period of the voices, a finished voice is drained after latency frames are written by the sink,
+				//the handlers of the drained voices are moved into completed. The silence is mixed while a voice is drained.
+				//It returns the number of frames which are mixed, 0 if there is no voice.
+				std::size_t mix(std::vector<complete_handler>& completed, std::size_t latency)
+				{
+					std::lock_guard<decltype(mutex)> lock(mutex);
+					if(false == busy())
+						return 0;
+
+					auto start = clock_type::now();
+
+					const std::size_t frames = period_frames();
+					mixbuf.assign(frames * channels, 0.0f);
+					outbuf.resize(frames * channels);
+
+					for(std::size_t i = 0; i < voices.size();)
+					{
+						if(render(voices[i], mixbuf.data(), frames))
+						{
+							++i;
+							continue;
+						}
+
+						if(voices[i].handler)
+						{
+							draining d;
+							d.due = written + frames + latency;
+							d.handler = std::move(voices[i].handler);
+							drains.push_back(std::move(d));
+						}
+
+						//The order of the voices is insignificant.
+						if(i + 1 != voices.size())
+							voices[i] = std::move(voices.back());
+						voices.pop_back();
+					}
+
+					to_s16(mixbuf.data(), mixbuf.size(), outbuf.data());
+
+					written += frames;
+					for(std::size_t i = 0; i < drains.size();)
+					{
+						if(drains[i].due > written)
+						{
+							++i;
+							continue;
+						}
+
+						completed.push_back(std::move(drains[i].handler));
+						if(i + 1 != drains.size())
+							drains[i] = std::move(drains.back());
+						drains.pop_back();
+					}
+
+					++stat.periods;
+					stat.frames += frames;
+					stat.mix_seconds += std::chrono::duration<double>(clock_type::now() - start).count();
+					stat.period_seconds = static_cast<double>(frames) / rate;
+					return frames;
+				}
+			};
+
+			audio_mixer::audio_mixer()
+				: impl_(new implementation)
+			{
+				impl_->thread = std::thread([this]()
+				{
+					_m_run();
+				});
+			}
+
+			audio_mixer& audio_mixer::instance()
+			{
+				//The mixer is never destroyed, because its thread may be blocked by the device.
+				static audio_mixer * object = new audio_mixer;
+				return *object;
+			}
+
+			bool audio_mixer::play(const std::shared_ptr<const pcm_data>& pcm, float gain, const complete_handler& handler)
+			{
+				if(nullptr == pcm || 0 == pcm->frames)
+					return false;
+
+				implementation::voice v;
+				v.pcm = pcm;
+				v.gain = gain;
+				v.handler = handler;
+				v.position = 0;
+
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				bool if_signal = (false == impl_->busy());
+				impl_->voices.push_back(std::move(v));
+				if(if_signal)
+					impl_->cond.notify_one();
+				return true;
+			}
+
+			bool audio_mixer::play(const std::shared_ptr<pcm_stream>& stream, float gain, const complete_handler& handler)
+			{
+				if(nullptr == stream || 0 == stream->channels())
+					return false;
+
+				implementation::voice v;
+				v.stream = stream;
+				v.gain = gain;
+				v.handler = handler;
+				v.position = 0;
+
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				bool if_signal = (false == impl_->busy());
+				impl_->voices.push_back(std::move(v));
+				if(if_signal)
+					impl_->cond.notify_one();
+				return true;
+			}
+
+			void audio_mixer::output(std::unique_ptr<audio_sink> sink, std::size_t rate, std::size_t channels)
+			{
+				std::vector<complete_handler> drained;
+				{
+					std::lock_guard<decltype(impl_->sink_mutex)> sink_lock(impl_->sink_mutex);
+					std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+
+					//The frames buffered by the old sink are finished when it is destroyed.
+					for(auto & d : impl_->drains)
+						drained.push_back(std::move(d.handler));
+					impl_->drains.clear();
+
+					impl_->sink = std::move(sink);
+					impl_->rate = (rate ? rate : 44100);
+					impl_->channels = (channels ? channels : 2);
+				}
+
+				for(auto & handler : drained)
+					handler();
+			}
+
+			bool audio_mixer::open_device(std::size_t rate, std::size_t channels)
+			{
+				std::size_t period_ms;
+				{
+					std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+					period_ms = impl_->period_ms;
+				}
+
+				std::unique_ptr<device_sink> dev(new device_sink);
+				if(dev->open(rate, channels, period_ms * 4))
+				{
+					output(std::move(dev), rate, channels);
+					return true;
+				}
+
+				//The voices are still finished in time without a device.
+				output(std::unique_ptr<audio_sink>(new null_sink(true, rate)), rate, channels);
+				return false;
+			}
+
+			void audio_mixer::latency(std::size_t milliseconds)
+			{
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				impl_->period_ms = (milliseconds ? milliseconds : 1);
+			}
+
+			void audio_mixer::stop_all()
+			{
+				std::vector<complete_handler> stopped;
+				{
+					std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+					impl_->drop(stopped);
+				}
+
+				//The handlers are invoked without the lock, they may play other voices.
+				for(auto & handler : stopped)
+					handler();
+			}
+
+			mixer::statistics_t audio_mixer::statistics() const
+			{
+				std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+				mixer::statistics_t stat = impl_->stat;
+				stat.voices = impl_->voices.size();
+				return stat;
+			}
+
+			void audio_mixer::_m_run()
+			{
+				std::vector<complete_handler> completed;
+				while(true)
+				{
+					{
+						std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+						impl_->cond.wait(lock, [this]{ return impl_->busy(); });
+					}
+
+					bool no_sink;
+					{
+						std::lock_guard<decltype(impl_->sink_mutex)> sink_lock(impl_->sink_mutex);
+						no_sink = (nullptr == impl_->sink);
+					}
+
+					if(no_sink)
+					{
+						std::size_t rate, channels;
+						{
+							std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+							rate = impl_->rate;
+							channels = impl_->channels;
+						}
+						open_device(rate, channels);
+					}
+
+					{
+						std::lock_guard<decltype(impl_->sink_mutex)> sink_lock(impl_->sink_mutex);
+						const std::size_t frames = impl_->mix(completed, (impl_->sink ? impl_->sink->latency() : 0));
+						if(frames && impl_->sink)
+							impl_->sink->write(impl_->outbuf.data(), frames);
+					}
+
+					//The handlers are invoked without the locks, they may play other voices.
+					for(auto & handler : completed)
+						handler();
+					completed.clear();
+				}
+			}
+		//end class audio_mixer
+	}//end namespace detail
+
+	//class mixer
+		bool mixer::output_device(std::size_t rate, std::size_t channels)
+		{
+			return detail::audio_mixer::instance().open_device(rate, channels);
+		}
+
+		void mixer::output_null(bool paced, std::size_t rate, std::size_t channels)
+		{
+			detail::audio_mixer::instance().output(std::unique_ptr<detail::audio_sink>(new detail::null_sink(paced, rate)), rate, channels);
+		}
+
+		bool mixer::output_file(const nana::string& file, std::size_t rate, std::size_t channels)
+		{
+			std::unique_ptr<detail::file_sink> sink(new detail::file_sink(rate, channels));
+			if(false == sink->open(file))
+				return false;
+
+			detail::audio_mixer::instance().output(std::move(sink), rate, channels);
+			return true;
+		}
+
+		void mixer::latency(std::size_t milliseconds)
+		{
+			detail::audio_mixer::instance().latency(milliseconds);
+		}
+
+		void mixer::cache_capacity(std::size_t bytes)
+		{
+			detail::pcm_cache::instance().capacity(bytes);
+		}
+
+		void mixer::stop_all()
+		{
+			detail::audio_mixer::instance().stop_all();
+		}
+
+		auto mixer::statistics() -> statistics_t
+		{
+			return detail::audio_mixer::instance().statistics();
+		}
+	//end class mixer
+}//end namespace audio
+}//end namespace nana
@@ -1,16 +1,49 @@
 #include <nana/audio/player.hpp>
 #include <nana/audio/detail/audio_stream.hpp>
-#include <nana/audio/detail/audio_device.hpp>
-#include <nana/audio/detail/buffer_preparation.hpp>
-#include <nana/system/platform.hpp>
+#include <nana/audio/detail/audio_mixer.hpp>
+
+#if defined(NANA_MINGW) && defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_mutex.hpp>
+	#include <nana/std_condition_variable.hpp>
+#else
+	#include <mutex>
+	#include <condition_variable>
+#endif
 
 namespace nana{	namespace audio
 {
 	//class player
+		//struct implementation
+		//	A short sound is decoded at the first play and it is shared by the voices and the pcm_cache,
+		//	a long sound is read from its file by every voice.
 		struct player::implementation
 		{
+			nana::string			file;
 			detail::audio_stream	stream;
-			detail::audio_device	dev;
+			bool streamed;
+
+			std::shared_ptr<const detail::pcm_data> pcm;
+
+			implementation()
+				: streamed(false)
+			{}
+
+			std::shared_ptr<const detail::pcm_data> fetch()
+			{
+				if((nullptr == pcm) && !stream.empty())
+				{
+					std::shared_ptr<detail::pcm_data> data = std::make_shared<detail::pcm_data>();
+					if(data->load(stream))
+					{
+						pcm = data;
+						detail::pcm_cache::instance().insert(file, pcm);
+					}
+
+					//The stream is no longer needed.
+					stream.close();
+				}
+				return pcm;
+			}
 		};
 
 		player::player()
@@ -30,36 +63,86 @@ namespace nana{	namespace audio
 
 		bool player::open(const nana::string& file)
 		{
-			if(impl_->stream.open(file))
+			close();
+
+			//A cached sound is played without opening the file.
+			impl_->pcm = detail::pcm_cache::instance().find(file);
+			if(impl_->pcm)
+			{
+				impl_->file = file;
+				return true;
+			}
+
+			if(false == impl_->stream.open(file))
+				return false;
+
+			impl_->file = file;
+
+			const detail::wave_spec::format_chunck & ck = impl_->stream.format();
+			impl_->stream.locate();
+			const std::size_t bytes_per_sample = (ck.wBitsPerSample >> 3);
+			const std::size_t decoded = (bytes_per_sample ? impl_->stream.data_length() / bytes_per_sample * sizeof(float) : 0);
+			if(false == detail::pcm_cache::instance().cacheable(decoded))
 			{
-				const detail::wave_spec::format_chunck & ck = impl_->stream.format();
-				return impl_->dev.open(ck.nChannels, ck.nSamplePerSec, ck.wBitsPerSample);
+				impl_->streamed = true;
+				impl_->stream.close();
 			}
-			return false;
+			return true;
 		}
 
 		void player::play()
 		{
-			if(impl_->dev.empty() || impl_->stream.empty()) return;
+			struct wait_state
+			{
+				std::mutex mutex;
+				std::condition_variable cond;
+				bool finished;
+			};
 
-			//Locate the PCM
-			impl_->stream.locate();
-			const std::size_t seconds = 5;
+			auto state = std::make_shared<wait_state>();
+			state->finished = false;
 
-			detail::buffer_preparation buffer(impl_->stream, seconds);
-			impl_->dev.prepare(buffer);
-			detail::buffer_preparation::meta * meta;
-			while((meta = buffer.read()))
+			if(play_async(1.0f, [state]
+				{
+					std::lock_guard<decltype(state->mutex)> lock(state->mutex);
+					state->finished = true;
+					state->cond.notify_one();
+				}))
 			{
-				impl_->dev.write(meta);
+				std::unique_lock<decltype(state->mutex)> lock(state->mutex);
+				state->cond.wait(lock, [&state]{ return state->finished; });
 			}
-			impl_->dev.wait_for_drain();
+		}
+
+		bool player::play_async(float gain)
+		{
+			return play_async(gain, complete_handler());
+		}
+
+		bool player::play_async(float gain, const complete_handler& handler)
+		{
+			if(impl_->streamed)
+			{
+				std::shared_ptr<detail::pcm_stream> stream = std::make_shared<detail::pcm_stream>();
+				if(false == stream->open(impl_->file))
+					return false;
+
+				return detail::audio_mixer::instance().play(stream, gain, handler);
+			}
+
+			auto pcm = impl_->fetch();
+			if(nullptr == pcm)
+				return false;
+
+			return detail::audio_mixer::instance().play(pcm, gain, handler);
 		}
 
 		void player::close()
 		{
-			impl_->dev.close();
+			impl_->pcm.reset();
 			impl_->stream.close();
+			impl_->file.clear();
+			impl_->streamed = false;
 		}
 }//end namespace audio
-}//end namespace nana
\ No newline at end of file
+}//end namespace nana
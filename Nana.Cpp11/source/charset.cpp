@@ -25,6 +25,11 @@
 	#include <windows.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define NANA_CHARSET_SSE2
+#endif
+
 namespace nana
 {
 	namespace detail
@@ -141,6 +146,280 @@ namespace nana
 			return true;
 		}
 
+		//The transcoding core
+		//@brief:	The decoders validate the code units, an invalid code unit is decoded as U+FFFD and only
+		//			one code unit is consumed, so that the decoding is resynchronized at the next one.
+		namespace utf_core
+		{
+			const char32_t replacement = 0xFFFD;
+
+			inline bool is_surrogate(char32_t code)
+			{
+				return (0xD800 <= code && code <= 0xDFFF);
+			}
+
+			//Returns the number of the leading bytes which are less than 0x80.
+			inline std::size_t ascii_run(const unsigned char* p, const unsigned char* end)
+			{
+				const unsigned char * const begin = p;
+#if defined(NANA_CHARSET_SSE2)
+				for(; end - p >= 16; p += 16)
+				{
+					if(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))))
+						break;
+				}
+#endif
+				while((p != end) && (*p < 0x80))
+					++p;
+				return static_cast<std::size_t>(p - begin);
+			}
+
+			//Returns the number of the leading code points which are less than 0x80.
+			template<typename Char>
+			inline std::size_t ascii_run(const Char* p, const Char* end)
+			{
+				const Char * const begin = p;
+				while((p != end) && (static_cast<char32_t>(*p) < 0x80))
+					++p;
+				return static_cast<std::size_t>(p - begin);
+			}
+
+#if defined(NANA_CHARSET_SSE2)
+			inline std::size_t ascii_run(const char32_t* p, const char32_t* end)
+			{
+				const char32_t * const begin = p;
+				const __m128i mask = _mm_set1_epi32(~0x7F);
+				const __m128i zero = _mm_setzero_si128();
+				for(; end - p >= 4; p += 4)
+				{
+					__m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), mask);
+					if(_mm_movemask_epi8(_mm_cmpeq_epi32(v, zero)) != 0xFFFF)
+						break;
+				}
+
+				while((p != end) && (*p < 0x80))
+					++p;
+				return static_cast<std::size_t>(p - begin);
+			}
+#endif
+
+			char32_t decode_utf8(const unsigned char*& p, const unsigned char* end)
+			{
+				unsigned ch = *p;
+				if(ch < 0x80)
+				{
+					++p;
+					return ch;
+				}
+
+				std::size_t len;
+				char32_t code, min_code;
+				if(0xC2 <= ch && ch < 0xE0)
+				{
+					len = 2;
+					code = ch & 0x1F;
+					min_code = 0x80;
+				}
+				else if(0xE0 <= ch && ch < 0xF0)
+				{
+					len = 3;
+					code = ch & 0xF;
+					min_code = 0x800;
+				}
+				else if(0xF0 <= ch && ch < 0xF5)
+				{
+					len = 4;
+					code = ch & 0x7;
+					min_code = 0x10000;
+				}
+				else
+				{
+					++p;
+					return replacement;
+				}
+
+				if(static_cast<std::size_t>(end - p) < len)
+				{
+					++p;
+					return replacement;
+				}
+
+				for(std::size_t i = 1; i < len; ++i)
+				{
+					if((p[i] & 0xC0) != 0x80)
+					{
+						++p;
+						return replacement;
+					}
+					code = (code << 6) | (p[i] & 0x3F);
+				}
+
+				//Reject the overlong forms, the surrogates and the code points out of range.
+				if(code < min_code || code > 0x10FFFF || is_surrogate(code))
+				{
+					++p;
+					return replacement;
+				}
+
+				p += len;
+				return code;
+			}
+
+			template<typename Char16>
+			char32_t decode_utf16(const Char16*& p, const Char16* end)
+			{
+				char32_t code = static_cast<char16_t>(*p++);
+				if(is_surrogate(code))
+				{
+					if(code < 0xDC00 && (p != end))
+					{
+						char32_t low = static_cast<char16_t>(*p);
+						if(0xDC00 <= low && low <= 0xDFFF)
+						{
+							++p;
+							return (((code - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+						}
+					}
+					return replacement;
+				}
+				return code;
+			}
+
+			//Writes the UTF-8 of a code point, the buffer must have 4 bytes at least.
+			inline char* encode_utf8(char* out, char32_t code)
+			{
+				if(code > 0x10FFFF || is_surrogate(code))
+					code = replacement;
+
+				if(code < 0x80)
+				{
+					*out++ = static_cast<char>(code);
+				}
+				else if(code < 0x800)
+				{
+					*out++ = static_cast<char>(0xC0 | (code >> 6));
+					*out++ = static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else if(code < 0x10000)
+				{
+					*out++ = static_cast<char>(0xE0 | (code >> 12));
+					*out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					*out++ = static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					*out++ = static_cast<char>(0xF0 | (code >> 18));
+					*out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					*out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					*out++ = static_cast<char>(0x80 | (code & 0x3F));
+				}
+				return out;
+			}
+
+			//Appends the UTF-8 of UTF-32 code points, the ASCII runs are copied in bulk.
+			template<typename Char32>
+			void utf32_to_utf8(std::string& dst, const Char32* s, std::size_t len)
+			{
+				const std::size_t origin = dst.size();
+				dst.resize(origin + len * 4);
+
+				char * const begin = &dst[0] + origin;
+				char * out = begin;
+				const Char32 * const end = s + len;
+				while(s != end)
+				{
+					std::size_t run = ascii_run(s, end);
+					for(const Char32 * run_end = s + run; s != run_end; ++s)
+						*out++ = static_cast<char>(*s);
+
+					if(s != end)
+						out = encode_utf8(out, static_cast<char32_t>(*s++));
+				}
+				dst.resize(origin + (out - begin));
+			}
+
+			template<typename Char16>
+			void utf16_to_utf8(std::string& dst, const Char16* s, std::size_t len)
+			{
+				const std::size_t origin = dst.size();
+				dst.resize(origin + len * 3);
+
+				char * const begin = &dst[0] + origin;
+				char * out = begin;
+				const Char16 * const end = s + len;
+				while(s != end)
+				{
+					std::size_t run = ascii_run(s, end);
+					for(const Char16 * run_end = s + run; s != run_end; ++s)
+						*out++ = static_cast<char>(*s);
+
+					if(s != end)
+						out = encode_utf8(out, decode_utf16(s, end));
+				}
+				dst.resize(origin + (out - begin));
+			}
+
+			//Appends the code points of UTF-8 bytes, the ASCII runs are widened in bulk.
+			template<typename String>
+			void utf8_to_utf32(String& dst, const char* s, std::size_t len)
+			{
+				typedef typename String::value_type char_type;
+
+				const std::size_t origin = dst.size();
+				dst.resize(origin + len);
+
+				char_type * const begin = &dst[0] + origin;
+				char_type * out = begin;
+				const unsigned char * p = reinterpret_cast<const unsigned char*>(s);
+				const unsigned char * const end = p + len;
+				while(p != end)
+				{
+					std::size_t run = ascii_run(p, end);
+					for(const unsigned char * run_end = p + run; p != run_end; ++p)
+						*out++ = static_cast<char_type>(*p);
+
+					if(p != end)
+						*out++ = static_cast<char_type>(decode_utf8(p, end));
+				}
+				dst.resize(origin + (out - begin));
+			}
+
+			//Appends the UTF-16 code units of UTF-8 bytes.
+			template<typename String>
+			void utf8_to_utf16(String& dst, const char* s, std::size_t len)
+			{
+				typedef typename String::value_type char_type;
+
+				const std::size_t origin = dst.size();
+				dst.resize(origin + len);
+
+				char_type * const begin = &dst[0] + origin;
+				char_type * out = begin;
+				const unsigned char * p = reinterpret_cast<const unsigned char*>(s);
+				const unsigned char * const end = p + len;
+				while(p != end)
+				{
+					std::size_t run = ascii_run(p, end);
+					for(const unsigned char * run_end = p + run; p != run_end; ++p)
+						*out++ = static_cast<char_type>(*p);
+
+					if(p != end)
+					{
+						char32_t code = decode_utf8(p, end);
+						if(code > 0xFFFF)
+						{
+							code -= 0x10000;
+							*out++ = static_cast<char_type>(0xD800 | (code >> 10));
+							*out++ = static_cast<char_type>(0xDC00 | (code & 0x3FF));
+						}
+						else
+							*out++ = static_cast<char_type>(code);
+					}
+				}
+				dst.resize(origin + (out - begin));
+			}
+		}//end namespace utf_core
+
 		class charset_encoding_interface
 		{
 		public:
@@ -363,7 +642,12 @@ namespace nana
 				switch(encoding)
 				{
 				case unicode::utf8:
-					return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(data_);
+					{
+						//Transcode the wide characters without building a converter.
+						std::string utf8str;
+						utf::append_utf8(utf8str, data_.data(), data_.size());
+						return utf8str;
+					}
 				case unicode::utf16:
 					return std::wstring_convert<std::codecvt_utf16<wchar_t, 0x10FFFF, std::little_endian>>().to_bytes(data_);
 				case unicode::utf32:
@@ -399,40 +683,7 @@ namespace nana
 		unsigned long utf8char(const unsigned char*& p, const unsigned char* end)
 		{
 			if(p != end)
-			{
-				if(*p < 0x80)
-				{
-					return *(p++);
-				}
-				unsigned ch = *p;
-				unsigned long code;
-				if(ch < 0xC0)
-				{
-					p = end;
-					return 0;
-				}
-				else if(ch < 0xE0 && (p + 1 <= end))
-				{
-					code = ((ch & 0x1F) << 6) | (p[1] & 0x3F);
-					p += 2;
-				}
-				else if(ch < 0xF0 && (p + 2 <= end))
-				{
-					code = ((((ch & 0xF) << 6) | (p[1] & 0x3F)) << 6) | (p[2] & 0x3F);
-					p += 3;
-				}
-				else if(ch < 0x1F && (p + 3 <= end))
-				{
-					code = ((((((ch & 0x7) << 6) | (p[1] & 0x3F)) << 6) | (p[2] & 0x3F)) << 6) | (p[3] & 0x3F);
-					p += 4;
-				}
-				else
-				{
-					p = end;
-					return 0;
-				}
-				return code;
-			}
+				return utf_core::decode_utf8(p, end);
 			return 0;
 		}
 
@@ -441,13 +692,13 @@ namespace nana
 			unsigned long code;
 			if(le_or_be)
 			{
-				if((bytes + 4 <= end) && ((bytes[1] & 0xFC) == 0xD8))
+				if((bytes + 4 <= end) && ((bytes[1] & 0xFC) == 0xD8) && ((bytes[3] & 0xFC) == 0xDC))
 				{
 					//32bit encoding
 					unsigned long ch0 = bytes[0] | (bytes[1] << 8);
 					unsigned long ch1 = bytes[2] | (bytes[3] << 8);
 
-					code = (ch0 & 0x3FFF << 10) | (ch1 & 0x3FFF);
+					code = (((ch0 & 0x3FF) << 10) | (ch1 & 0x3FF)) + 0x10000;
 					bytes += 4;
 				}
 				else if(bytes + 2 <= end)
@@ -463,12 +714,12 @@ namespace nana
 			}
 			else
 			{
-				if((bytes + 4 <= end) && ((bytes[0] & 0xFC) == 0xD8))
+				if((bytes + 4 <= end) && ((bytes[0] & 0xFC) == 0xD8) && ((bytes[2] & 0xFC) == 0xDC))
 				{
 					//32bit encoding
 					unsigned long ch0 = (bytes[0] << 8) | bytes[1];
 					unsigned long ch1 = (bytes[2] << 8) | bytes[3];
-					code = (ch0 & 0x3FFF << 10) | (ch1 & 0x3FFF);
+					code = (((ch0 & 0x3FF) << 10) | (ch1 & 0x3FF)) + 0x10000;
 					bytes += 4;
 				}
 				else if(bytes + 2 <= end)
@@ -503,28 +754,8 @@ namespace nana
 
 		void put_utf8char(std::string& s, unsigned long code)
 		{
-			if(code < 0x80)
-			{
-				s += static_cast<char>(code);
-			}
-			else if(code < 0x800)
-			{
-				s += static_cast<char>(0xC0 | (code >> 6));
-				s += static_cast<char>(0x80 | (code & 0x3F));
-			}
-			else if(code < 0x10000)
-			{
-				s += static_cast<char>(0xE0 | (code >> 12));
-				s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
-				s += static_cast<char>(0x80 | (code & 0x3F));
-			}
-			else
-			{
-				s += static_cast<char>(0xF0 | (code >> 18));
-				s += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
-				s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
-				s += static_cast<char>(0x80 | (code & 0x3F));
-			}		
+			char buf[4];
+			s.append(buf, utf_core::encode_utf8(buf, static_cast<char32_t>(code)));
 		}
 
 		//le_or_be, true = le, false = be
@@ -573,13 +804,13 @@ namespace nana
 			{
 				s += static_cast<char>(code & 0xFF);
 				s += static_cast<char>((code & 0xFF00) >> 8);
-				s += static_cast<char>((code & 0xFF0000) >> 18);
+				s += static_cast<char>((code & 0xFF0000) >> 16);
 				s += static_cast<char>((code & 0xFF000000) >> 24);
 			}
 			else
 			{
 				s += static_cast<char>((code & 0xFF000000) >> 24);
-				s += static_cast<char>((code & 0xFF0000) >> 18);
+				s += static_cast<char>((code & 0xFF0000) >> 16);
 				s += static_cast<char>((code & 0xFF00) >> 8);
 				s += static_cast<char>(code & 0xFF);
 			}
@@ -796,9 +1027,15 @@ namespace nana
 					switch(utf_x_)
 					{
 					case unicode::utf8:
-						strbuf = detail::utf8_to_utf32(data_, true);
-						detail::put_utf32char(strbuf, 0, true);
-						break;
+						{
+							//Decode the UTF-8 into wide characters directly.
+							std::wstring wcstr;
+							utf::append_wstring(wcstr, data_.data(), data_.size());
+
+							std::string mbstr;
+							wc2mb(mbstr, wcstr.c_str());
+							return mbstr;
+						}
 					case unicode::utf16:
 						strbuf = detail::utf16_to_utf32(data_);
 						detail::put_utf32char(strbuf, 0, true);
@@ -889,8 +1126,11 @@ namespace nana
 					switch(utf_x_)
 					{
 					case unicode::utf8:
-						bytes = detail::utf8_to_utf32(data_, true);
-						break;
+						{
+							std::wstring wcstr;
+							utf::append_wstring(wcstr, data_.data(), data_.size());
+							return wcstr;
+						}
 					case unicode::utf16:
 						bytes = detail::utf16_to_utf32(data_);
 						break;
@@ -954,7 +1194,12 @@ namespace nana
 				switch(encoding)
 				{
 				case unicode::utf8:
-					return detail::utf32_to_utf8(std::string(reinterpret_cast<const char*>(data_.c_str()), data_.size() * sizeof(wchar_t)));
+					{
+						//Transcode the wide characters without an intermediate string.
+						std::string utf8str;
+						utf::append_utf8(utf8str, data_.data(), data_.size());
+						return utf8str;
+					}
 				case unicode::utf16:
 					return detail::utf32_to_utf16(std::string(reinterpret_cast<const char*>(data_.c_str()), data_.size() * sizeof(wchar_t)));
 				case unicode::utf32:
@@ -1065,4 +1310,67 @@ namespace nana
 		}
 	//end class charset
 
+	namespace utf
+	{
+		std::size_t ascii_prefix(const char* s, std::size_t len)
+		{
+			const unsigned char * p = reinterpret_cast<const unsigned char*>(s);
+			return detail::utf_core::ascii_run(p, p + len);
+		}
+
+		bool validate_utf8(const char* s, std::size_t len)
+		{
+			const unsigned char * p = reinterpret_cast<const unsigned char*>(s);
+			const unsigned char * const end = p + len;
+			while(p != end)
+			{
+				p += detail::utf_core::ascii_run(p, end);
+				if(p == end)
+					break;
+
+				//A replacement character which is encoded in the bytes is valid.
+				const unsigned char * start = p;
+				if(detail::utf_core::decode_utf8(p, end) == detail::utf_core::replacement)
+				{
+					if((p - start != 3) || (start[0] != 0xEF) || (start[1] != 0xBF) || (start[2] != 0xBD))
+						return false;
+				}
+			}
+			return true;
+		}
+
+		void append_utf8(std::string& dst, const char32_t* s, std::size_t len)
+		{
+			if(s && len)
+				detail::utf_core::utf32_to_utf8(dst, s, len);
+		}
+
+		void append_utf8(std::string& dst, const wchar_t* s, std::size_t len)
+		{
+			if(s && len)
+			{
+				if(sizeof(wchar_t) == 4)
+					detail::utf_core::utf32_to_utf8(dst, reinterpret_cast<const char32_t*>(s), len);
+				else
+					detail::utf_core::utf16_to_utf8(dst, s, len);
+			}
+		}
+
+		void append_utf32(std::u32string& dst, const char* utf8, std::size_t len)
+		{
+			if(utf8 && len)
+				detail::utf_core::utf8_to_utf32(dst, utf8, len);
+		}
+
+		void append_wstring(std::wstring& dst, const char* utf8, std::size_t len)
+		{
+			if(utf8 && len)
+			{
+				if(sizeof(wchar_t) == 4)
+					detail::utf_core::utf8_to_utf32(dst, utf8, len);
+				else
+					detail::utf_core::utf8_to_utf16(dst, utf8, len);
+			}
+		}
+	}//end namespace utf
 }//end namespace nana
@@ -42,7 +42,7 @@ namespace detail
 		bool conf::open(const char* file)
 		{
 			ifs_.open(file);
-			return static_cast<bool>(ifs_ != 0);
+			return static_cast<bool>(ifs_);
 		}
 
 		std::string conf::value(const char* key)
@@ -974,6 +974,11 @@ namespace detail
 		msg_dispatcher_->dispatch(reinterpret_cast<Window>(modal));
 	}
 
+	std::shared_ptr<nana::gui::detail::post_channel> platform_spec::msg_channel(native_window_type wd)
+	{
+		return msg_dispatcher_->channel(reinterpret_cast<Window>(wd));
+	}
+
 	void* platform_spec::request_selection(native_window_type requestor, Atom type, size_t& size)
 	{
 		if(requestor)
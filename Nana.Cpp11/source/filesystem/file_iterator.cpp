@@ -33,6 +33,11 @@ namespace filesystem
 			:name(name), size(fst.st_size), directory(0 != S_ISDIR(fst.st_mode))
 		{
         }
+
+		fileinfo::fileinfo(const nana::string& name, bool directory)
+			:name(name), size(0), directory(directory)
+		{
+		}
 #endif
 	//end struct fileinfo
 
@@ -131,7 +131,7 @@ namespace filesystem
 			nana::string path = dir;
 			path += '\\';
 
-			std::copy(file_iterator(dir), file_iterator(), std::back_inserter(files));
+			std::copy(file_iterator(dir, false), file_iterator(), std::back_inserter(files));
 
 			for(auto & f : files)
 			{
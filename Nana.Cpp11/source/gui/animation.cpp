@@ -16,6 +16,10 @@
 
 #include <vector>
 #include <list>
+#include <map>
+#include <string>
+#include <chrono>
+#include <algorithm>
 
 #if defined(NANA_MINGW) && defined(STD_THREAD_NOT_SUPPORTED)
     #include <nana/std_thread.hpp>
@@ -41,134 +45,199 @@ namespace nana{	namespace gui
 		{}
 	};
 
+	//struct cache_token
+	//@brief:	The identity of the frames of framebuilders in the frame cache. The framebuilders which are
+	//			pushed with the same cache key share a token, an anonymous framebuilder has its own token.
+	//			The frames are discarded when the token is destroyed.
+	struct cache_token
+	{
+		std::string name;
+
+		~cache_token();
+	};
+
 	struct framebuilder
 	{
 		std::size_t length;
 		std::function<bool(std::size_t, paint::graphics&, nana::size&)> frbuilder;
+		std::shared_ptr<cache_token> token;
 
-		framebuilder(const std::function<bool(std::size_t, paint::graphics&, nana::size&)>& f, std::size_t l)
-			: length(l), frbuilder(f)
-		{}
-
-		framebuilder(std::size_t l, std::function<bool(std::size_t, paint::graphics&, nana::size)>&& f)
-			: length(l), frbuilder(std::move(f))
+		framebuilder(const std::function<bool(std::size_t, paint::graphics&, nana::size&)>& f, std::size_t l, const std::shared_ptr<cache_token>& t)
+			: length(l), frbuilder(f), token(t)
 		{}
 	};
 
-	struct frame
+	//class frame_cache
+	//@brief:	The frame cache keeps the frames built by framebuilders, a built frame is shared by all
+	//			the animations which play the framebuilders of the same token. The least recently used
+	//			frames are discarded when the size of the cached frames exceeds the capacity.
+	class frame_cache
 	{
-		enum class kind
+		typedef std::pair<const cache_token*, std::size_t> key_type;
+
+		struct entry
 		{
-			oneshot,
-			framebuilder
+			key_type key;
+			bool good;
+			nana::size dimension;
+			paint::graphics graph;
 		};
+	public:
+		frame_cache()
+			: capacity_(32 * 1024 * 1024), bytes_(0)
+		{}
 
-		frame(const paint::image& r)
-			: type(kind::oneshot)
+		static frame_cache& instance()
 		{
-			u.oneshot = new paint::image(r);
+			//The cache is not destroyed at exit, because a frameset may be destroyed after static objects.
+			static frame_cache * object = new frame_cache;
+			return *object;
 		}
 
-		frame(paint::image&& r)
-			: type(kind::oneshot)
+		void capacity(std::size_t bytes)
 		{
-			u.oneshot = new paint::image(std::move(r));
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			capacity_ = bytes;
+			_m_shrink();
 		}
 
-		frame(const std::function<bool(std::size_t, paint::graphics&, nana::size&)>& frbuilder, std::size_t length)
-			: type(kind::framebuilder)
+		//Returns the token of a cache key, an empty key makes an anonymous token.
+		std::shared_ptr<cache_token> token(const std::string& name)
 		{
-			u.frbuilder = new framebuilder(frbuilder, length);
-		}
+			if(name.empty())
+				return std::make_shared<cache_token>();
 
-		frame(std::function<bool(std::size_t, paint::graphics&, nana::size&)>&& frbuilder, std::size_t length)
-			: type(kind::framebuilder)
-		{
-			u.frbuilder = new framebuilder(frbuilder, length);
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			auto & weak = names_[name];
+			auto tok = weak.lock();
+			if(nullptr == tok)
+			{
+				tok = std::make_shared<cache_token>();
+				tok->name = name;
+				weak = tok;
+			}
+			return tok;
 		}
 
-		frame(const frame& r)
-			: type(r.type)
+		//Retrieves the frame at pos of a framebuilder, the frame is built by the framebuilder
+		//into the framegraph if it is not cached. Returns false if the framebuilder fails.
+		bool fetch(const framebuilder& fb, std::size_t pos, paint::graphics& framegraph, paint::graphics& result, nana::size& dimension)
 		{
-			switch(type)
+			key_type key(fb.token.get(), pos);
 			{
-			case kind::oneshot:
-				u.oneshot = new paint::image(*r.u.oneshot);
-				break;
-			case kind::framebuilder:
-				u.frbuilder = new framebuilder(*r.u.frbuilder);
-				break;
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				auto i = table_.find(key);
+				if(i != table_.end())
+				{
+					//Move the entry to the front, it is the most recently used.
+					entries_.splice(entries_.begin(), entries_, i->second);
+					result = i->second->graph;
+					dimension = i->second->dimension;
+					return i->second->good;
+				}
 			}
-		}
 
-		frame(frame&& r)
-			: type(r.type)
-		{
-			u = r.u;
-			r.u.oneshot = nullptr;
-		}
+			//Build the frame without the lock, the framebuilder may take a long time.
+			const bool good = fb.frbuilder(pos, framegraph, dimension);
 
-		~frame()
-		{
-			switch(type)
+			entry e;
+			e.key = key;
+			e.good = good;
+			e.dimension = dimension;
+			if(good && dimension.width && dimension.height)
 			{
-			case kind::oneshot:
-				delete u.oneshot;
-				break;
-			case kind::framebuilder:
-				delete u.frbuilder;
-				break;
+				e.graph.make(dimension.width, dimension.height);
+				e.graph.bitblt(nana::rectangle(dimension), framegraph);
 			}
+			result = e.graph;
+
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			if(table_.count(key) == 0)
+			{
+				bytes_ += _m_bytes(e);
+				entries_.push_front(std::move(e));
+				table_[key] = entries_.begin();
+				_m_shrink();
+			}
+			return good;
 		}
 
-		frame& operator=(const frame& r)
+		//Discards the frames of a token, it is called when the token is destroyed.
+		void erase(const cache_token* tok)
 		{
-			if(this != &r)
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			if(tok->name.size())
 			{
-				switch(type)
-				{
-				case kind::oneshot:
-					delete u.oneshot;
-					break;
-				case kind::framebuilder:
-					delete u.frbuilder;
-					break;
-				}
+				//The name may be taken by a new token after this token expired.
+				auto i = names_.find(tok->name);
+				if((i != names_.end()) && i->second.expired())
+					names_.erase(i);
+			}
 
-				type = r.type;
-				switch(type)
+			for(auto i = entries_.begin(); i != entries_.end();)
+			{
+				if(i->key.first == tok)
 				{
-				case kind::oneshot:
-					u.oneshot = new paint::image(*r.u.oneshot);
-					break;
-				case kind::framebuilder:
-					u.frbuilder = new framebuilder(*r.u.frbuilder);
-					break;
+					bytes_ -= _m_bytes(*i);
+					table_.erase(i->key);
+					i = entries_.erase(i);
 				}
+				else
+					++i;
 			}
-			return *this;
+		}
+	private:
+		static std::size_t _m_bytes(const entry& e)
+		{
+			return static_cast<std::size_t>(e.graph.width()) * e.graph.height() * 4;
 		}
 
-		frame& operator=(frame&& r)
+		void _m_shrink()
 		{
-			if(this != &r)
+			//Keep the most recently used frame even if it exceeds the capacity.
+			while((bytes_ > capacity_) && (entries_.size() > 1))
 			{
-				switch(type)
-				{
-				case kind::oneshot:
-					delete u.oneshot;
-					break;
-				case kind::framebuilder:
-					delete u.frbuilder;
-					break;
-				}
-
-				type = r.type;
-				u = r.u;
-				r.u.oneshot = nullptr;
+				bytes_ -= _m_bytes(entries_.back());
+				table_.erase(entries_.back().key);
+				entries_.pop_back();
 			}
-			return *this;
 		}
+	private:
+		std::mutex mutex_;
+		std::size_t capacity_;
+		std::size_t bytes_;
+		std::list<entry> entries_;
+		std::map<key_type, std::list<entry>::iterator> table_;
+		std::map<std::string, std::weak_ptr<cache_token>> names_;
+	};//end class frame_cache
+
+	cache_token::~cache_token()
+	{
+		frame_cache::instance().erase(this);
+	}
+
+	//struct frame
+	//@brief:	A frame is immutable after it is created, therefore the copies of a frame share the
+	//			image and the framebuilder rather than duplicating them.
+	struct frame
+	{
+		enum class kind
+		{
+			oneshot,
+			framebuilder
+		};
+
+		frame(const paint::image& r)
+			: type(kind::oneshot), oneshot(r)
+		{}
+
+		frame(paint::image&& r)
+			: type(kind::oneshot), oneshot(std::move(r))
+		{}
+
+		frame(const std::function<bool(std::size_t, paint::graphics&, nana::size&)>& frbuilder, std::size_t length, const std::string& cache_key)
+			: type(kind::framebuilder), frbuilder(std::make_shared<framebuilder>(frbuilder, length, frame_cache::instance().token(cache_key)))
+		{}
 
 		std::size_t length() const
 		{
@@ -177,18 +246,15 @@ namespace nana{	namespace gui
 			case kind::oneshot:
 				return 1;
 			case kind::framebuilder:
-				return u.frbuilder->length;
+				return frbuilder->length;
 			}
 			return 0;
 		}
 
 		//
 		kind type;
-		union uframes
-		{
-			paint::image * oneshot;
-			framebuilder * frbuilder;
-		}u;
+		paint::image oneshot;
+		std::shared_ptr<framebuilder> frbuilder;
 	};
 
 	//class frameset
@@ -199,11 +265,9 @@ namespace nana{	namespace gui
 			std::list<frame> frames;
 			std::list<frame>::iterator this_frame;
 			std::size_t pos_in_this_frame;
-			mutable bool good_frame_by_frmbuilder;	//It indicates the state of frame whether is valid.
 
 			impl()
-				:	this_frame(frames.end()), pos_in_this_frame(0),
-					good_frame_by_frmbuilder(false)
+				:	this_frame(frames.end()), pos_in_this_frame(0)
 			{}
 
 			//Render A frame on the set of windows.
@@ -218,27 +282,29 @@ namespace nana{	namespace gui
 				case frame::kind::oneshot:
 					_m_render(outs, [&frmobj](paint::graphics& tar, const nana::point& pos)
 					{
-						frmobj.u.oneshot->paste(tar, pos.x, pos.y);
+						frmobj.oneshot.paste(tar, pos.x, pos.y);
 					});
 					break;
 				case frame::kind::framebuilder:
-					good_frame_by_frmbuilder = frmobj.u.frbuilder->frbuilder(pos_in_this_frame, framegraph, framegraph_dimension);
-					if(good_frame_by_frmbuilder)
 					{
-						nana::rectangle r = framegraph_dimension;
-						_m_render(outs, [&r, &framegraph](paint::graphics& tar, const nana::point& pos) mutable
+						paint::graphics built;
+						if(frame_cache::instance().fetch(*frmobj.frbuilder, pos_in_this_frame, framegraph, built, framegraph_dimension))
 						{
-							r.x = pos.x;
-							r.y = pos.y;
-							tar.bitblt(r, framegraph);
-						});
+							nana::rectangle r = framegraph_dimension;
+							_m_render(outs, [&r, &built](paint::graphics& tar, const nana::point& pos) mutable
+							{
+								r.x = pos.x;
+								r.y = pos.y;
+								tar.bitblt(r, built);
+							});
+						}
 					}
 					break;
 				}
 			}
 
 			//Render a frame on a specified window graph
-			void render_this(paint::graphics& graph, const nana::point& pos, paint::graphics& framegraph, nana::size& framegraph_dimension, bool rebuild_frame) const
+			void render_this(paint::graphics& graph, const nana::point& pos, paint::graphics& framegraph, nana::size& framegraph_dimension) const
 			{
 				if(this_frame == frames.end())
 					return;
@@ -247,16 +313,14 @@ namespace nana{	namespace gui
 				switch(frmobj.type)
 				{
 				case frame::kind::oneshot:
-					frmobj.u.oneshot->paste(graph, pos.x, pos.y);
+					frmobj.oneshot.paste(graph, pos.x, pos.y);
 					break;
 				case frame::kind::framebuilder:
-					if(rebuild_frame)
-						good_frame_by_frmbuilder = frmobj.u.frbuilder->frbuilder(pos_in_this_frame, framegraph, framegraph_dimension);
-
-					if(good_frame_by_frmbuilder)
 					{
-						nana::rectangle r(pos, framegraph_dimension);
-						graph.bitblt(r, framegraph);
+						//The frame is usually cached, it is rebuilt only if it was discarded.
+						paint::graphics built;
+						if(frame_cache::instance().fetch(*frmobj.frbuilder, pos_in_this_frame, framegraph, built, framegraph_dimension))
+							graph.bitblt(nana::rectangle(pos, framegraph_dimension), built);
 					}
 					break;
 				}
@@ -280,7 +344,7 @@ namespace nana{	namespace gui
 					pos_in_this_frame = 0;
 					break;
 				case frame::kind::framebuilder:
-					if(pos_in_this_frame >= frmobj.u.frbuilder->length)
+					if(pos_in_this_frame >= frmobj.frbuilder->length)
 					{
 						pos_in_this_frame = 0;
 						++this_frame;
@@ -311,8 +375,6 @@ namespace nana{	namespace gui
 
 					for(auto & outp : tar.second.points)
 						renderer(*graph, outp);
-
-					API::update_window(tar.first);
 				}
 			}
 		};//end struct frameset::impl
@@ -338,43 +400,60 @@ namespace nana{	namespace gui
 
 		void frameset::push_back(framebuilder&fb, std::size_t length)
 		{
-			impl_->frames.emplace_back(fb, length);
-			if(1 == impl_->frames.size())
-				impl_->this_frame = impl_->frames.begin();
+			push_back(fb, length, std::string());
 		}
 
 		void frameset::push_back(framebuilder&& fb, std::size_t length)
 		{
-			impl_->frames.emplace_back(std::move(fb), length);
+			push_back(fb, length, std::string());
+		}
+
+		void frameset::push_back(const framebuilder& fb, std::size_t length, const std::string& cache_key)
+		{
+			impl_->frames.emplace_back(fb, length, cache_key);
 			if(1 == impl_->frames.size())
 				impl_->this_frame = impl_->frames.begin();
 		}
+
+		void frameset::cache_capacity(std::size_t bytes)
+		{
+			frame_cache::instance().capacity(bytes);
+		}
 	//end class frameset
 
 	//class animation
-		class animation::performance_manager
+		//class frame_scheduler
+		//@brief:	The frame scheduler drives all the animations by one thread with a monotonic clock.
+		//			Every animation has its own frame rate, the frames which are late are skipped instead
+		//			of being rendered, and every root window is flushed to the screen once per tick.
+		class animation::frame_scheduler
 		{
 		public:
-			struct thread_variable
-			{
-				std::mutex mutex;
-				std::condition_variable condvar;
-				std::vector<impl*> animations;
+			typedef std::chrono::steady_clock clock_type;
+
+			frame_scheduler();
+
+			void insert(impl*);
+			void close(impl*);
 
-				std::size_t active;				//The number of active animations
-				std::shared_ptr<std::thread> thread;
-				double performance_parameter;
-			};
+			//Wakes up the scheduler thread. The clock of the animation specified by restart
+			//is restarted from now, the restart can be nullptr.
+			void wakeup(impl* restart);
 
-			thread_variable * insert(impl* p);
-			void close(impl* p);
-			bool empty() const;
+			std::mutex& mutex();
 		private:
-			void _m_perf_thread(thread_variable* thrvar);
+			void _m_thread();
+
+			//Renders the frames which are due, it returns true if there is an active animation,
+			//and next_due is the time point of the next due frame.
+			bool _m_tick(clock_type::time_point now, clock_type::time_point& next_due);
 		private:
-			mutable std::recursive_mutex mutex_;
-			std::vector<thread_variable*> threads_;
-		};	//end class animation::performance_manager
+			std::mutex mutex_;
+			std::condition_variable condvar_;
+			std::vector<impl*> animations_;
+			bool signaled_;
+			std::thread thread_;
+		};	//end class animation::frame_scheduler
 
 		struct animation::impl
 		{
@@ -393,40 +472,44 @@ namespace nana{	namespace gui
 				std::list<frameset>::iterator this_frameset;
 			}state;
 
-			performance_manager::thread_variable * thr_variable;
-			static performance_manager * perf_manager;
+			unsigned fps;
+			frame_scheduler::clock_type::time_point next_tick;
+			statistics_t statistics;
 
+			static frame_scheduler * scheduler;
 
 			impl()
-				: looped(false), paused(true)
+				: looped(false), paused(true), fps(23)
 			{
 				state.this_frameset = framesets.begin();
 
+				statistics.rendered = statistics.skipped = 0;
+				statistics.last_ms = statistics.average_ms = statistics.max_ms = 0;
+
 				{
 					nana::gui::internal_scope_guard isg;
-					if(nullptr == perf_manager)
-						perf_manager = new performance_manager;
+					//The scheduler is kept alive until the program exits, because its thread
+					//may be waiting for the lock of window manager which is owned by the caller.
+					if(nullptr == scheduler)
+						scheduler = new frame_scheduler;
 				}
-				thr_variable = perf_manager->insert(this);
+				scheduler->insert(this);
 			}
 
 			~impl()
 			{
-				perf_manager->close(this);
-				{
-					nana::gui::internal_scope_guard isg;
-					if(perf_manager->empty())
-					{
-						delete perf_manager;
-						perf_manager = nullptr;
-					}
-				}
+				scheduler->close(this);
+			}
+
+			frame_scheduler::clock_type::duration interval() const
+			{
+				return std::chrono::duration_cast<frame_scheduler::clock_type::duration>(std::chrono::duration<double>(1.0 / (fps ? fps : 1)));
 			}
 
 			void render_this_specifically(paint::graphics& graph, const nana::point& pos)
 			{
 				if(state.this_frameset != framesets.end())
-					state.this_frameset->impl_->render_this(graph, pos, framegraph, framegraph_dimension, false);
+					state.this_frameset->impl_->render_this(graph, pos, framegraph, framegraph_dimension);
 			}
 
 			void render_this_frame()
@@ -445,6 +528,26 @@ namespace nana{	namespace gui
 				return false;
 			}
 
+			bool eof() const
+			{
+				return ((state.this_frameset == framesets.end()) || state.this_frameset->impl_->eof());
+			}
+
+			//Moves to the next frame, and rewinds if it is looped.
+			//It returns false if the animation is over.
+			bool advance()
+			{
+				if(move_to_next())
+					return true;
+
+				if(looped)
+				{
+					reset();
+					return true;
+				}
+				return false;
+			}
+
 			//Seek to the first frameset
 			void reset()
 			{
@@ -454,106 +557,143 @@ namespace nana{	namespace gui
 			}
 		};//end struct animation::impl
 
-		//class animation::performance_manager
-			auto animation::performance_manager::insert(impl* p) -> thread_variable *
+		//class animation::frame_scheduler
+			animation::frame_scheduler::frame_scheduler()
+				: signaled_(false)
 			{
-				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				for(auto thr : threads_)
+				thread_ = std::thread([this]()
 				{
-					std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
-
-					if(thr->performance_parameter / (thr->animations.size() + 1) <= 43.3)
-					{
-						thr->animations.push_back(p);
-						return thr;
-					}
-				}
+					_m_thread();
+				});
+			}
 
-				auto thr = new thread_variable;
-				thr->animations.push_back(p);
-				thr->performance_parameter = 0.0;
-				thr->thread = std::shared_ptr<std::thread>(new std::thread([this, thr]()
-				{
-					_m_perf_thread(thr);
-				}));
+			void animation::frame_scheduler::insert(impl* p)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				animations_.push_back(p);
+			}
 
-				threads_.push_back(thr);
-				return thr;
+			void animation::frame_scheduler::close(impl* p)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				auto i = std::find(animations_.begin(), animations_.end(), p);
+				if(i != animations_.end())
+					animations_.erase(i);
 			}
 
-			void animation::performance_manager::close(impl* p)
+			void animation::frame_scheduler::wakeup(impl* restart)
 			{
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				for(auto thr : threads_)
-				{
-					std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
+				if(restart)
+					restart->next_tick = clock_type::now();
+				signaled_ = true;
+				condvar_.notify_one();
+			}
 
-					auto i = std::find(thr->animations.begin(), thr->animations.end(), p);
-					if(i != thr->animations.end())
-					{
-						thr->animations.erase(i);
-						return;
-					}
-				}
+			std::mutex& animation::frame_scheduler::mutex()
+			{
+				return mutex_;
 			}
 
-			bool animation::performance_manager::empty() const
+			void animation::frame_scheduler::_m_thread()
 			{
-				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				for(auto thr : threads_)
+				while(true)
 				{
-					if(thr->animations.size())
-						return false;
+					clock_type::time_point next_due;
+					bool active;
+					{
+						//Lock the window manager before the scheduler, it keeps the same order as
+						//the event handlers which access the animation in the GUI thread.
+						nana::gui::internal_scope_guard isg;
+						std::lock_guard<decltype(mutex_)> lock(mutex_);
+						active = _m_tick(clock_type::now(), next_due);
+					}
+
+					std::unique_lock<decltype(mutex_)> lock(mutex_);
+					if(active)
+						condvar_.wait_until(lock, next_due, [this]{ return signaled_; });
+					else
+						condvar_.wait(lock, [this]{ return signaled_; });
+					signaled_ = false;
 				}
-				return true;
 			}
 
-			void animation::performance_manager::_m_perf_thread(thread_variable* thrvar)
+			bool animation::frame_scheduler::_m_tick(clock_type::time_point now, clock_type::time_point& next_due)
 			{
-				nana::system::timepiece tmpiece;
-				while(true)
+				bool active = false;
+				std::vector<window> updates;
+
+				for(auto ani : animations_)
 				{
-					thrvar->active = 0;
-					tmpiece.start();
+					if(ani->paused)
+						continue;
 
+					if(ani->eof())
 					{
-						std::lock_guard<decltype(thrvar->mutex)> lock(thrvar->mutex);
-						for(auto ani : thrvar->animations)
-						{
-							if(ani->paused)
-								continue;
+						//The looped may be enabled after the animation is over, it restarts from now
+						//as a replay does, rather than skipping the frames since it was over.
+						if(false == ani->looped)
+							continue;
+						ani->reset();
+						ani->next_tick = now;
+					}
 
-							ani->render_this_frame();
-							if(false == ani->move_to_next())
-							{
-								if(ani->looped)
-								{
-									ani->reset();
-									++thrvar->active;
-								}
-							}
-							else
-								++thrvar->active;
-						}
+					if(ani->next_tick > now)
+					{
+						if((false == active) || (ani->next_tick < next_due))
+							next_due = ani->next_tick;
+						active = true;
+						continue;
 					}
 
-					if(thrvar->active)
+					auto interval = ani->interval();
+
+					//Skip the frames which are late, rather than rendering them one by one.
+					bool alive = true;
+					std::size_t late = static_cast<std::size_t>((now - ani->next_tick) / interval);
+					for(std::size_t i = 0; alive && (i < late); ++i)
+						alive = ani->advance();
+
+					ani->statistics.skipped += late;
+					ani->next_tick += interval * (late + 1);
+
+					if(false == alive)
+						continue;
+
+					nana::system::timepiece tmpiece;
+					tmpiece.start();
+					ani->render_this_frame();
+					double ms = tmpiece.calc();
+
+					auto & st = ani->statistics;
+					st.last_ms = ms;
+					st.average_ms = (st.average_ms * st.rendered + ms) / (st.rendered + 1);
+					if(ms > st.max_ms)
+						st.max_ms = ms;
+					++st.rendered;
+
+					for(auto & out : ani->outputs)
 					{
-						thrvar->performance_parameter = tmpiece.calc();
-						if(thrvar->performance_parameter < 43.4)
-							nana::system::sleep(static_cast<unsigned>(43.4 - thrvar->performance_parameter));
+						if(updates.end() == std::find(updates.begin(), updates.end(), out.first))
+							updates.push_back(out.first);
 					}
-					else
+
+					if(ani->advance())
 					{
-						//There isn't an active frame, then let the thread
-						//wait for a signal for an active animation
-						std::unique_lock<std::mutex> lock(thrvar->mutex);
-						if(0 == thrvar->active)
-							thrvar->condvar.wait(lock);
+						if((false == active) || (ani->next_tick < next_due))
+							next_due = ani->next_tick;
+						active = true;
 					}
 				}
+
+				//Every window is updated once in a tick, even if it is an output of many animations,
+				//and the windows which share a root window are copied to the screen at once.
+				if(updates.size())
+					API::update_windows(updates);
+
+				return active;
 			}
-		//end class animation::performance_manager
+		//end class animation::frame_scheduler
 
 		animation::animation()
 			: impl_(new impl)
@@ -587,25 +727,16 @@ namespace nana{	namespace gui
 			{
 				impl_->looped = enable;
 				if(enable)
-				{
-					std::unique_lock<std::mutex> lock(impl_->thr_variable->mutex);
-					if(0 == impl_->thr_variable->active)
-					{
-						impl_->thr_variable->active = 1;
-						impl_->thr_variable->condvar.notify_one();
-					}
-				}
+					impl::scheduler->wakeup(nullptr);
 			}
 		}
 
 		void animation::play()
 		{
-			impl_->paused = false;
-			std::unique_lock<std::mutex> lock(impl_->thr_variable->mutex);
-			if(0 == impl_->thr_variable->active)
+			if(impl_->paused)
 			{
-				impl_->thr_variable->active = 1;
-				impl_->thr_variable->condvar.notify_one();
+				impl_->paused = false;
+				impl::scheduler->wakeup(impl_);
 			}
 		}
 
@@ -628,17 +759,34 @@ namespace nana{	namespace gui
 
 				API::make_event<events::destroy>(wd, [this](const eventinfo& ei)
 				{
-					std::lock_guard<decltype(impl_->thr_variable->mutex)> lock(impl_->thr_variable->mutex);
+					std::lock_guard<std::mutex> lock(impl::scheduler->mutex());
 					impl_->outputs.erase(ei.window);
 	
 				});
 			}
 			output.points.push_back(pos);
 		}
+
+		void animation::fps(unsigned frames)
+		{
+			std::lock_guard<std::mutex> lock(impl::scheduler->mutex());
+			impl_->fps = (frames ? frames : 1);
+		}
+
+		unsigned animation::fps() const
+		{
+			return impl_->fps;
+		}
+
+		auto animation::statistics() const -> statistics_t
+		{
+			std::lock_guard<std::mutex> lock(impl::scheduler->mutex());
+			return impl_->statistics;
+		}
 	//end class animation
 
 
-	animation::performance_manager * animation::impl::perf_manager;
+	animation::frame_scheduler * animation::impl::scheduler;
 
 }	//end namespace gui
 }	//end namespace nana
@@ -228,7 +228,7 @@ namespace nana{	namespace gui{
 			//basic_window
 			//@brief: constructor for the root window
 			basic_window::basic_window(basic_window* owner, gui::category::root_tag**)
-				: other(category::root_tag::value)
+				: other(category::root_tag::value), events(nullptr)
 			{
 				drawer.attached(this);
 				_m_init_pos_and_size(0, rectangle());
@@ -337,6 +337,9 @@ namespace nana{	namespace gui{
 				thread_id = nana::system::this_thread_id();
 				if(agrparent && (thread_id != agrparent->thread_id))
 					thread_id = agrparent->thread_id;
+
+				static std::atomic<std::size_t> last_uid(0);
+				uid = ++last_uid;
 			}
 		//end struct basic_window
 	}//end namespace detail
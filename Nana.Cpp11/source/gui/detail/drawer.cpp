@@ -80,7 +80,7 @@ namespace gui
 
 		//class drawer
 		drawer::drawer()
-			:	core_window_(nullptr), realizer_(nullptr), refreshing_(false)
+			:	core_window_(nullptr), realizer_(nullptr), layer_(nullptr), refreshing_(false)
 		{
 		}
 
@@ -90,6 +90,7 @@ namespace gui
 			{
 				delete p;
 			}
+			delete layer_;
 		}
 
 		void drawer::attached(basic_window* cw)
@@ -101,6 +102,10 @@ namespace gui
 		{
 			if(realizer_)
 				realizer_->typeface_changed(graphics);
+
+			//The sizes of strings are changed.
+			if(layer_)
+				layer_->reset(dynamic_drawing_objects_, graphics);
 		}
 
 		void drawer::click(const eventinfo& ei)
@@ -291,6 +296,16 @@ namespace gui
 		}
 
 		void drawer::map(window wd)	//Copy the root buffer to screen
+		{
+			nana::rectangle vr;
+			if(wd && bedrock_type::window_manager_t::wndlayout_type::read_visual_rectangle(reinterpret_cast<bedrock_type::core_window_t*>(wd), vr))
+				map(wd, vr);
+			else
+				map(wd, nana::rectangle());
+		}
+
+		//Copy the area of the root buffer to screen, the area is in the coordinates of the root window.
+		void drawer::map(window wd, const nana::rectangle& area)
 		{
 			if(wd)
 			{
@@ -312,12 +327,8 @@ namespace gui
 #endif
 				}
 				
-				if(false == edge_nimbus_renderer_t::instance().render(iwd))
-				{
-					nana::rectangle vr;
-					if(bedrock_type::window_manager_t::wndlayout_type::read_visual_rectangle(iwd, vr))
-						iwd->root_graph->paste(iwd->root, vr, vr.x, vr.y);
-				}
+				if((false == edge_nimbus_renderer_t::instance().render(iwd)) && area.width && area.height)
+					iwd->root_graph->paste(iwd->root, area, area.x, area.y);
 				
 				if(owns_caret)
 				{
@@ -379,6 +390,9 @@ namespace gui
 			}
 
 			then.swap(dynamic_drawing_objects_);
+
+			delete layer_;
+			layer_ = nullptr;
 		}
 
 		void* drawer::draw(std::function<void(paint::graphics&)> && f, bool diehard)
@@ -386,7 +400,7 @@ namespace gui
 			if(f)
 			{
 				auto p = new dynamic_drawing::user_draw_function(std::move(f), diehard);
-				dynamic_drawing_objects_.push_back(p);
+				_m_append(p);
 				return (diehard ? p : nullptr);
 			}
 			return nullptr;
@@ -398,7 +412,14 @@ namespace gui
 			{
 				auto i = std::find(dynamic_drawing_objects_.begin(), dynamic_drawing_objects_.end(), p);
 				if(i != dynamic_drawing_objects_.end())
+				{
+					auto obj = *i;
+					const std::size_t pos = i - dynamic_drawing_objects_.begin();
 					dynamic_drawing_objects_.erase(i);
+					if(layer_)
+						layer_->erase(dynamic_drawing_objects_, pos, graphics);
+					delete obj;
+				}
 			}
 		}
 
@@ -406,43 +427,43 @@ namespace gui
 		{
 			if(text)
 			{
-				dynamic_drawing_objects_.push_back(new dynamic_drawing::string(x, y, color, text));
+				_m_append(new dynamic_drawing::string(x, y, color, text));
 			}
 		}
 
 		void drawer::line(int x, int y, int x2, int y2, unsigned color)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::line(x, y, x2, y2, color));
+			_m_append(new dynamic_drawing::line(x, y, x2, y2, color));
 		}
 
 		void drawer::rectangle(int x, int y, unsigned width, unsigned height, unsigned color, bool issolid)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::rectangle(x, y, width, height, color, issolid));
+			_m_append(new dynamic_drawing::rectangle(x, y, width, height, color, issolid));
 		}
 
 		void drawer::shadow_rectangle(int x, int y, unsigned width, unsigned height, nana::color_t beg, nana::color_t end, bool vertical)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::shadow_rectangle(x, y, width, height, beg, end, vertical));
+			_m_append(new dynamic_drawing::shadow_rectangle(x, y, width, height, beg, end, vertical));
 		}
 
 		void drawer::bitblt(int x, int y, unsigned width, unsigned height, const paint::graphics& graph, int srcx, int srcy)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::bitblt(x, y, width, height, graph, srcx, srcy));
+			_m_append(new dynamic_drawing::bitblt(x, y, width, height, graph, srcx, srcy));
 		}
 
 		void drawer::bitblt(int x, int y, unsigned width, unsigned height, const paint::image& img, int srcx, int srcy)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::bitblt_image(x, y, width, height, img, srcx, srcy));
+			_m_append(new dynamic_drawing::bitblt_image(x, y, width, height, img, srcx, srcy));
 		}
 
 		void drawer::stretch(const nana::rectangle & r_dst, const paint::graphics& graph, const nana::rectangle& r_src)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::stretch(r_dst, graph, r_src));
+			_m_append(new dynamic_drawing::stretch(r_dst, graph, r_src));
 		}
 
 		void drawer::stretch(const nana::rectangle & r_dst, const paint::image& img, const nana::rectangle& r_src)
 		{
-			dynamic_drawing_objects_.push_back(new dynamic_drawing::stretch(r_dst, img, r_src));
+			_m_append(new dynamic_drawing::stretch(r_dst, img, r_src));
 		}
 
 		event_handle drawer::make_event(int evtid, window trigger)
@@ -507,8 +528,28 @@ namespace gui
 
 		void drawer::_m_draw_dynamic_drawing_object()
 		{
-			for(auto * dw : dynamic_drawing_objects_)
-				dw->draw(graphics);
+			auto i = dynamic_drawing_objects_.cbegin();
+			if(dynamic_drawing_objects_.size() >= dynamic_drawing::layer::threshold)
+			{
+				if((nullptr == layer_) && (dynamic_drawing::layer::retainable(dynamic_drawing_objects_) >= dynamic_drawing::layer::threshold))
+					layer_ = new dynamic_drawing::layer(dynamic_drawing_objects_, graphics);
+
+				if(layer_)
+				{
+					layer_->render(dynamic_drawing_objects_, graphics);
+					i += layer_->retained();
+				}
+			}
+
+			for(; i != dynamic_drawing_objects_.cend(); ++i)
+				(*i)->draw(graphics);
+		}
+
+		void drawer::_m_append(dynamic_drawing::object* p)
+		{
+			dynamic_drawing_objects_.push_back(p);
+			if(layer_)
+				layer_->append(dynamic_drawing_objects_, graphics);
 		}
 	}//end namespace detail
 }//end namespace gui
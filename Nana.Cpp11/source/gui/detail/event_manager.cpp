@@ -22,79 +22,6 @@ namespace gui
 {
 namespace detail
 {
-	class handle_queue
-	{
-	public:
-		handle_queue()
-			:queue_(fixed_buffer_), size_(0), capacity_(10)
-		{}
-
-		~handle_queue()
-		{
-			if(queue_ != fixed_buffer_)
-				delete [] queue_;
-		}
-
-		void clear()
-		{
-			size_ = 0;
-		}
-
-		template<typename Container>
-		void copy(Container& container)
-		{
-			std::size_t size = container.size();
-
-			//Firstly check whether the capacity is enough for the size
-			if(capacity_ - size_ < size)
-			{
-				capacity_ = size_ + size;
-				abstract_handler* *newbuf = new abstract_handler*[capacity_];
-				memcpy(newbuf, queue_, sizeof(abstract_handler*) * size_);
-				if(queue_ != fixed_buffer_)
-					delete [] queue_;
-				queue_ = newbuf;
-			}
-
-			auto iter = container.cbegin();
-			abstract_handler * *i = queue_ + size_;
-			abstract_handler * * const end = i + size;
-			while(i < end)
-				*i++ = *iter++;
-
-			size_ += size;
-		}
-
-		void invoke(event_manager::handle_manager_type& handle_manager, const eventinfo& ei)
-		{
-			for(auto i = queue_, end = queue_ + size_; i != end; ++i)
-			{
-				if(handle_manager.available(*i))
-					(*i)->exec(ei);
-			}
-		}
-		std::size_t size() const {return size_;}
-	private:
-		abstract_handler * fixed_buffer_[10];
-		abstract_handler** queue_;
-		std::size_t size_;
-		std::size_t capacity_;
-	};//end class handle_queue
-
-	//callback_storage
-	//@brief: This is a class defines a data structure about the event callbacks mapping
-	struct callback_storage
-	{
-		typedef std::map<window, std::pair<std::vector<abstract_handler*>, std::vector<abstract_handler*> > > event_table_type;
-
-		event_table_type table[event_tag::count];
-	};
-
-	namespace nana_runtime
-	{
-		callback_storage callbacks;
-	}
-
 	abstract_handler::~abstract_handler(){}
 
 	std::recursive_mutex event_manager::mutex_;
@@ -123,7 +50,69 @@ namespace detail
 		category::flags::super,		//elapse
 						};
 
+	//struct event_table
+		event_table::event_table()
+			: on_window(false)
+		{
+			for(auto & evt : handlers)
+			{
+				evt[0] = nullptr;
+				evt[1] = nullptr;
+			}
+		}
+	//end struct event_table
+
 	//class event_manager
+		//struct reader_guard
+		//@brief: a reader_guard marks the current thread is dispatching in an epoch. The epoch is read before the
+		//	counter is increased, if the epoch is advanced between them, the thread is counted in the new epoch, it
+		//	is still safe because the arrays that retired in the old epoch are no longer published.
+		struct event_manager::reader_guard
+		{
+			std::atomic<std::size_t> & readers;
+
+			reader_guard(event_manager& evtmgr)
+				: readers(evtmgr.readers_[evtmgr.epoch_.load() & 1])
+			{
+				++readers;
+			}
+
+			~reader_guard()
+			{
+				--readers;
+			}
+		};
+
+		event_manager::event_manager()
+			: epoch_(0), retired_size_(0)
+		{
+			readers_[0] = 0;
+			readers_[1] = 0;
+		}
+
+		event_manager::~event_manager()
+		{
+			for(auto & t : tables_)
+			{
+				for(auto & evt : t.second->handlers)
+				{
+					delete evt[0].load();
+					delete evt[1].load();
+				}
+				delete t.second;
+			}
+
+			for(auto handler : handlers_)
+				delete handler;
+
+			for(auto & r : retired_)
+			{
+				delete r.array;
+				delete r.table;
+				delete r.handler;
+			}
+		}
+
 		//delete a handler
 		void event_manager::umake(event_handle eh)
 		{
@@ -134,25 +123,10 @@ namespace detail
 			//Thread-Safe Required!
 			std::lock_guard<decltype(mutex_)> lock(mutex_);
 
-			if(handle_manager_.available(abs_handler))
+			if(handlers_.count(abs_handler))
 			{
-				write_off_bind(eh);
-
-				auto v = abs_handler->container;
-				auto i = std::find(v->begin(), v->end(), abs_handler);
-				if(i != v->cend())
-				{
-					v->erase(i);
-					if(0 == v->size())
-					{
-						auto & evt = nana_runtime::callbacks.table[abs_handler->event_identifier];
-						auto i_evt = evt.find(abs_handler->window);
-						auto & pair_v  = i_evt->second;
-						if((0 == pair_v.first.size()) && (0 == pair_v.second.size()))
-							evt.erase(i_evt);
-					}
-				}
-				handle_manager_(abs_handler);
+				_m_remove(abs_handler);
+				_m_reclaim();
 			}
 		}
 
@@ -161,34 +135,33 @@ namespace detail
 			//Thread-Safe Required!
 			std::lock_guard<decltype(mutex_)> lock(mutex_);
 
-			auto *end = nana_runtime::callbacks.table + event_tag::count;
-
-			auto deleter_wrapper = [this](abstract_handler * handler)
+			auto i = tables_.find(wd);
+			if(i != tables_.end())
 			{
-				this->write_off_bind(reinterpret_cast<event_handle>(handler));
-				this->handle_manager_(handler);
-			};
-
-			for(auto* i = nana_runtime::callbacks.table; i != end; ++i)
-			{
-				auto element = i->find(wd);
-				if(element != i->end())
+				auto table = i->second;
+				for(auto & evt : table->handlers)
 				{
-					auto & hdpair = element->second;
-					std::for_each(hdpair.first.rbegin(), hdpair.first.rend(), deleter_wrapper);
-					if(only_for_drawer)
-					{
-						if(hdpair.second.size())
-							hdpair.first.clear();
-						else
-							i->erase(element);
-					}
-					else
+					for(int kind = (only_for_drawer ? 0 : 1); kind >= 0; --kind)
 					{
-						std::for_each(hdpair.second.rbegin(), hdpair.second.rend(), deleter_wrapper);
-						i->erase(element);
+						auto arr = evt[kind].load();
+						if(arr)
+						{
+							//_m_remove publishes a new array for every handler, the handlers are removed from the last one.
+							handler_array handlers(*arr);
+							for(auto h = handlers.rbegin(); h != handlers.rend(); ++h)
+								_m_remove(*h);
+						}
 					}
 				}
+
+				if(false == only_for_drawer)
+				{
+					if(table->on_window)
+						reinterpret_cast<basic_window*>(wd)->events = nullptr;
+
+					tables_.erase(i);
+					_m_retire(nullptr, table, nullptr);
+				}
 			}
 
 			if(false == only_for_drawer)
@@ -197,51 +170,83 @@ namespace detail
 				auto bi = bind_cont_.find(wd);
 				if(bi != bind_cont_.end())
 				{
-					for(auto handler : bi->second)
-						handle_manager_(reinterpret_cast<abstract_handler*>(handler));
+					std::vector<event_handle> binds;
+					binds.swap(bi->second);
 					bind_cont_.erase(bi);
+
+					for(auto handler : binds)
+					{
+						auto abs_handler = reinterpret_cast<abstract_handler*>(handler);
+						if(handlers_.count(abs_handler))
+							_m_remove(abs_handler);
+					}
 				}
 			}
+			_m_reclaim();
 		}
 
 		bool event_manager::answer(unsigned eventid, window wd, eventinfo& ei, event_kind evtkind)
 		{
 			if(eventid >= event_tag::count)	return false;
 
-			auto * evtobj = nana_runtime::callbacks.table + eventid;
-			handle_queue queue;
+			reader_guard guard(*this);
+
+			//Both arrays are taken before the handlers are invoked, a handler which is made by an invoked handler
+			//is not invoked for this event.
+			const handler_array * arrays[2] = {nullptr, nullptr};
+			if(event_tag::elapse == eventid)
 			{
-				//Thread-Safe Required!
+				//The elapse event is made for timers which are not windows.
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				auto i = tables_.find(wd);
+				if(i != tables_.end())
+				{
+					arrays[0] = i->second->handlers[eventid][0].load();
+					arrays[1] = i->second->handlers[eventid][1].load();
+				}
+			}
+			else
+			{
+				auto table = reinterpret_cast<basic_window*>(wd)->events.load();
+				if(table)
+				{
+					arrays[0] = table->handlers[eventid][0].load();
+					arrays[1] = table->handlers[eventid][1].load();
+				}
+			}
+
+			if(event_kind::user == evtkind)
+				arrays[0] = nullptr;
+			else if(event_kind::trigger == evtkind)
+				arrays[1] = nullptr;
+
+			ei.identifier = eventid;
+			ei.window = wd;
 
-				auto element = evtobj->find(wd);
-				if(element != evtobj->end()) //Test if the window installed event_id event
+			std::size_t count = 0;
+			for(auto arr : arrays)
+			{
+				if(arr)
 				{
-					//copy all the handlers to the queue to avoiding dead-locking from the callback function that deletes the event handler
-					switch(evtkind)
+					count += arr->size();
+					for(auto handler : *arr)
 					{
-					case event_kind::both:
-						queue.copy(element->second.first);
-						queue.copy(element->second.second);
-						break;
-					case event_kind::trigger:
-						queue.copy(element->second.first);
-						break;
-					case event_kind::user:
-						queue.copy(element->second.second);
-						break;
+						//The handler may be deleted by a handler which is invoked before it.
+						if(handler->alive)
+							handler->exec(ei);
 					}
 				}
 			}
-			ei.identifier = eventid;
-			ei.window = wd;
-			queue.invoke(handle_manager_, ei);
-			return (queue.size() != 0);
+			return (count != 0);
 		}
 
-		void event_manager::remove_trash_handle(unsigned tid)
+		void event_manager::remove_trash_handle(unsigned)
 		{
-			handle_manager_.delete_trash(tid);
+			if(retired_size_)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				_m_reclaim();
+			}
 		}
 
 		void event_manager::write_off_bind(event_handle eh)
@@ -262,20 +267,23 @@ namespace detail
 
 		std::size_t event_manager::size() const
 		{
-			return handle_manager_.size();
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+			return handlers_.size();
 		}
 
 		std::size_t event_manager::the_number_of_handles(window wd, unsigned eventid, bool is_for_drawer)
 		{
 			if(eventid < event_tag::count)
 			{
-				auto* evtobj = nana_runtime::callbacks.table + eventid;
-
 				//Thread-Safe Required!
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				auto element = evtobj->find(wd);
-				if(element != evtobj->end()) //Test if the window installed event_id event
-					return (is_for_drawer ? element->second.first : element->second.second).size();
+				auto i = tables_.find(wd);
+				if(i != tables_.end())
+				{
+					auto arr = i->second->handlers[eventid][is_for_drawer ? 0 : 1].load();
+					if(arr)
+						return arr->size();
+				}
 			}
 			return 0;
 		}
@@ -298,16 +306,20 @@ namespace detail
 			abs_handler->window = wd;
 			abs_handler->listener = listener;
 			abs_handler->event_identifier = eventid;
+			abs_handler->for_drawer = drawer_handler;
+			abs_handler->alive = true;
 
 			{
 				//Thread-Safe Required!
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				abs_handler->container = (drawer_handler ?
-												&(nana_runtime::callbacks.table[eventid][wd].first) :
-												&(nana_runtime::callbacks.table[eventid][wd].second));
 
-				abs_handler->container->push_back(abs_handler);
-				handle_manager_.insert(abs_handler, 0);
+				auto & slot = _m_table(eventid, wd, true)->handlers[eventid][drawer_handler ? 0 : 1];
+				auto arr = slot.load();
+				auto new_arr = (arr ? new handler_array(*arr) : new handler_array);
+				new_arr->push_back(abs_handler);
+				_m_publish(slot, new_arr);
+
+				handlers_.insert(abs_handler);
 
 				if(listener)
 					bind_cont_[listener].push_back(reinterpret_cast<event_handle>(abs_handler));
@@ -320,6 +332,98 @@ namespace detail
 					bedrock::instance().root(reinterpret_cast<bedrock::core_window_t*>(wd)), eventid);
 			return reinterpret_cast<event_handle>(abs_handler);
 		}
+
+		//_m_table
+		//@brief: returns the table of a window, creates it if create is true. Every event except elapse is made for
+		//	a window, the table is referred by the window when such an event is made.
+		event_table* event_manager::_m_table(unsigned eventid, window wd, bool create)
+		{
+			event_table * table = nullptr;
+			auto i = tables_.find(wd);
+			if(i != tables_.end())
+				table = i->second;
+			else if(create)
+			{
+				table = new event_table;
+				tables_[wd] = table;
+			}
+
+			if(table && create && (event_tag::elapse != eventid) && (false == table->on_window))
+			{
+				table->on_window = true;
+				reinterpret_cast<basic_window*>(wd)->events = table;
+			}
+			return table;
+		}
+
+		void event_manager::_m_remove(abstract_handler* abs_handler)
+		{
+			write_off_bind(reinterpret_cast<event_handle>(abs_handler));
+
+			auto table = _m_table(abs_handler->event_identifier, abs_handler->window, false);
+			if(table)
+			{
+				auto & slot = table->handlers[abs_handler->event_identifier][abs_handler->for_drawer ? 0 : 1];
+				auto arr = slot.load();
+				if(arr && (arr->cend() != std::find(arr->cbegin(), arr->cend(), abs_handler)))
+				{
+					handler_array * new_arr = nullptr;
+					if(arr->size() > 1)
+					{
+						new_arr = new handler_array;
+						new_arr->reserve(arr->size() - 1);
+						for(auto handler : *arr)
+						{
+							if(handler != abs_handler)
+								new_arr->push_back(handler);
+						}
+					}
+					_m_publish(slot, new_arr);
+				}
+			}
+
+			abs_handler->alive = false;
+			handlers_.erase(abs_handler);
+			_m_retire(nullptr, nullptr, abs_handler);
+		}
+
+		void event_manager::_m_publish(std::atomic<const handler_array*>& slot, handler_array* arr)
+		{
+			auto old = slot.exchange(arr);
+			if(old)
+				_m_retire(old, nullptr, nullptr);
+		}
+
+		void event_manager::_m_retire(const handler_array* arr, event_table* table, abstract_handler* handler)
+		{
+			retired_t r = {epoch_.load(), arr, table, handler};
+			retired_.push_back(r);
+			retired_size_ = retired_.size();
+		}
+
+		//_m_reclaim
+		//@brief: deletes the objects that retired before the current epoch if no thread is dispatching in the
+		//	previous epoch, then advances the epoch if there are objects retired in the current epoch. It is called
+		//	in the lock, and it never waits for the dispatching threads.
+		void event_manager::_m_reclaim()
+		{
+			const unsigned epoch = epoch_.load();
+			if(readers_[(epoch - 1) & 1].load())
+				return;
+
+			auto i = std::partition(retired_.begin(), retired_.end(), [epoch](const retired_t& r){ return (r.epoch == epoch); });
+			for(auto u = i; u != retired_.end(); ++u)
+			{
+				delete u->array;
+				delete u->table;
+				delete u->handler;
+			}
+			retired_.erase(i, retired_.end());
+			retired_size_ = retired_.size();
+
+			if(retired_.size())
+				epoch_ = epoch + 1;
+		}
 	//end class event_manager
 }//mespace detail
 }//end namespace gui
@@ -173,6 +173,11 @@ namespace detail
 	//	::PostMessage(reinterpret_cast<HWND>(wnd->root), gui::messages::map_thread_root_buffer, reinterpret_cast<WPARAM>(wnd), 0);
 	}
 
+	std::shared_ptr<post_channel> bedrock::channel(core_window_t* wd)
+	{
+		return nana::detail::platform_spec::instance().msg_channel(wd->root);
+	}
+
 	//inc_window
 	//@biref: increament the number of windows
 	int bedrock::inc_window(unsigned tid)
@@ -17,6 +17,7 @@
 #include <nana/system/platform.hpp>
 #include <sstream>
 #include <nana/system/timepiece.hpp>
+#include <nana/gui/detail/task_queue.hpp>
 
 #ifndef WM_MOUSEWHEEL
 #define WM_MOUSEWHEEL	0x020A
@@ -131,6 +132,39 @@ namespace detail
 	};
 #pragma pack()
 
+	//class thread_channel
+	//@brief: The channel of the tasks posted to a thread, the thread is woken by a post_task msg to one of its
+	//	root windows. The window is replaced when it is destroyed, and the channel is rearmed, because the msg
+	//	which is posted to the destroyed window is lost.
+	class thread_channel
+		: public post_channel
+	{
+	public:
+		thread_channel()
+			: window_(nullptr)
+		{}
+
+		HWND window() const
+		{
+			return window_;
+		}
+
+		void window(HWND wd)
+		{
+			window_ = wd;
+			rearm();
+		}
+	private:
+		bool wake()
+		{
+			//It fails if the window is destroyed or the msg queue of the thread is full.
+			HWND wd = window_;
+			return (wd && ::PostMessage(wd, nana::detail::messages::post_task, 0, 0));
+		}
+	private:
+		std::atomic<HWND> window_;
+	};
+
 	struct bedrock::thread_context
 	{
 		unsigned	event_pump_ref_count;
@@ -148,8 +182,10 @@ namespace detail
 			nana::gui::cursor	predef_cursor;
 		}cursor;
 
+		std::shared_ptr<thread_channel>	channel;	//The tasks which are posted by other threads.
+
 		thread_context()
-			: event_pump_ref_count(0), window_count(0), event_window(nullptr)
+			: event_pump_ref_count(0), window_count(0), event_window(nullptr), channel(std::make_shared<thread_channel>())
 		{
 			cursor.window = nullptr;
 			cursor.predef_cursor = nana::gui::cursor::arrow;
@@ -324,7 +360,13 @@ namespace detail
 			impl_->cache.tcontext.object = nullptr;
 		}
 
-		impl_->thr_contexts.erase(tid);
+		auto i = impl_->thr_contexts.find(tid);
+		if(i != impl_->thr_contexts.end())
+		{
+			//The tasks which are posted later are discarded.
+			i->second.channel->close();
+			impl_->thr_contexts.erase(i);
+		}
 	}
 
 	bedrock& bedrock::instance()
@@ -337,6 +379,20 @@ namespace detail
 		::PostMessage(reinterpret_cast<HWND>(wd->root), nana::detail::messages::map_thread_root_buffer, reinterpret_cast<WPARAM>(wd), 0);
 	}
 
+	std::shared_ptr<post_channel> bedrock::channel(core_window_t* wd)
+	{
+		std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+		auto i = impl_->thr_contexts.find(wd->thread_id);
+		if(i == impl_->thr_contexts.end())
+			return nullptr;
+
+		//The channel wakes the thread by the root window of wd until the window is destroyed.
+		auto & chn = i->second.channel;
+		if(nullptr == chn->window())
+			chn->window(reinterpret_cast<HWND>(wd->root));
+		return chn;
+	}
+
 	void interior_helper_for_menu(MSG& msg, native_window_type menu_window)
 	{
 		switch(msg.message)
@@ -513,6 +569,13 @@ namespace detail
 		case nana::detail::messages::async_set_focus:
 			::SetFocus(wd);
 			return true;
+		case nana::detail::messages::post_task:
+			{
+				auto context = bedrock.get_thread_context();
+				if(context)
+					context->channel->run();
+			}
+			return true;
 		case nana::detail::messages::operate_caret:
 			//Refer to basis.hpp for this specification.
 			switch(wParam)
@@ -1331,6 +1394,25 @@ namespace detail
 				bedrock.rt_manager.remove_if_exists(msgwnd);
 				bedrock.wd_manager.destroy_handle(msgwnd);
 
+				if(context.channel->window() == root_window)
+				{
+					//The post_task msg which is posted to this window is lost, another root window of the thread
+					//receives the msgs, and the channel is woken again.
+					const unsigned tid = nana::system::this_thread_id();
+					HWND next = nullptr;
+					std::vector<bedrock::core_window_t*> roots;
+					bedrock.wd_manager.all_handles(roots);
+					for(auto wd : roots)
+					{
+						if((wd->thread_id == tid) && (wd->root != native_window))
+						{
+							next = reinterpret_cast<HWND>(wd->root);
+							break;
+						}
+					}
+					context.channel->window(next);
+				}
+
 				if(--context.window_count <= 0)
 				{
 					::PostQuitMessage(0);
@@ -521,7 +521,7 @@ namespace detail
 
 		//show
 		//@brief: show or hide a window
-		bool window_manager::show(core_window_t* wd, bool visible)
+		bool window_manager::show(core_window_t* wd, bool visible, bool deferred)
 		{
 			//Thread-Safe Required!
 			std::lock_guard<decltype(mutex_)> lock(mutex_);
@@ -546,7 +546,17 @@ namespace detail
 					//Don't set the visible attr of a window if it is a root.
 					//The visible attr of a root will be set in the expose event.
 					if(category::root_tag::value != wd->other.category)
-						bedrock::instance().event_expose(wd, visible);
+					{
+						if(deferred)
+						{
+							eventinfo ei;
+							ei.exposed = visible;
+							wd->visible = visible;
+							bedrock::raise_event(event_tag::expose, wd, ei, false);
+						}
+						else
+							bedrock::instance().event_expose(wd, visible);
+					}
 
 					if(nv)
 						native_interface::show_window(nv, visible, wd->flags.take_active);
@@ -857,6 +867,62 @@ namespace detail
 			return true;
 		}
 
+		//update
+		//@brief:	Displays the windows without refreshing them. Every window is composed into the buffer of its root
+		//			window, and then the area covered by the windows of a root window is copied to the screen at once.
+		void window_manager::update(const std::vector<core_window_t*>& wds)
+		{
+			//Thread-Safe Required!
+			std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+			std::vector<std::pair<core_window_t*, nana::rectangle>> roots;
+			for(auto wd : wds)
+			{
+				if((nullptr == wd) || (false == handle_manager_.available(wd)) || (false == wd->visible))
+					continue;
+
+				core_window_t* pnt = wd->parent;
+				while(pnt && pnt->visible)
+					pnt = pnt->parent;
+
+				if(pnt)	continue;
+
+				wndlayout_type::paint(wd, false, false);
+
+				nana::rectangle vr;
+				if(false == wndlayout_type::read_visual_rectangle(wd, vr))
+					continue;
+
+				auto i = std::find_if(roots.begin(), roots.end(), [wd](const std::pair<core_window_t*, nana::rectangle>& r){ return (r.first == wd->root_widget); });
+				if(i == roots.end())
+				{
+					roots.emplace_back(wd->root_widget, vr);
+					continue;
+				}
+
+				//The area to be copied is the bounding rectangle of the visual rectangles.
+				auto & area = i->second;
+				const int right = std::max(area.x + static_cast<int>(area.width), vr.x + static_cast<int>(vr.width));
+				const int bottom = std::max(area.y + static_cast<int>(area.height), vr.y + static_cast<int>(vr.height));
+				area.x = std::min(area.x, vr.x);
+				area.y = std::min(area.y, vr.y);
+				area.width = static_cast<unsigned>(right - area.x);
+				area.height = static_cast<unsigned>(bottom - area.y);
+			}
+
+			for(auto & r : roots)
+			{
+#if defined(NANA_LINUX)
+				r.first->drawer.map(reinterpret_cast<window>(r.first), r.second);
+#elif defined(NANA_WINDOWS)
+				if(nana::system::this_thread_id() == r.first->thread_id)
+					r.first->drawer.map(reinterpret_cast<window>(r.first), r.second);
+				else
+					bedrock::instance().map_thread_root_buffer(r.first);
+#endif
+			}
+		}
+
 		void window_manager::refresh_tree(core_window_t* wd)
 		{
 			if(wd == nullptr)	return;
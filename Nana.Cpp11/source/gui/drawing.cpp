@@ -90,7 +90,7 @@ namespace gui
 
 		void drawing::erase(diehard_t d)
 		{
-			if(API::empty_window(handle_))
+			if(false == API::empty_window(handle_))
 				restrict::get_drawer(handle_).erase(d);
 		}
 
@@ -7,6 +7,11 @@ namespace nana{	namespace gui{
 		bground_interface::~bground_interface()
 		{}
 
+		std::size_t bground_interface::reach() const
+		{
+			return static_cast<std::size_t>(-1);
+		}
+
 		bground_factory_interface::~bground_factory_interface()
 		{}
 
@@ -29,6 +34,11 @@ namespace nana{	namespace gui{
 					nana::color_t color = API::background(wd);
 					graph.blend(graph.size(), color, fade_rate_);
 				}
+
+				std::size_t reach() const
+				{
+					return 0;
+				}
 			private:
 				const double fade_rate_;
 			};
@@ -45,6 +55,11 @@ namespace nana{	namespace gui{
 				{
 					graph.blur(graph.size(), radius_);
 				}
+
+				std::size_t reach() const
+				{
+					return radius_;
+				}
 			private:
 				const std::size_t radius_;
 			};
@@ -14,7 +14,16 @@
 	#include <nana/filesystem/file_iterator.hpp>
 	#include <nana/gui/place.hpp>
 	#include <nana/gui/functional.hpp>
+	#include <nana/gui/timer.hpp>
+	#include <nana/gui/detail/fs_cache.hpp>
 	#include <stdexcept>
+	#include <algorithm>
+	#include <chrono>
+	#include <atomic>
+	#include <thread>
+	#include <mutex>
+	#include <ctime>
+	#include <cstring>
 #endif
 
 namespace nana{	namespace gui
@@ -23,12 +32,154 @@ namespace nana{	namespace gui
 	class filebox_implement
 		: public form
 	{
-		struct item_fs
+		typedef gui::detail::item_fs item_fs;
+		typedef gui::detail::fs_cache fs_cache;
+
+		//class fs_scanner
+		//	The fs_scanner enumerates a directory in a worker thread. The type of an entry is known without a stat,
+		//	so the names are delivered first, in batches of the entries which are read in a period, then the entries
+		//	are stated and the sizes and times are delivered. The batches are taken by a timer in the GUI thread.
+		//	The receiver inserts the directories of a batch before the first file, so the listing is the delivered
+		//	directories followed by the delivered files, and the details are indexed in this order.
+		class fs_scanner
+			: nana::noncopyable
 		{
-			nana::string name;
-			::tm modified_time;
-			bool directory;
-			nana::long_long_t bytes;
+		public:
+			struct detail_t
+			{
+				std::size_t index;	//The position of the entry in the listing, the directories come first.
+				nana::long_long_t bytes;
+				::tm modified_time;
+			};
+
+			fs_scanner(const nana::string& path)
+				: path_(path), canceled_(false), finished_(false)
+			{
+				thread_ = std::thread([this]{ this->_m_run(); });
+			}
+
+			~fs_scanner()
+			{
+				canceled_ = true;
+				if(thread_.joinable())
+					thread_.join();
+			}
+
+			//Takes the delivered entries, returns false if the scan is finished and all the entries are taken.
+			bool take(std::vector<item_fs>& found, std::vector<detail_t>& details)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				found.swap(found_);
+				details.swap(details_);
+				return !(finished_ && found.empty() && details.empty());
+			}
+		private:
+			void _m_run()
+			{
+				typedef std::chrono::steady_clock clock;
+				const auto period = std::chrono::milliseconds(40);
+
+				//Phase 1: enumerate the names.
+				std::vector<nana::string> names, file_names;
+				std::vector<item_fs> batch;
+				auto flushed = clock::now();
+
+				nana::filesystem::file_iterator end;
+				for(nana::filesystem::file_iterator i(path_, false); i != end; ++i)
+				{
+					if(canceled_)
+					{
+						_m_finish();
+						return;
+					}
+
+					if((i->name.size() == 0) || (i->name[0] == STR('.')))
+						continue;
+
+					item_fs m;
+					m.name = i->name;
+					m.directory = i->directory;
+					m.bytes = 0;
+					m.detailed = false;
+					std::memset(&m.modified_time, 0, sizeof(m.modified_time));
+					batch.push_back(m);
+
+					if(clock::now() - flushed >= period)
+					{
+						_m_deliver(batch, names, file_names);
+						flushed = clock::now();
+					}
+				}
+				_m_deliver(batch, names, file_names);
+				names.insert(names.end(), file_names.begin(), file_names.end());
+
+				//Phase 2: stat the entries in the order of the listing.
+				std::string file = nana::charset(path_);
+				if(file.size() && file[file.size() - 1] != '/')
+					file += '/';
+				const std::size_t path_size = file.size();
+
+				std::vector<detail_t> details;
+				for(std::size_t i = 0; i < names.size(); ++i)
+				{
+					if(canceled_)
+					{
+						_m_finish();
+						return;
+					}
+
+					file.resize(path_size);
+					file += static_cast<std::string>(nana::charset(names[i]));
+
+					struct stat fst;
+					if(0 == ::stat(file.c_str(), &fst))
+					{
+						detail_t dt;
+						dt.index = i;
+						dt.bytes = fst.st_size;
+						::localtime_r(&fst.st_ctime, &dt.modified_time);
+						details.push_back(dt);
+					}
+
+					if(details.size() && (clock::now() - flushed >= period))
+					{
+						std::lock_guard<decltype(mutex_)> lock(mutex_);
+						details_.insert(details_.end(), details.begin(), details.end());
+						details.clear();
+						flushed = clock::now();
+					}
+				}
+
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				details_.insert(details_.end(), details.begin(), details.end());
+				finished_ = true;
+			}
+
+			void _m_deliver(std::vector<item_fs>& batch, std::vector<nana::string>& dir_names, std::vector<nana::string>& file_names)
+			{
+				for(auto & m : batch)
+					(m.directory ? dir_names : file_names).push_back(m.name);
+
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				found_.insert(found_.end(), batch.begin(), batch.end());
+				batch.clear();
+			}
+
+			void _m_finish()
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				finished_ = true;
+			}
+		private:
+			const nana::string path_;
+			std::atomic<bool> canceled_;
+
+			std::mutex mutex_;
+			std::vector<item_fs> found_;
+			std::vector<detail_t> details_;
+			bool finished_;
+
+			std::thread thread_;
 		};
 
 		class fs_resolver: public listbox::resolver_interface<item_fs>
@@ -46,6 +197,7 @@ namespace nana{	namespace gui
 				case 0:
 					return item.name;
 				case 1:
+					if(item.detailed)
 					{
 						std::stringstream ss;
 						ss<<(item.modified_time.tm_year + 1900)<<'-';
@@ -57,6 +209,7 @@ namespace nana{	namespace gui
 						_m_stream2(ss, item.modified_time.tm_sec);
 						return nana::charset(ss.str());
 					}
+					return nana::string();
 				case 2:
 					if(false == item.directory)
 					{
@@ -67,7 +220,7 @@ namespace nana{	namespace gui
 					}
 					return STR("Directory");
 				case 3:
-					if(false == item.directory)
+					if(item.detailed && (false == item.directory))
 						return _m_trans(item.bytes);
 					return nana::string();
 				}
@@ -115,14 +268,6 @@ namespace nana{	namespace gui
 				
 			}
 		};
-		
-		struct pred_sort_fs
-		{
-			bool operator()(const item_fs& a, const item_fs& b) const
-			{
-				return ((a.directory != b.directory) && a.directory);
-			}
-		};
 	public:
 		struct kind
 		{
@@ -133,7 +278,7 @@ namespace nana{	namespace gui
 	public:
 
 		filebox_implement(window owner, bool io_read, const nana::string& title)
-			: form(owner, API::make_center(owner, 630, 440)), io_read_(io_read)
+			: form(owner, API::make_center(owner, 630, 440)), io_read_(io_read), listener_(fs_cache::instance().listen())
 		{
 			path_.create(*this);
 			path_.splitstr(STR("/"));
@@ -245,6 +390,13 @@ namespace nana{	namespace gui
 			btn_cancel_.caption(STR("&Cancel"));
 			btn_cancel_.make_event<events::click>(destroy(*this));
 
+			scan_timer_.interval(20);
+			scan_timer_.make_tick([this]{ _m_take_scan(); });
+			scan_timer_.enable(false);
+
+			watch_timer_.interval(250);
+			watch_timer_.make_tick([this]{ _m_watch(); });
+
 			selection_.type = kind::none;
 			_m_layout();
 			_m_init_tree();
@@ -255,6 +407,11 @@ namespace nana{	namespace gui
 				caption(title);
 		}
 
+		~filebox_implement()
+		{
+			fs_cache::instance().unlisten(listener_);
+		}
+
 		void def_extension(const nana::string& ext)
 		{
 			def_ext_ = ext;
@@ -421,36 +578,216 @@ namespace nana{	namespace gui
 			if(addr_.filesystem.size() && addr_.filesystem[addr_.filesystem.size() - 1] != STR('/'))
 				addr_.filesystem += STR('/');
 
+			//The previous scan is canceled.
+			scanner_.reset();
+			scan_changes_.clear();
 			file_container_.clear();
 
-			using namespace nana::filesystem;
-			attribute fattr;
-			file_iterator end;
-			for(file_iterator i(path); i != end; ++i)
+			auto & cache = fs_cache::instance();
+			if(cache.fetch(addr_.filesystem, file_container_))
+			{
+				for(auto & fs : file_container_)
+				{
+					if(fs.directory)
+						path_.childset(fs.name, 0);
+				}
+				scan_timer_.enable(false);
+				return;
+			}
+
+			//The entries are delivered by the scanner.
+			cache.watch(addr_.filesystem);
+			scanner_.reset(new fs_scanner(path));
+			scan_timer_.enable(true);
+		}
+
+		//Applies the changes of the directories to the current view.
+		void _m_watch()
+		{
+			std::vector<fs_cache::change> changes;
+			fs_cache::instance().poll(listener_, changes);
+
+			for(auto & ch : changes)
 			{
-				if((i->name.size() == 0) || (i->name[0] == STR('.')))
+				if(ch.path != addr_.filesystem)
 					continue;
-				item_fs m;
-				m.name = i->name;
-				if(file_attrib(path + m.name, fattr))
+
+				if(ch.name.empty())
 				{
-					m.bytes = fattr.bytes;
-					m.directory = fattr.is_directory;
-					m.modified_time = fattr.modified;
+					//The whole directory is changed, it is scanned again.
+					_m_load_path(addr_.filesystem);
+					_m_list_fs();
+					return;
 				}
+
+				//The changes are applied after the scan is finished, because the scanner may deliver the entry.
+				if(scanner_)
+					scan_changes_.push_back(ch.name);
 				else
+					_m_apply_change(ch.name);
+			}
+		}
+
+		void _m_apply_change(const nana::string& name)
+		{
+			item_fs m;
+			const bool exists = fs_cache::stat_entry(addr_.filesystem, name, m);
+
+			auto i = std::find_if(file_container_.begin(), file_container_.end(), [&name](const item_fs& fs){ return (fs.name == name); });
+			if(i != file_container_.end())
+			{
+				const std::size_t index = i - file_container_.begin();
+				const std::size_t pos = listed_[index];
+
+				if(i->directory && !(exists && m.directory))
+					path_.childset_erase(name);
+
+				if(exists && (i->directory == m.directory))
 				{
-					m.bytes = 0;
-					m.directory = i->directory;
-					modified_file_time(path + i->name, m.modified_time);
+					*i = m;
+					if(m.directory)
+						path_.childset(name, 0);
+
+					if(pos != npos)
+						ls_file_.at(0, pos).resolve_from(m).value(m);
+					return;
+				}
+
+				//The entry is removed, or it is replaced by another type and inserted again below.
+				file_container_.erase(i);
+				listed_.erase(listed_.begin() + index);
+				if(pos != npos)
+				{
+					ls_file_.erase(ls_file_.at(0, pos));
+					for(auto & p : listed_)
+					{
+						if((p != npos) && (p > pos))
+							--p;
+					}
 				}
+			}
 
-				file_container_.push_back(m);
+			if(exists)
+				_m_insert_fs(std::vector<item_fs>(1, m));
+		}
 
-				if(m.directory)
-					path_.childset(m.name, 0);
+		//Inserts the entries into the listing and the listbox, the directories are inserted before the first file,
+		//so that the directories come first in the whole listing rather than in every batch of the scanner.
+		void _m_insert_fs(const std::vector<item_fs>& entries)
+		{
+			nana::string filter = filter_.caption();
+			auto ext_types = cb_types_.anyobj<std::vector<nana::string> >(cb_types_.option());
+			auto cat = ls_file_.at(0);
+
+			std::vector<item_fs> dirs;
+			std::size_t dirs_listed = 0;
+			for(auto & fs : entries)
+			{
+				if(fs.directory)
+				{
+					dirs.push_back(fs);
+					path_.childset(fs.name, 0);
+					if(_m_filter_allowed(fs.name, true, filter, ext_types))
+						++dirs_listed;
+				}
+			}
+
+			if(dirs.size())
+			{
+				//The position of the first file in the listing, and the position of the first file in the listbox.
+				const std::size_t first_file = std::partition_point(file_container_.begin(), file_container_.end(), [](const item_fs& fs){ return fs.directory; }) - file_container_.begin();
+				std::size_t listed_pos = cat.size() - std::count_if(listed_.begin() + first_file, listed_.end(), [](std::size_t pos){ return (pos != npos); });
+
+				//The listed files are moved back by the listed directories.
+				if(dirs_listed)
+				{
+					for(auto & p : listed_)
+					{
+						if((p != npos) && (p >= listed_pos))
+							p += dirs_listed;
+					}
+				}
+
+				file_container_.insert(file_container_.begin() + first_file, dirs.begin(), dirs.end());
+				listed_.insert(listed_.begin() + first_file, dirs.size(), npos);
+				for(std::size_t i = 0; i < dirs.size(); ++i)
+				{
+					auto & fs = dirs[i];
+					if(_m_filter_allowed(fs.name, true, filter, ext_types))
+					{
+						listed_[first_file + i] = listed_pos;
+						ls_file_.insert(0, listed_pos, fs.name);
+						cat.at(listed_pos).resolve_from(fs).value(fs);
+						++listed_pos;
+					}
+				}
+			}
+
+			for(auto & fs : entries)
+			{
+				if(fs.directory)
+					continue;
+
+				file_container_.push_back(fs);
+				listed_.push_back(npos);
+				if(_m_filter_allowed(fs.name, false, filter, ext_types))
+				{
+					listed_.back() = cat.size();
+					cat.append(fs).value(fs);
+				}
+			}
+		}
+
+		//Takes the entries and details which are delivered by the scanner.
+		void _m_take_scan()
+		{
+			if(nullptr == scanner_)
+				return;
+
+			std::vector<item_fs> found;
+			std::vector<fs_scanner::detail_t> details;
+			if(false == scanner_->take(found, details))
+			{
+				scanner_.reset();
+				scan_timer_.enable(false);
+
+				for(auto & name : scan_changes_)
+					_m_apply_change(name);
+				scan_changes_.clear();
+
+				fs_cache::instance().store(addr_.filesystem, file_container_);
+				return;
 			}
-			std::sort(file_container_.begin(), file_container_.end(), pred_sort_fs());
+
+			if(found.empty() && details.empty())
+				return;
+
+			ls_file_.auto_draw(false);
+			if(found.size())
+				_m_insert_fs(found);
+
+			if(details.size())
+			{
+				fs_resolver resolver;
+				const listbox::resolver_interface<item_fs> & res = resolver;
+				auto cat = ls_file_.at(0);
+				for(auto & dt : details)
+				{
+					auto & fs = file_container_[dt.index];
+					fs.bytes = dt.bytes;
+					fs.modified_time = dt.modified_time;
+					fs.detailed = true;
+
+					if(listed_[dt.index] != npos)
+					{
+						auto item = cat.at(listed_[dt.index]);
+						item.value(fs);
+						item.text(1, res.decode(1, fs));
+						item.text(3, res.decode(3, fs));
+					}
+				}
+			}
+			ls_file_.auto_draw(true);
 		}
 
 		void _m_load_cat_path(nana::string path)
@@ -540,10 +877,13 @@ namespace nana{	namespace gui
 
 			std::vector<nana::string>* ext_types = cb_types_.anyobj<std::vector<nana::string> >(cb_types_.option());
 			auto cat = ls_file_.at(0);
-			for(auto & fs: file_container_)
+			listed_.assign(file_container_.size(), npos);
+			for(std::size_t i = 0; i < file_container_.size(); ++i)
 			{
+				auto & fs = file_container_[i];
 				if(_m_filter_allowed(fs.name, fs.directory, filter, ext_types))
 				{
+					listed_[i] = cat.size();
 					cat.append(fs).value(fs);
 				}
 			}
@@ -822,6 +1162,13 @@ namespace nana{	namespace gui
 		}nodes_;
 
 		std::vector<item_fs> file_container_;
+		std::vector<std::size_t> listed_;	//The positions of file_container_ in the listbox, npos if it is filtered out.
+		std::unique_ptr<fs_scanner> scanner_;
+		timer scan_timer_;
+		std::vector<nana::string> scan_changes_;	//The changes of the directory which are reported during the scan.
+		timer watch_timer_;
+		const std::size_t listener_;	//The identifier of the filebox in the fs_cache.
+
 		struct path_tag
 		{
 			nana::string filesystem;
@@ -0,0 +1,359 @@
+/*
+ *	An Asynchronous Image Loader Implementation
+ *	Copyright(C) 2003-2013 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/gui/image_loader.cpp
+ */
+
+#include <nana/gui/image_loader.hpp>
+#include <nana/gui/programming_interface.hpp>
+#include <nana/threads/pool.hpp>
+#include <vector>
+#include <algorithm>
+
+#if defined(NANA_MINGW) && defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_mutex.hpp>
+#else
+	#include <mutex>
+#endif
+
+namespace nana{	namespace gui
+{
+	//struct image_loader::request
+	//	The members are protected by the mutex of the loader, except file and handler which are immutable.
+	struct image_loader::request
+	{
+		std::weak_ptr<implement> owner;
+		const nana::string file;
+		const complete_handler handler;
+		image_loader::priority prior;
+		std::size_t sequence;
+		image_loader::state status;
+		paint::image image;
+
+		request(const std::shared_ptr<implement>& owner, const nana::string& file, image_loader::priority prior, const complete_handler& handler)
+			: owner(owner), file(file), handler(handler), prior(prior), sequence(0), status(image_loader::state::pending)
+		{}
+	};
+
+	//struct image_loader::implement
+	//	Every load pushes a task into the pool, the task decodes the pending request with the highest priority
+	//	rather than the request which pushed it, so that the visible images are decoded first. The first request which
+	//	is finished after a delivery posts the next delivery to the GUI thread of the owner, then the requests finished
+	//	before it is run are delivered together.
+	struct image_loader::implement
+		: std::enable_shared_from_this<implement>
+	{
+		mutable std::recursive_mutex mutex;
+		std::vector<std::shared_ptr<request>> pending;
+		std::vector<std::shared_ptr<request>> decoding;
+		std::vector<std::shared_ptr<request>> finished;
+		std::size_t outstanding;
+		std::size_t sequence;
+
+		paint::image placeholder_image;
+		color_t placeholder_color;
+
+		API::post_target deliverer;
+		threads::pool pool;
+
+		implement(window owner, std::size_t threads)
+			: outstanding(0), sequence(0), placeholder_color(0xF0F0F0), deliverer(owner), pool(threads)
+		{}
+
+		void push(const std::shared_ptr<request>& req)
+		{
+			{
+				std::lock_guard<decltype(mutex)> lock(mutex);
+				req->sequence = sequence++;
+				pending.push_back(req);
+				++outstanding;
+			}
+
+			std::weak_ptr<implement> self = shared_from_this();
+			pool.push([self]
+			{
+				auto impl = self.lock();
+				if(impl)
+					impl->decode();
+			});
+		}
+
+		//Runs in a worker thread of the pool.
+		void decode()
+		{
+			std::shared_ptr<request> req;
+			{
+				std::lock_guard<decltype(mutex)> lock(mutex);
+				if(pending.empty())
+					return;
+
+				auto i = std::max_element(pending.begin(), pending.end(), [](const std::shared_ptr<request>& a, const std::shared_ptr<request>& b)
+				{
+					if(a->prior != b->prior)
+						return (a->prior < b->prior);
+					return (a->sequence > b->sequence);	//The earlier request goes first.
+				});
+
+				req = *i;
+				pending.erase(i);
+				decoding.push_back(req);
+				req->status = state::decoding;
+			}
+
+			paint::image img;
+			const bool good = img.open(req->file);
+
+			bool post_delivery = false;
+			{
+				std::lock_guard<decltype(mutex)> lock(mutex);
+				decoding.erase(std::find(decoding.begin(), decoding.end(), req));
+				if(state::canceled != req->status)
+				{
+					req->status = (good ? state::ready : state::failed);
+					if(good)
+						req->image = img;
+					post_delivery = finished.empty();
+					finished.push_back(req);
+				}
+			}
+
+			if(post_delivery)
+			{
+				//The task holds a weak reference, it may be run after the loader is destroyed.
+				std::weak_ptr<implement> self = shared_from_this();
+				deliverer.post([self]
+				{
+					auto impl = self.lock();
+					if(impl)
+						impl->deliver();
+				});
+			}
+		}
+
+		//Runs in the GUI thread.
+		void deliver()
+		{
+			std::vector<std::shared_ptr<request>> done;
+			{
+				std::lock_guard<decltype(mutex)> lock(mutex);
+				done.swap(finished);
+				outstanding -= done.size();
+			}
+
+			for(auto & req : done)
+			{
+				if(req->handler)
+					req->handler(req->image);
+			}
+		}
+
+		void cancel(request& req)
+		{
+			std::lock_guard<decltype(mutex)> lock(mutex);
+			switch(req.status)
+			{
+			case state::pending:
+				pending.erase(std::find_if(pending.begin(), pending.end(), [&req](const std::shared_ptr<request>& p){ return (p.get() == &req); }));
+				--outstanding;
+				break;
+			case state::decoding:
+				--outstanding;
+				break;
+			case state::ready:
+			case state::failed:
+				{
+					//It is finished but not delivered yet.
+					auto i = std::find_if(finished.begin(), finished.end(), [&req](const std::shared_ptr<request>& p){ return (p.get() == &req); });
+					if(i == finished.end())
+						return;
+					finished.erase(i);
+					--outstanding;
+				}
+				break;
+			case state::canceled:
+				return;
+			}
+			req.status = state::canceled;
+			req.image.close();
+		}
+
+		void cancel_all()
+		{
+			std::lock_guard<decltype(mutex)> lock(mutex);
+			for(auto & req : pending)
+				req->status = state::canceled;
+			for(auto & req : decoding)
+				req->status = state::canceled;
+			for(auto & req : finished)
+			{
+				req->status = state::canceled;
+				req->image.close();
+			}
+			pending.clear();
+			finished.clear();
+
+			//The requests being decoded are discarded when they are finished.
+			outstanding = 0;
+		}
+	};
+
+	//class image_loader::ticket
+		image_loader::ticket::ticket()
+		{}
+
+		bool image_loader::ticket::empty() const
+		{
+			return (nullptr == request_);
+		}
+
+		image_loader::state image_loader::ticket::status() const
+		{
+			if(nullptr == request_)
+				return state::canceled;
+
+			auto impl = request_->owner.lock();
+			if(nullptr == impl)
+				return request_->status;
+
+			std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+			return request_->status;
+		}
+
+		paint::image image_loader::ticket::image() const
+		{
+			if(request_)
+			{
+				auto impl = request_->owner.lock();
+				if(impl)
+				{
+					std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+					return request_->image;
+				}
+				return request_->image;
+			}
+			return paint::image();
+		}
+
+		void image_loader::ticket::priority(image_loader::priority prior)
+		{
+			if(request_)
+			{
+				auto impl = request_->owner.lock();
+				if(impl)
+				{
+					std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+					request_->prior = prior;
+				}
+			}
+		}
+
+		void image_loader::ticket::cancel()
+		{
+			if(request_)
+			{
+				auto impl = request_->owner.lock();
+				if(impl)
+					impl->cancel(*request_);
+			}
+		}
+
+		void image_loader::ticket::draw(paint::graphics& graph, const nana::rectangle& r) const
+		{
+			if(nullptr == request_ || graph.empty())
+				return;
+
+			paint::image img;
+			paint::image placeholder;
+			color_t color = 0xF0F0F0;
+			{
+				auto impl = request_->owner.lock();
+				if(impl)
+				{
+					std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+					img = request_->image;
+					placeholder = impl->placeholder_image;
+					color = impl->placeholder_color;
+				}
+				else
+					img = request_->image;
+			}
+
+			if(img.empty())
+			{
+				if(placeholder.empty())
+				{
+					graph.rectangle(r, color, true);
+					return;
+				}
+				img = placeholder;
+			}
+
+			const nana::size imgsz = img.size();
+			if(imgsz.width == r.width && imgsz.height == r.height)
+				img.paste(graph, r.x, r.y);
+			else
+				img.stretch(nana::rectangle(imgsz), graph, r);
+		}
+	//end class image_loader::ticket
+
+	//class image_loader
+		image_loader::image_loader(window owner)
+			: impl_(std::make_shared<implement>(owner, 4))
+		{}
+
+		image_loader::image_loader(window owner, std::size_t threads)
+			: impl_(std::make_shared<implement>(owner, threads ? threads : 1))
+		{}
+
+		image_loader::~image_loader()
+		{
+			impl_->cancel_all();
+
+			//Wait for the workers, so that the implementation is not destroyed in a worker thread.
+			impl_->pool.wait_for_finished();
+		}
+
+		auto image_loader::load(const nana::string& file, priority prior) -> ticket
+		{
+			return load(file, prior, complete_handler());
+		}
+
+		auto image_loader::load(const nana::string& file, priority prior, const complete_handler& handler) -> ticket
+		{
+			ticket tk;
+			tk.request_ = std::make_shared<request>(impl_, file, prior, handler);
+			impl_->push(tk.request_);
+			return tk;
+		}
+
+		void image_loader::placeholder(const paint::image& img)
+		{
+			std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+			impl_->placeholder_image = img;
+		}
+
+		void image_loader::placeholder(color_t color)
+		{
+			std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+			impl_->placeholder_image.close();
+			impl_->placeholder_color = color;
+		}
+
+		void image_loader::cancel_all()
+		{
+			impl_->cancel_all();
+		}
+
+		std::size_t image_loader::outstanding() const
+		{
+			std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+			return impl_->outstanding;
+		}
+	//end class image_loader
+}//end namespace gui
+}//end namespace nana
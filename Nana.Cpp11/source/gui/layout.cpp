@@ -49,16 +49,16 @@ namespace gui
 					delete u.ref_gird;
 			}
 
-			void area(const nana::rectangle& r)
+			void area(const nana::rectangle& r, API::layout_transaction& trans)
 			{
 				switch(kind)
 				{
 				case kind_window:
-					API::move_window(u.ref_wnd, r.x, r.y, r.width, r.height);
+					trans.move(u.ref_wnd, r);
 					break;
 				case kind_gird:
 					u.ref_gird->area_ = r;
-					u.ref_gird->_m_adjust_children();
+					u.ref_gird->_m_adjust_children(trans);
 					break;
 				}
 			}
@@ -121,28 +121,36 @@ namespace gui
 		{
 			element_tag * p = new element_tag(blank, scale);
 			child_.push_back(p);
-			_m_adjust_children();
+
+			API::layout_transaction trans;
+			_m_adjust_children(trans);
 			return p->u.ref_gird;
 		}
 
 		void gird::push(window wd, unsigned blank, unsigned scale)
 		{
 			child_.push_back(new element_tag(wd, blank, scale));
-			_m_adjust_children();
+
+			API::layout_transaction trans;
+			_m_adjust_children(trans);
 		}
 
 		gird * gird::add(unsigned blank, unsigned scale)
 		{
 			element_tag * p = new element_tag(blank, scale);
 			elements_.push_back(p);
-			_m_adjust_elements();
+
+			API::layout_transaction trans;
+			_m_adjust_elements(trans);
 			return p->u.ref_gird;
 		}
 
 		void gird::add(window wd, unsigned blank, unsigned scale)
 		{
 			elements_.push_back(new element_tag(wd, blank, scale));
-			_m_adjust_elements();
+
+			API::layout_transaction trans;
+			_m_adjust_elements(trans);
 		}
 
 		void gird::fasten(window wd)
@@ -154,7 +162,10 @@ namespace gui
 		void gird::_m_resize()
 		{
 			area_ = API::window_size(owner_.u.ref_widget);
-			_m_adjust_children();
+
+			//Apply the changes of all the elements and children at once.
+			API::layout_transaction trans;
+			_m_adjust_children(trans);
 		}
 
 		template<typename Container>
@@ -175,7 +186,7 @@ namespace gui
 			return ((number && (fixed < range_pixels)) ? (range_pixels - fixed) / number : 0);
 		}
 
-		void gird::_m_adjust_children()
+		void gird::_m_adjust_children(API::layout_transaction& trans)
 		{
 			unsigned pixels_of_adjustable = prepare_adjustable_pixels(area_.height, child_);
 
@@ -198,13 +209,13 @@ namespace gui
 					area.height = i->scale;
 				}
 				top += i->blank;
-				i->area(area);
+				i->area(area, trans);
 			}
 
-			_m_adjust_elements();
+			_m_adjust_elements(trans);
 		}
 
-		void gird::_m_adjust_elements()
+		void gird::_m_adjust_elements(API::layout_transaction& trans)
 		{
 			unsigned pixels_of_adjustable = prepare_adjustable_pixels(area_.width, elements_);
 
@@ -224,11 +235,11 @@ namespace gui
 					area.width = i->scale;
 				}
 				left += i->blank;
-				i->area(area);
+				i->area(area, trans);
 			}
 
 			for(auto i : fasten_elements_)
-				API::move_window(i, area_.x, area_.y, area_.width, area_.height);
+				trans.move(i, area_);
 		}
 	//end class gird
 }//end namespace gui
@@ -13,6 +13,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <cstring>
+#include <algorithm>
 #include <nana/gui/place.hpp>
 #include <nana/gui/programming_interface.hpp>
 
@@ -336,6 +337,8 @@ namespace nana{	namespace gui
 		division * root_division;
 		std::map<std::string, field_impl*> fields;
 
+		void collocate();
+
 		implement()
 			: window_handle(nullptr), event_size_handle(nullptr), root_division(nullptr)
 		{}
@@ -344,6 +347,7 @@ namespace nana{	namespace gui
 		//because the class division here is an incomplete type.
 		~implement();
 		static division * search_div_name(division* start, const std::string&);
+		static void attached_fields(division* start, std::vector<field_impl*>&);
 		division * scan_div(tokenizer&);
 	};	//end struct implement
 
@@ -524,8 +528,15 @@ namespace nana{	namespace gui
 
 		field_impl(place * p)
 			:	attached(false),
-				place_ptr_(p)
+				attached_div(nullptr),
+				place_ptr_(p),
+				extent_dirty_(true),
+				percent_sum_(0)
 		{}
+
+		//Marks the cached extents dirty and propagates the change to the attached division.
+		//It is defined behind the definition of class division.
+		void invalidate();
 	private:
 		//Listen to destroy of a window
 		//It will delete the element and recollocate when the window destroyed.
@@ -540,7 +551,8 @@ namespace nana{	namespace gui
 					elements.erase(i);
 					break;
 				}
-				place_ptr_->collocate();
+				invalidate();
+				place_ptr_->impl_->collocate();
 			});
 		}
 
@@ -548,12 +560,14 @@ namespace nana{	namespace gui
 		{
 			elements.emplace_back(wd);
 			_m_make_destroy(wd);
+			invalidate();
 			return *this;
 		}
 
 		field_t& operator<<(unsigned gap) override
 		{
 			elements.emplace_back(gap);
+			invalidate();
 			return *this;
 		}
 
@@ -561,6 +575,7 @@ namespace nana{	namespace gui
 		{
 			elements.emplace_back(fx);
 			_m_make_destroy(fx.first);
+			invalidate();
 			return *this;
 		}
 
@@ -568,6 +583,7 @@ namespace nana{	namespace gui
 		{
 			elements.emplace_back(pcnt);
 			_m_make_destroy(pcnt.first);
+			invalidate();
 			return *this;
 		}
 
@@ -580,12 +596,14 @@ namespace nana{	namespace gui
 				x.second.second = 1;
 			elements.emplace_back(x);
 			_m_make_destroy(r.first);
+			invalidate();
 			return *this;
 		}
 
 		field_t& fasten(window wd) override
 		{
 			fastened.push_back(wd);
+			invalidate();
 
 			//Listen to destroy of a window. The deleting a fastened window
 			//does not change the layout.
@@ -606,7 +624,25 @@ namespace nana{	namespace gui
 		//returns the number of fixed pixels and the number of adjustable items
 		std::pair<unsigned, std::size_t> fixed_and_adjustable() const
 		{
+			_m_update_extents();
+			return fixed_and_adjustable_;
+		}
+
+		unsigned percent_pixels(unsigned pixels) const
+		{
+			_m_update_extents();
+			return static_cast<unsigned>(pixels * percent_sum_);
+		}
+	private:
+		//The extents of the elements are cached, they are only recomputed
+		//after the elements are changed.
+		void _m_update_extents() const
+		{
+			if(false == extent_dirty_)
+				return;
+
 			std::pair<unsigned, std::size_t> vpair;
+			double percent_sum = 0;
 			for(auto & e : elements)
 			{
 				switch(e.kind_of_element)
@@ -618,30 +654,28 @@ namespace nana{	namespace gui
 					vpair.first += e.u.gap_value;
 					break;
 				case element_t::kind::percent:	//the percent is not fixed and not adjustable.
+					percent_sum += e.u.percent_ptr->second / 100.0;
 					break;
 				default:
 					++vpair.second;
 				}
 			}
-			return vpair;
-		}
 
-		unsigned percent_pixels(unsigned pixels) const
-		{
-			double perpx = 0;
-			for(auto & e : elements)
-			{
-				if(element_t::kind::percent == e.kind_of_element)
-					perpx += pixels * (e.u.percent_ptr->second / 100.0);
-			}
-			return static_cast<unsigned>(perpx);
+			fixed_and_adjustable_ = vpair;
+			percent_sum_ = percent_sum;
+			extent_dirty_ = false;
 		}
 	public:
 		bool attached;
+		division * attached_div;
 		std::vector<element_t> elements;
 		std::vector<window>	fastened;
 	private:
 		place * place_ptr_;
+
+		mutable bool extent_dirty_;
+		mutable std::pair<unsigned, std::size_t> fixed_and_adjustable_;
+		mutable double percent_sum_;
 	};//end class field_impl
 
 	class place::implement::division
@@ -650,14 +684,17 @@ namespace nana{	namespace gui
 		enum class kind{arrange, vertical_arrange, grid};
 
 		division(kind k, std::string&& n)
-			: kind_of_division(k), name(std::move(n)), field(nullptr)
+			: kind_of_division(k), name(std::move(n)), parent(nullptr), field(nullptr), dirty_(true)
 		{}
 
 		virtual ~division()
 		{
 			//detach the field
 			if(field)
+			{
 				field->attached = false;
+				field->attached_div = nullptr;
+			}
 
 			for(auto p : children)
 			{
@@ -695,18 +732,55 @@ namespace nana{	namespace gui
 			return pair;
 		}
 
-		virtual void collocate() = 0;
+		//Marks the division and its ancestors dirty, the dirty divisions will be re-solved
+		//even if their areas are not changed.
+		void invalidate()
+		{
+			for(division * div = this; div; div = div->parent)
+				div->dirty_ = true;
+		}
+
+		void invalidate_tree()
+		{
+			dirty_ = true;
+			for(auto child : children)
+				child->invalidate_tree();
+		}
 
+		//Solves the layout of the division. The division and its children are skipped if
+		//it is not dirty and its area is the same as the last solved area.
+		void collocate(API::layout_transaction& trans)
+		{
+			if(dirty_ || (area != solved_area_))
+			{
+				_m_collocate(trans);
+				solved_area_ = area;
+				dirty_ = false;
+			}
+		}
+	private:
+		virtual void _m_collocate(API::layout_transaction&) = 0;
 	public:
 		kind kind_of_division;
 		const std::string name;
+		division * parent;
 		std::vector<division*> children;
 		nana::rectangle area;
 		number_t weight;
 		number_t gap;
 		field_impl * field;
+	private:
+		bool dirty_;
+		nana::rectangle solved_area_;
 	};
 
+	void place::implement::field_impl::invalidate()
+	{
+		extent_dirty_ = true;
+		if(attached_div)
+			attached_div->invalidate();
+	}
+
 
 	/// Horizontal
 	class place::implement::div_arrange
@@ -717,7 +791,8 @@ namespace nana{	namespace gui
 			: division(kind::arrange, std::move(name))
 		{}
 
-		virtual void collocate()
+	private:
+		void _m_collocate(API::layout_transaction& trans) override
 		{
 			auto pair = fixed_pixels(kind::arrange);				/// Calcule in first the summe of all fixed fields in this div and in all child div. In second count unproseced fields
 			if(field)												/// Have this div fields? (A pointer to fields in this div)
@@ -757,7 +832,7 @@ namespace nana{	namespace gui
 
 				left += adj_px;
 				child->area.width = static_cast<unsigned>(adj_px) - (static_cast<unsigned>(adj_px) > gap_size ? gap_size : 0);
-				child->collocate();	/// The child div have full position. Now we can collocate  inside it the child fields and child-div. 
+				child->collocate(trans);	/// The child div have full position. Now we can collocate  inside it the child fields and child-div. 
 			}
 
 			if(field)
@@ -772,7 +847,7 @@ namespace nana{	namespace gui
 					{
 					case ekind::fixed:
 						r.width = el.u.fixed_ptr->second;
-						API::move_window(el.u.fixed_ptr->first, r.x, r.y, r.width, r.height);
+						trans.move(el.u.fixed_ptr->first, r.x, r.y, r.width, r.height);
 						left += r.width;
 						break;
 					case ekind::gap:
@@ -780,15 +855,15 @@ namespace nana{	namespace gui
 						break;
 					case ekind::percent:
 						r.width = area.width * el.u.percent_ptr->second / 100;
-						API::move_window(el.u.percent_ptr->first, r.x, r.y, r.width, r.height);
+						trans.move(el.u.percent_ptr->first, r.x, r.y, r.width, r.height);
 						left += r.width;
 						break;
 					case ekind::window:
-						API::move_window(el.u.handle, r.x, r.y, adj_px, r.height);
+						trans.move(el.u.handle, r.x, r.y, adj_px, r.height);
 						left += adjustable_pixels;
 						break;
 					case ekind::room:
-						API::move_window(el.u.room_ptr->first, r.x, r.y, adj_px, r.height);
+						trans.move(el.u.room_ptr->first, r.x, r.y, adj_px, r.height);
 						left += adjustable_pixels;
 						break;
 					}
@@ -796,7 +871,7 @@ namespace nana{	namespace gui
 
 				for(auto & fsn: field->fastened)
 				{
-					API::move_window(fsn, area.x, area.y, area.width, area.height);
+					trans.move(fsn, area.x, area.y, area.width, area.height);
 				}
 			}
 		}
@@ -810,7 +885,8 @@ namespace nana{	namespace gui
 			: division(kind::vertical_arrange, std::move(name))
 		{}
 
-		virtual void collocate()
+	private:
+		void _m_collocate(API::layout_transaction& trans) override
 		{
 			auto pair = fixed_pixels(kind::vertical_arrange);		/// Calcule in first the summe of all fixed fields in this div and in all child div. In second count unproseced fields
 			if(field)												/// Have this div fields? (A pointer to fields in this div) 
@@ -853,7 +929,7 @@ namespace nana{	namespace gui
 
 				top += adj_px;
 				child->area.height = static_cast<unsigned>(adj_px) - (static_cast<unsigned>(adj_px) > gap_size ? gap_size : 0);
-				child->collocate();
+				child->collocate(trans);
 			}
 
 			if(field)
@@ -868,7 +944,7 @@ namespace nana{	namespace gui
 					{
 					case ekind::fixed:
 						r.height = el.u.fixed_ptr->second;
-						API::move_window(el.u.fixed_ptr->first, r.x, r.y, r.width, r.height);
+						trans.move(el.u.fixed_ptr->first, r.x, r.y, r.width, r.height);
 						top += r.height;
 						break;
 					case ekind::gap:
@@ -876,15 +952,15 @@ namespace nana{	namespace gui
 						break;
 					case ekind::percent:
 						r.height = area.height * el.u.percent_ptr->second / 100;
-						API::move_window(el.u.percent_ptr->first, r.x, r.y, r.width, r.height);
+						trans.move(el.u.percent_ptr->first, r.x, r.y, r.width, r.height);
 						top += r.height;
 						break;
 					case ekind::window:
-						API::move_window(el.u.handle, r.x, r.y, r.width, adj_px);
+						trans.move(el.u.handle, r.x, r.y, r.width, adj_px);
 						top += adjustable_pixels;
 						break;
 					case ekind::room:
-						API::move_window(el.u.room_ptr->first, r.x, r.y, r.width, adj_px);
+						trans.move(el.u.room_ptr->first, r.x, r.y, r.width, adj_px);
 						top += adjustable_pixels;
 						break;
 					}
@@ -892,7 +968,7 @@ namespace nana{	namespace gui
 
 				for(auto & fsn: field->fastened)
 				{
-					API::move_window(fsn, area.x, area.y, area.width, area.height);
+					trans.move(fsn, area.x, area.y, area.width, area.height);
 				}
 			}
 		}
@@ -908,7 +984,8 @@ namespace nana{	namespace gui
 			dimension.first = dimension.second = 0;
 		}
 
-		virtual void collocate()
+	private:
+		void _m_collocate(API::layout_transaction& trans) override
 		{
 			if(nullptr == field)
 				return;
@@ -978,7 +1055,7 @@ namespace nana{	namespace gui
 
 						unsigned width = (value > uns_block_w ? uns_block_w : value);
 						if(width > gap_size)	width -= gap_size;
-						API::move_window(wd, static_cast<int>(x), static_cast<int>(y), width, height);
+						trans.move(wd, static_cast<int>(x), static_cast<int>(y), width, height);
 						x += block_w;
 					}
 					if(exit_for) break;
@@ -1049,7 +1126,7 @@ namespace nana{	namespace gui
 							if(width > gap_size)	width -= gap_size;
 							if(height > gap_size)	height -= gap_size;
 
-							API::move_window(wd, pos_x, pos_y, width, height);
+							trans.move(wd, pos_x, pos_y, width, height);
 							table[l + lbp] = 1;
 						}
 						else
@@ -1058,7 +1135,7 @@ namespace nana{	namespace gui
 							if(width > gap_size)	width -= gap_size;
 							if(height > gap_size)	height -= gap_size;
 
-							API::move_window(i->u.room_ptr->first, pos_x, pos_y, width, height);
+							trans.move(i->u.room_ptr->first, pos_x, pos_y, width, height);
 
 							for(std::size_t y = 0; y < room.second; ++y)
 								for(std::size_t x = 0; x < room.first; ++x)
@@ -1078,7 +1155,7 @@ namespace nana{	namespace gui
 
 			for(auto & fsn: field->fastened)
 			{
-				API::move_window(fsn, area.x, area.y, area.width, area.height);
+				trans.move(fsn, area.x, area.y, area.width, area.height);
 			}
 		}
 	private:
@@ -1109,6 +1186,31 @@ namespace nana{	namespace gui
 		std::pair<unsigned, unsigned> dimension;
 	};//end class div_grid
 
+	void place::implement::collocate()
+	{
+		if(root_division && window_handle)
+		{
+			root_division->area = API::window_size(window_handle);
+
+			//All the geometry and visibility changes are applied at once when the transaction
+			//is committed, therefore the window is refreshed only once.
+			API::layout_transaction trans;
+			root_division->collocate(trans);
+
+			std::vector<field_impl*> shown;
+			attached_fields(root_division, shown);
+
+			for(auto & field : fields)
+			{
+				bool is_show = (shown.end() != std::find(shown.begin(), shown.end(), field.second));
+
+				for(auto & el : field.second->elements)
+					trans.show(el.window_handle(), is_show);
+			}
+			trans.commit();
+		}
+	}
+
 	place::implement::~implement()
 	{
 		API::umake_event(event_size_handle);
@@ -1136,6 +1238,19 @@ namespace nana{	namespace gui
 		return nullptr;
 	}
 
+	//attached_fields
+	//retrieve the fields which are attached to the division tree.
+	void place::implement::attached_fields(division* start, std::vector<field_impl*>& fields)
+	{
+		if(nullptr == start) return;
+
+		if(start->field)
+			fields.push_back(start->field);
+
+		for(auto child : start->children)
+			attached_fields(child, fields);
+	}
+
 	place::implement::division* place::implement::scan_div(tokenizer& tknizer)
 	{
 		typedef tokenizer::token token;
@@ -1249,6 +1364,15 @@ namespace nana{	namespace gui
 		div->weight = weight;
 		div->gap = gap;
 		div->field = field;		//attach the field to the division
+		if(field)
+		{
+			field->attached_div = div;
+			field->invalidate();
+		}
+
+		for(auto child : children)
+			child->parent = div;
+
 		div->children.swap(children);
 		return div;
 	}
@@ -1281,8 +1405,11 @@ namespace nana{	namespace gui
 				{
 					if(impl_->root_division)
 					{
+						//Only the divisions whose areas are changed are re-solved.
 						impl_->root_division->area = API::window_size(ei.window);
-						impl_->root_division->collocate();
+
+						API::layout_transaction trans;
+						impl_->root_division->collocate(trans);
 					}
 				});
 		}
@@ -1333,6 +1460,8 @@ namespace nana{	namespace gui
 
 					div->field = p;
 					p->attached = true;
+					p->attached_div = div;
+					p->invalidate();
 				}
 			}
 			return *p;
@@ -1340,21 +1469,11 @@ namespace nana{	namespace gui
 
 		void place::collocate()
 		{
-			if(impl_->root_division && impl_->window_handle)
-			{
-				impl_->root_division->area = API::window_size(impl_->window_handle);
-				impl_->root_division->collocate();
+			//The windows may be moved by others, so re-solve all the divisions.
+			if(impl_->root_division)
+				impl_->root_division->invalidate_tree();
 
-				for(auto & field : impl_->fields)
-				{
-					bool is_show = field.second->attached;
-					if(is_show)
-						is_show = (nullptr != implement::search_div_name(impl_->root_division, field.first));
-
-					for(auto & el : field.second->elements)
-						API::show_window(el.window_handle(), is_show);
-				}
-			}
+			impl_->collocate();
 		}
 	//end class place
 
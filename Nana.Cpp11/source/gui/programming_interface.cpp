@@ -259,6 +259,79 @@ namespace API
 		}
 	}
 
+	//class post_target
+		post_target::post_target()
+			: window_(nullptr), uid_(0)
+		{}
+
+		post_target::post_target(window wd)
+			: window_(nullptr), uid_(0)
+		{
+			auto iwd = reinterpret_cast<restrict::core_window_t*>(wd);
+			internal_scope_guard isg;
+			if(restrict::window_manager.available(iwd))
+			{
+				channel_ = restrict::bedrock.channel(iwd);
+				window_ = iwd;
+				uid_ = iwd->uid;
+			}
+		}
+
+		bool post_target::empty() const
+		{
+			return (nullptr == channel_);
+		}
+
+		//The window is checked again when the task is run, because it may be destroyed while the task is waiting,
+		//and the uid tells whether the window at the address is the one which the task is posted to.
+		bool post_target::post(const std::function<void()>& task, std::size_t coalescing_key) const
+		{
+			if(nullptr == channel_ || !task)
+				return false;
+
+			auto iwd = window_;
+			auto uid = uid_;
+			return channel_->post(iwd, coalescing_key, [iwd, uid, task]
+			{
+				if(restrict::window_manager.available(iwd) && (iwd->uid == uid))
+					task();
+			});
+		}
+
+		bool post_target::post(const std::vector<std::function<void()> >& tasks) const
+		{
+			if(nullptr == channel_)
+				return false;
+
+			auto iwd = window_;
+			auto uid = uid_;
+			std::vector<std::function<void()> > wrapped;
+			wrapped.reserve(tasks.size());
+			for(auto & task : tasks)
+			{
+				if(task)
+				{
+					wrapped.push_back([iwd, uid, task]
+					{
+						if(restrict::window_manager.available(iwd) && (iwd->uid == uid))
+							task();
+					});
+				}
+			}
+			return channel_->post(iwd, wrapped);
+		}
+	//end class post_target
+
+	bool post(window wd, const std::function<void()>& task, std::size_t coalescing_key)
+	{
+		return post_target(wd).post(task, coalescing_key);
+	}
+
+	bool post(window wd, const std::vector<std::function<void()> >& tasks)
+	{
+		return post_target(wd).post(tasks);
+	}
+
 	//transform_shortkey_text
 	//@brief:	This function searchs whether the text contains a '&' and removes the character for transforming.
 	//			If the text contains more than one '&' charachers, the others are ignored. e.g
@@ -552,6 +625,123 @@ namespace API
 		}
 	}
 
+	//class layout_transaction
+		layout_transaction::layout_transaction()
+		{}
+
+		layout_transaction::~layout_transaction()
+		{
+			//A destructor must not throw, the changes which failed to commit are discarded.
+			try
+			{
+				commit();
+			}
+			catch(...){}
+		}
+
+		void layout_transaction::move(window wd, const rectangle& r)
+		{
+			if(wd)
+			{
+				action act = {wd, false, false, r};
+				actions_.push_back(act);
+			}
+		}
+
+		void layout_transaction::move(window wd, int x, int y, unsigned width, unsigned height)
+		{
+			move(wd, rectangle(x, y, width, height));
+		}
+
+		void layout_transaction::show(window wd, bool visible)
+		{
+			if(wd)
+			{
+				action act = {wd, true, visible, rectangle()};
+				actions_.push_back(act);
+			}
+		}
+
+		void layout_transaction::commit()
+		{
+			if(actions_.empty())
+				return;
+
+			//Swap the actions out, because the events raised while committing may open another
+			//transaction, or commit this transaction again.
+			std::vector<action> actions;
+			actions.swap(actions_);
+
+			//The windows to be refreshed, the second member indicates whether the window
+			//should be redrawn with its children, it is required when a child is hidden or shown.
+			std::vector<std::pair<restrict::core_window_t*, bool> > updates;
+
+			internal_scope_guard isg;
+			for(auto & act : actions)
+			{
+				auto iwd = reinterpret_cast<restrict::core_window_t*>(act.handle);
+				if(false == restrict::window_manager.available(iwd))
+					continue;
+
+				bool changed;
+				if(act.is_show)
+				{
+					changed = (iwd->visible != act.visible);
+					if(changed)
+						restrict::window_manager.show(iwd, act.visible, true);
+				}
+				else
+					changed = restrict::window_manager.move(iwd, act.r.x, act.r.y, act.r.width, act.r.height);
+
+				//A root window is shown by its native window.
+				if(false == changed || (act.is_show && (category::flags::root == iwd->other.category)))
+					continue;
+
+				//Find the parent which owns the graphics that the window is pasted into,
+				//a moved root window is updated itself, as API::move_window does.
+				auto owner = iwd;
+				if(category::flags::root != iwd->other.category)
+				{
+					owner = iwd->parent;
+					while(owner && (category::flags::lite_widget == owner->other.category))
+						owner = owner->parent;
+				}
+
+				if(nullptr == owner)
+					continue;
+
+				auto i = std::find_if(updates.begin(), updates.end(), [owner](const std::pair<restrict::core_window_t*, bool>& u)
+				{
+					return (u.first == owner);
+				});
+
+				if(i == updates.end())
+					updates.emplace_back(owner, act.is_show);
+				else if(act.is_show)
+					i->second = true;
+			}
+
+			for(auto & u : updates)
+			{
+				if(false == restrict::window_manager.available(u.first))
+					continue;
+
+				if(u.second)
+				{
+					restrict::window_manager.refresh_tree(u.first);
+					restrict::window_manager.map(u.first);
+				}
+				else
+					restrict::window_manager.update(u.first, false, false);
+			}
+		}
+
+		bool layout_transaction::empty() const
+		{
+			return actions_.empty();
+		}
+	//end class layout_transaction
+
 	bool set_window_z_order(window wd, window wd_after, z_order_action action_if_no_wd_after)
 	{
 		auto iwd = reinterpret_cast<restrict::core_window_t*>(wd);
@@ -699,6 +889,15 @@ namespace API
 		restrict::window_manager.update(reinterpret_cast<restrict::core_window_t*>(wd), false, true);
 	}
 
+	void update_windows(const std::vector<window>& wds)
+	{
+		std::vector<restrict::core_window_t*> iwds;
+		iwds.reserve(wds.size());
+		for(auto wd : wds)
+			iwds.push_back(reinterpret_cast<restrict::core_window_t*>(wd));
+		restrict::window_manager.update(iwds);
+	}
+
 	void window_caption(window wd, const nana::string& title)
 	{
 		if(wd)
@@ -505,9 +505,7 @@ namespace gui
 
 				void _m_draw_block(graph_reference graph, const nana::string& s, dstream::linecontainer::iterator block_start, render_status& rs)
 				{
-					nana::unicode_bidi bidi;
-					std::vector<nana::unicode_bidi::entity> reordered;
-					bidi.linestr(s.data(), s.length(), reordered);
+					const std::vector<nana::unicode_bidi::entity> & reordered = bidi_.linestr(s.data(), s.length());
 
 					pixel_tag px = rs.pixels[rs.index];
 
@@ -594,6 +592,7 @@ namespace gui
 				}def_;
 				nana::gui::widgets::skeletons::fblock * fblock_;
 				std::deque<traceable> traceable_;
+				nana::unicode_bidi bidi_;
 			};
 
 			//class trigger
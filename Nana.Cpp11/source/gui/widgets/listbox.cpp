@@ -13,17 +13,242 @@
 
 #include <nana/gui/widgets/listbox.hpp>
 #include <nana/gui/widgets/scroll.hpp>
+#include <nana/gui/widgets/detail/scroll_store.hpp>
 #include <nana/gui/element.hpp>
+#include <nana/threads/pool.hpp>
 #include <list>
 #include <deque>
 #include <stdexcept>
 #include <sstream>
+#include <locale>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <unordered_map>
+#include <regex>
 
 namespace nana{ namespace gui{
 	namespace drawerbase
 	{
 		namespace listbox
 		{
+			//struct sort_key_extractors
+			//@brief:	the key extractors of the builtin sort_kinds.
+			struct sort_key_extractors
+			{
+				typedef std::function<sort_key(const nana::string&, nana::any*)> function_type;
+
+				static function_type fetch(sort_kinds::t kind)
+				{
+					switch(kind)
+					{
+					case sort_kinds::collation:	return collation;
+					case sort_kinds::integer:	return integer;
+					case sort_kinds::real:		return real;
+					case sort_kinds::datetime:	return datetime;
+					default:	break;
+					}
+					return nullptr;
+				}
+
+				//The collation key of a text, two keys are compared by characters in the collation order of the global locale.
+				static sort_key collation(const nana::string& text, nana::any*)
+				{
+					auto & coll = std::use_facet<std::collate<nana::char_t> >(std::locale());
+					return sort_key(coll.transform(text.data(), text.data() + text.size()));
+				}
+
+				//The leading integer of a text, it is saturated to the range of long long.
+				static sort_key integer(const nana::string& text, nana::any*)
+				{
+					auto i = text.cbegin(), end = text.cend();
+					while(i != end && (*i == ' ' || *i == '\t'))
+						++i;
+
+					bool negative = false;
+					if(i != end && (*i == '-' || *i == '+'))
+						negative = (*i++ == '-');
+
+					//The digits are accumulated as a negative number, because the range of the negative numbers is larger.
+					const long long limit = (std::numeric_limits<long long>::min)();
+					long long n = 0;
+					bool saturated = false;
+					for(; (i != end) && ('0' <= *i && *i <= '9'); ++i)
+					{
+						const int digit = (*i - '0');
+						if(n < (limit + digit) / 10)
+						{
+							saturated = true;
+							break;
+						}
+						n = n * 10 - digit;
+					}
+
+					if(saturated)
+						return sort_key(negative ? limit : (std::numeric_limits<long long>::max)());
+					if(negative)
+						return sort_key(n);
+					return sort_key(n == limit ? (std::numeric_limits<long long>::max)() : -n);
+				}
+
+				static sort_key real(const nana::string& text, nana::any*)
+				{
+					return sort_key(nana::strtod(text.c_str(), nullptr));
+				}
+
+				//The fields year, month, day, hour, minute and second are combined into an integer yyyymmddhhmmss.
+				static sort_key datetime(const nana::string& text, nana::any*)
+				{
+					long long n = 0;
+					int fields = 0;
+					for(auto i = text.cbegin(), end = text.cend(); (i != end) && (fields < 6);)
+					{
+						if('0' <= *i && *i <= '9')
+						{
+							//A field is limited to 4 digits for the year and 2 digits for the others, the extra digits are ignored.
+							long long field = 0;
+							for(int digits = 0; (i != end) && ('0' <= *i && *i <= '9'); ++i, ++digits)
+							{
+								if(digits < (fields ? 2 : 4))
+									field = field * 10 + (*i - '0');
+							}
+							n = n * 100 + field;
+							++fields;
+						}
+						else
+							++i;
+					}
+
+					for(; fields < 6; ++fields)
+						n *= 100;
+					return sort_key(n);
+				}
+			};
+
+			//class ngram_index
+			//@brief:	an index of the trigrams of the texts of a category. It finds the items which may contain a text
+			//			without scanning all the texts, the candidates are verified by the filter.
+			class ngram_index
+			{
+			public:
+				ngram_index()
+					: ready_(false)
+				{}
+
+				bool ready() const
+				{
+					return ready_;
+				}
+
+				void ready(bool r)
+				{
+					ready_ = r;
+				}
+
+				void reset()
+				{
+					ready_ = false;
+					postings_.clear();
+				}
+
+				//Adds the trigrams of a text of an item. It is fast when the items are added in the ascending order of the indexes.
+				void add(std::size_t index, const nana::string& text)
+				{
+					for(std::size_t i = 0; i + 3 <= text.size(); ++i)
+					{
+						auto & list = postings_[_m_key(text, i)];
+						if(list.empty() || (list.back() < index))
+							list.push_back(index);
+						else if(list.back() != index)
+						{
+							auto p = std::lower_bound(list.begin(), list.end(), index);
+							if(*p != index)
+								list.insert(p, index);
+						}
+					}
+				}
+
+				//Removes an item from the lists of the trigrams of a text, it is called with every text of the item.
+				void remove(std::size_t index, const nana::string& text)
+				{
+					for(std::size_t i = 0; i + 3 <= text.size(); ++i)
+					{
+						auto p = postings_.find(_m_key(text, i));
+						if(p == postings_.end())
+							continue;
+
+						auto & list = p->second;
+						auto pos = std::lower_bound(list.begin(), list.end(), index);
+						if((pos != list.end()) && (*pos == index))
+						{
+							list.erase(pos);
+							if(list.empty())
+								postings_.erase(p);
+						}
+					}
+				}
+
+				//Renumbers the items from the index when an item is inserted at the index or is erased from it,
+				//the erased item must be removed before.
+				void shift(std::size_t index, bool inserted)
+				{
+					for(auto & p : postings_)
+					{
+						auto & list = p.second;
+						for(auto i = std::lower_bound(list.begin(), list.end(), index); i != list.end(); ++i)
+						{
+							if(inserted)
+								++(*i);
+							else
+								--(*i);
+						}
+					}
+				}
+
+				//Returns false if the text is too short to use the index, then all the items are candidates.
+				bool candidates(const nana::string& text, std::vector<std::size_t>& out) const
+				{
+					out.clear();
+					if(text.size() < 3)
+						return false;
+
+					std::vector<const std::vector<std::size_t>*> lists;
+					for(std::size_t i = 0; i + 3 <= text.size(); ++i)
+					{
+						auto p = postings_.find(_m_key(text, i));
+						if(p == postings_.end())
+							return true;	//No item contains the trigram.
+						lists.push_back(&(p->second));
+					}
+
+					//Intersects the lists from the shortest one.
+					std::sort(lists.begin(), lists.end(), [](const std::vector<std::size_t>* a, const std::vector<std::size_t>* b){ return a->size() < b->size(); });
+					out = *lists.front();
+
+					std::vector<std::size_t> result;
+					for(auto i = lists.cbegin() + 1; (i != lists.cend()) && out.size(); ++i)
+					{
+						result.clear();
+						std::set_intersection(out.cbegin(), out.cend(), (*i)->cbegin(), (*i)->cend(), std::back_inserter(result));
+						out.swap(result);
+					}
+					return true;
+				}
+			private:
+				static unsigned long long _m_key(const nana::string& text, std::size_t pos)
+				{
+					unsigned long long key = 0;
+					for(std::size_t i = pos; i < pos + 3; ++i)
+						key = (key << 21) | (static_cast<unsigned long long>(static_cast<std::make_unsigned<nana::char_t>::type>(text[i])) & 0x1FFFFF);
+					return key;
+				}
+			private:
+				bool ready_;
+				std::unordered_map<unsigned long long, std::vector<std::size_t> > postings_;
+			};
+
 			class es_header
 			{
 			public:
@@ -35,6 +260,7 @@ namespace nana{ namespace gui{
 					bool visible;
 					size_type index;
 					std::function<bool(const nana::string&, nana::any*, const nana::string&, nana::any*, bool reverse)> weak_ordering;
+					sort_key_extractors::function_type key_extractor;
 				};
 
 				typedef std::vector<item_t> container;
@@ -71,6 +297,16 @@ namespace nana{ namespace gui{
 					return nullptr;
 				}
 
+				sort_key_extractors::function_type fetch_key_extractor(std::size_t index) const
+				{
+					for(auto & m : cont_)
+					{
+						if(m.index == index)
+							return m.key_extractor;
+					}
+					return nullptr;
+				}
+
 				void create(const nana::string& text, unsigned pixels)
 				{
 					item_t m;
@@ -237,16 +473,251 @@ namespace nana{ namespace gui{
 				container cont_;
 			};
 
+			//class column_store
+			//@brief:	the texts of the items of a category, they are stored by columns. The texts of a column are kept
+			//			in an arena and the cells of the column refer to them by offsets, so an item has no allocation for
+			//			its texts, and sorting or drawing a column reads the memory of the column only.
+			class column_store
+			{
+				struct cell_t
+				{
+					unsigned offset;	//It is absent if the item has no text of the column.
+					unsigned length;
+				};
+
+				struct column_t
+				{
+					std::vector<nana::char_t> arena;
+					std::vector<cell_t> cells;
+					std::size_t garbage;	//The number of characters in the arena that no cell refers to.
+
+					column_t()
+						: garbage(0)
+					{}
+				};
+
+				static const unsigned absent = 0xFFFFFFFF;
+			public:
+				//A reference to the text of a cell, it is invalidated when a text of the column is changed.
+				struct text_ref
+				{
+					const nana::char_t * begin;
+					const nana::char_t * end;
+
+					std::size_t size() const
+					{
+						return static_cast<std::size_t>(end - begin);
+					}
+
+					nana::string str() const
+					{
+						return nana::string(begin, end);
+					}
+
+					bool operator<(const text_ref& r) const
+					{
+						return std::lexicographical_compare(begin, end, r.begin, r.end);
+					}
+				};
+
+				column_store()
+					: rows_(0)
+				{}
+
+				std::size_t rows() const
+				{
+					return rows_;
+				}
+
+				//Returns the number of texts of an item, the texts of an item are contiguous from the first column.
+				std::size_t texts(std::size_t row) const
+				{
+					std::size_t n = cols_.size();
+					while(n && (cols_[n - 1].cells[row].offset == absent))
+						--n;
+					return n;
+				}
+
+				bool exists(std::size_t row, std::size_t col) const
+				{
+					return ((col < cols_.size()) && (cols_[col].cells[row].offset != absent));
+				}
+
+				text_ref text(std::size_t row, std::size_t col) const
+				{
+					text_ref ref = {nullptr, nullptr};
+					if(col < cols_.size())
+					{
+						auto & column = cols_[col];
+						auto & cell = column.cells[row];
+						if(cell.offset != absent && cell.length)
+						{
+							ref.begin = column.arena.data() + cell.offset;
+							ref.end = ref.begin + cell.length;
+						}
+					}
+					return ref;
+				}
+
+				nana::string str(std::size_t row, std::size_t col) const
+				{
+					return text(row, col).str();
+				}
+
+				void reserve(std::size_t rows)
+				{
+					for(auto & column : cols_)
+						column.cells.reserve(rows);
+				}
+
+				//Appends an item which has the texts
+				void push_back(const std::vector<nana::string>& texts)
+				{
+					_m_insert(rows_, texts.size());
+					for(std::size_t i = 0; i < texts.size(); ++i)
+						_m_append(cols_[i], rows_, texts[i]);
+					++rows_;
+				}
+
+				//Appends an item which has a text
+				void push_back(const nana::string& text)
+				{
+					insert(rows_, text);
+				}
+
+				//Inserts an item which has a text
+				void insert(std::size_t row, const nana::string& text)
+				{
+					_m_insert(row, 1);
+					_m_append(cols_[0], row, text);
+					++rows_;
+				}
+
+				void erase(std::size_t row)
+				{
+					for(auto & column : cols_)
+					{
+						auto i = column.cells.begin() + row;
+						if(i->offset != absent)
+							column.garbage += i->length;
+						column.cells.erase(i);
+						_m_collect(column);
+					}
+					--rows_;
+				}
+
+				void clear()
+				{
+					cols_.clear();
+					rows_ = 0;
+				}
+
+				//Sets the text of a cell, the absent texts in front of the cell are filled with empty texts.
+				void assign(std::size_t row, std::size_t col, const nana::string& text)
+				{
+					if(col >= cols_.size())
+					{
+						cols_.resize(col + 1);
+						for(auto & column : cols_)
+							column.cells.resize(rows_, cell_t{absent, 0});
+					}
+
+					for(std::size_t i = 0; i < col; ++i)
+					{
+						if(cols_[i].cells[row].offset == absent)
+							cols_[i].cells[row] = cell_t{0, 0};
+					}
+
+					auto & column = cols_[col];
+					auto & cell = column.cells[row];
+					if((cell.offset != absent) && (text.size() <= cell.length))
+					{
+						//The text is replaced in place.
+						std::copy(text.begin(), text.end(), column.arena.begin() + cell.offset);
+						column.garbage += cell.length - text.size();
+						cell.length = static_cast<unsigned>(text.size());
+					}
+					else
+					{
+						if(cell.offset != absent)
+							column.garbage += cell.length;
+						_m_append(column, row, text);
+					}
+					_m_collect(column);
+				}
+
+				//Calls fn(text_ref) for each text of an item until it returns true.
+				template<typename Function>
+				bool find_text(std::size_t row, Function fn) const
+				{
+					for(std::size_t col = 0; col < cols_.size(); ++col)
+					{
+						if(cols_[col].cells[row].offset == absent)
+							break;
+						if(fn(text(row, col)))
+							return true;
+					}
+					return false;
+				}
+			private:
+				//Makes room for an item, the item has absent texts.
+				void _m_insert(std::size_t row, std::size_t texts)
+				{
+					if(cols_.size() < texts)
+					{
+						cols_.resize(texts);
+						for(auto & column : cols_)
+							column.cells.resize(rows_, cell_t{absent, 0});
+					}
+
+					for(auto & column : cols_)
+						column.cells.insert(column.cells.begin() + row, cell_t{absent, 0});
+				}
+
+				static void _m_append(column_t& column, std::size_t row, const nana::string& text)
+				{
+					if(column.arena.size() + text.size() >= absent)
+						throw std::length_error("Nana.GUI.Listbox: too many texts in a column");
+
+					auto & cell = column.cells[row];
+					cell.offset = static_cast<unsigned>(column.arena.size());
+					cell.length = static_cast<unsigned>(text.size());
+					column.arena.insert(column.arena.end(), text.begin(), text.end());
+				}
+
+				//Compacts the arena when more than half of it is garbage.
+				static void _m_collect(column_t& column)
+				{
+					if((column.garbage < 0x1000) || (column.garbage * 2 < column.arena.size()))
+						return;
+
+					std::vector<nana::char_t> arena;
+					arena.reserve(column.arena.size() - column.garbage);
+					for(auto & cell : column.cells)
+					{
+						if(cell.offset != absent)
+						{
+							auto i = column.arena.cbegin() + cell.offset;
+							cell.offset = static_cast<unsigned>(arena.size());
+							arena.insert(arena.end(), i, i + cell.length);
+						}
+					}
+					column.arena.swap(arena);
+					column.garbage = 0;
+				}
+			private:
+				std::vector<column_t> cols_;
+				std::size_t rows_;
+			};
+
 			struct essence_t;
 
 			class es_lister
 			{
 			public:
+				//The texts of the items are not kept by item_t, they are kept by the column_store of the category.
 				struct item_t
 				{
-					typedef std::vector<nana::string> container;
-
-					container texts;
 					color_t bkcolor;
 					color_t fgcolor;
 					nana::paint::image img;
@@ -265,24 +736,17 @@ namespace nana{ namespace gui{
 					}
 
 					item_t(const item_t& r)
-						:	texts(r.texts), bkcolor(r.bkcolor), fgcolor(r.fgcolor), img(r.img),
+						:	bkcolor(r.bkcolor), fgcolor(r.fgcolor), img(r.img),
 							flags(r.flags), anyobj(r.anyobj ? new nana::any(*r.anyobj) : nullptr)
 					{}
 
 					item_t(item_t&& r)
-						:	texts(std::move(r.texts)), bkcolor(r.bkcolor), fgcolor(r.fgcolor), img(r.img),
+						:	bkcolor(r.bkcolor), fgcolor(r.fgcolor), img(r.img),
 							flags(r.flags),	anyobj(r.anyobj)
 					{
 						r.anyobj = nullptr;
 					}
 
-					item_t(nana::string&& s)
-						:bkcolor(0xFF000000), fgcolor(0xFF000000), anyobj(nullptr)
-					{
-						flags.selected = flags.checked = false;
-						texts.emplace_back(std::move(s));
-					}
-
 					~item_t()
 					{
 						delete anyobj;
@@ -292,7 +756,6 @@ namespace nana{ namespace gui{
 					{
 						if(this != &r)
 						{
-							texts = r.texts;
 							flags = r.flags;
 							anyobj = (r.anyobj? new nana::any(*r.anyobj) : nullptr);
 							bkcolor = r.bkcolor;
@@ -311,6 +774,12 @@ namespace nana{ namespace gui{
 					nana::string text;
 					std::vector<std::size_t> sorted;
 					container items;
+					column_store columns;		//The texts of the items, the row i is the texts of items[i].
+					std::vector<std::vector<sort_key> > keys;	//The sort keys of the columns, keys[col][i] is the key of items[i] by the column col,
+																//keys[col] is empty if the keys of the column are not extracted.
+					std::vector<char> passed;			//The results of the filter, passed[i] is the result of items[i].
+					std::vector<std::size_t> shown;		//The indexes of the items which pass the filter, in the order of display.
+					ngram_index grams;
 					bool expand;
 
 					bool select() const
@@ -328,9 +797,17 @@ namespace nana{ namespace gui{
 				mutable extra_events ext_event;
 
 				std::function<std::function<bool(const nana::string&, nana::any*, const nana::string&, nana::any*, bool reverse)>(std::size_t) > fetch_ordering_comparer;
+				std::function<sort_key_extractors::function_type(std::size_t)> fetch_key_extractor;
+
+				//The filter is invoked with the index of category, the category and the absolute index of an item.
+				typedef std::function<bool(size_type, const category&, size_type)> filter_type;
+
+				//The number of items of a category that are filtered by multiple threads.
+				static const std::size_t parallel_filter_threshold = 0x10000;
 
 				es_lister()
-					: ess_(nullptr), widget_(nullptr), sorted_index_(npos), sorted_reverse_(false)
+					: ess_(nullptr), widget_(nullptr), sorted_index_(npos), sorted_reverse_(false),
+						text_case_(false), ctype_(nullptr), grams_enabled_(false)
 				{
 					category cg;
 					cg.expand = true;
@@ -368,38 +845,116 @@ namespace nana{ namespace gui{
 				{
 					if(sorted_index_ != npos)
 					{
-						auto weak_ordering_comp = fetch_ordering_comparer(sorted_index_);
-						if(weak_ordering_comp)
+						for(auto & cat : list_)
 						{
-							for(auto & cat: list_)
-							{
-								auto bi = std::begin(cat.sorted);
-								auto ei = std::end(cat.sorted);
-								std::sort(bi, ei, [&cat, &weak_ordering_comp, this](std::size_t x, std::size_t y){
-										//The predicate must be a strict weak ordering.
-										//!comp(x, y) != comp(x, y)
-										auto & mx = cat.items[x];
-										auto & my = cat.items[y];
-										auto & a = mx.texts[sorted_index_];
-										auto & b = my.texts[sorted_index_];
-										return weak_ordering_comp(a, mx.anyobj, b, my.anyobj, sorted_reverse_);
-									});
-							}
+							_m_sort(cat);
+							_m_make_shown(cat);
 						}
-						else
-						{	//No user-defined comparer is provided, and default comparer is applying.
-							for(auto & cat: list_)
-							{
-								std::sort(std::begin(cat.sorted), std::end(cat.sorted), [&cat, this](std::size_t x, std::size_t y){
-										auto & a = cat.items[x].texts[sorted_index_];
-										auto & b = cat.items[y].texts[sorted_index_];
-										return (sorted_reverse_ ? a > b : a < b);
-									});
-							}
+					}
+				}
+
+				//Sorts a category again after the text of an item is changed.
+				void sort(size_type cat, size_type index)
+				{
+					if(sorted_index_ == npos)
+						return;
+
+					auto & catobj = *_m_at(cat);
+					if(_m_key_extractor())
+						_m_sort_by_keys(catobj, index);
+					else
+						_m_sort(catobj);
+					_m_make_shown(catobj);
+				}
+
+				//Drops the keys of a column, they are extracted again by the next sort by the column.
+				void reset_keys(std::size_t col)
+				{
+					for(auto & cat : list_)
+					{
+						if(col < cat.keys.size())
+							cat.keys[col].clear();
+					}
+				}
+
+				//Shows the items which pass the filter only. An empty filter shows all the items.
+				void filter(filter_type fn)
+				{
+					filter_ = std::move(fn);
+					text_.clear();
+					_m_filter_all();
+				}
+
+				//Shows the items which contain the text in the columns. All the columns are searched if columns is empty.
+				void filter(const nana::string& text, const std::vector<size_type>& columns, bool case_sensitive)
+				{
+					if((columns != text_columns_) || (case_sensitive != text_case_))
+					{
+						//The n-gram indexes are built for the columns and the case.
+						for(auto & cat : list_)
+							cat.grams.reset();
+						text_columns_ = columns;
+						text_case_ = case_sensitive;
+					}
+
+					text_ = text;
+					if(false == case_sensitive)
+					{
+						locale_ = std::locale();
+						ctype_ = &std::use_facet<std::ctype<nana::char_t> >(locale_);
+						_m_fold(text_);
+					}
+
+					filter_ = [this](size_type, const category& cat, size_type index){ return this->_m_contains(cat, index); };
+					_m_filter_all();
+				}
+
+				//Shows the items whose texts in the columns match the regular expression.
+				void filter(const std::basic_regex<nana::char_t>& re, const std::vector<size_type>& columns)
+				{
+					filter_ = [re, columns](size_type, const category& cat, size_type index)
+					{
+						auto match = [&re](const column_store::text_ref& t)
+						{
+							return std::regex_search(t.begin, t.end, re);
+						};
+
+						if(columns.empty())
+							return cat.columns.find_text(index, match);
+
+						for(auto c : columns)
+						{
+							if(cat.columns.exists(index, c) && match(cat.columns.text(index, c)))
+								return true;
 						}
+						return false;
+					};
+					text_.clear();
+					_m_filter_all();
+				}
+
+				bool filtered() const
+				{
+					return (nullptr != filter_);
+				}
+
+				//Enables the n-gram index for the text filter, the index is built when a text filter is applied.
+				void filter_index(bool enable)
+				{
+					grams_enabled_ = enable;
+					if(false == enable)
+					{
+						for(auto & cat : list_)
+							cat.grams.reset();
 					}
 				}
 
+				//Returns true if the items are displayed in an order that differs from the absolute indexes.
+				bool indexed() const
+				{
+					return (filter_ || (sorted_index_ != npos));
+				}
+
 				bool sort_index(std::size_t index)
 				{
 					if(npos != index)
@@ -419,6 +974,14 @@ namespace nana{ namespace gui{
 					return false;
 				}
 
+				void sort_index(std::size_t index, bool reverse)
+				{
+					sorted_index_ = index;
+					sorted_reverse_ = reverse;
+					if(npos != index)
+						sort();
+				}
+
 				std::size_t sort_index() const
 				{
 					return sorted_index_;
@@ -439,22 +1002,64 @@ namespace nana{ namespace gui{
 
 				void push_back(size_type cat, const nana::string& text)
 				{
-					item_t item;
-					item.texts.push_back(text);
 					auto & catobj = *_m_at(cat);
 
 					auto n = catobj.items.size();
-					catobj.items.emplace_back(std::move(item));
+					catobj.items.emplace_back();
+					catobj.columns.push_back(text);
 					catobj.sorted.push_back(n);		//Why not catobj.sorted.push_back(catobj.items.size() - 1) ?
 													//I think it is a compiler bug(VC2012) that catobj.sorted.push_back(catobj.items.size() - 1)
 													//generates a size_t-to-unsigned conversion.
+					_m_append_keys(catobj, n);
+					_m_filter_appended(cat, catobj);
 				}
 
 				void push_back(std::size_t pos, nana::string&& s)
 				{
 					auto & catobj = *_m_at(pos);
-					catobj.items.emplace_back(std::move(s));
+					catobj.items.emplace_back();
+					catobj.columns.push_back(s);
 					catobj.sorted.push_back(catobj.items.size() - 1);
+					_m_append_keys(catobj, catobj.items.size() - 1);
+					_m_filter_appended(pos, catobj);
+				}
+
+				//Appends the rows at the end of a category, a row is the texts of an item. The category
+				//is filtered and sorted once for all the rows, instead of once for every row.
+				void push_back(size_type cat, std::vector<std::vector<nana::string> >&& rows, color_t bkcolor, color_t fgcolor)
+				{
+					auto & catobj = *_m_at(cat);
+					const std::size_t from = catobj.items.size();
+					const std::size_t size = from + rows.size();
+
+					catobj.sorted.reserve(size);
+					catobj.columns.reserve(size);
+					for(auto & row : rows)
+					{
+						catobj.items.emplace_back();
+						catobj.columns.push_back(row);
+						auto & m = catobj.items.back();
+						m.bkcolor = bkcolor;
+						m.fgcolor = fgcolor;
+						catobj.sorted.push_back(catobj.items.size() - 1);
+					}
+					rows.clear();
+					_m_append_keys(catobj, from);
+
+					if(filter_)
+					{
+						if(catobj.grams.ready())
+						{
+							for(std::size_t i = from; i < size; ++i)
+								_m_add_grams(catobj.grams, catobj, i);
+						}
+						catobj.passed.resize(size, 0);
+						_m_evaluate(cat, catobj, from);
+					}
+
+					if(sorted_index_ != npos)
+						_m_sort_appended(catobj, from);
+					_m_make_shown(catobj);
 				}
 
 				bool insert(size_type cat, size_type index, const nana::string& text)
@@ -465,29 +1070,56 @@ namespace nana{ namespace gui{
 					if(index > n)
 						return false;
 
-					catobj.sorted.push_back(n);
-
-					item_t item;
-					item.texts.push_back(text);
+					//The items after the inserted item are moved back, so are their indexes in the order.
+					for(auto & pos : catobj.sorted)
+					{
+						if(pos >= index)
+							++pos;
+					}
+					catobj.sorted.push_back(index);
 
 					if(index < n)
-						catobj.items.insert(catobj.items.begin() + index, item);
+						catobj.items.insert(catobj.items.begin() + index, item_t());
 					else
-						catobj.items.emplace_back(std::move(item));
+						catobj.items.emplace_back();
+					catobj.columns.insert(index, text);
+					_m_insert_keys(catobj, index);
+
+					//The other items are still in order, only the inserted item is moved to its position.
+					if(sorted_index_ != npos)
+					{
+						if(_m_key_extractor())
+							_m_sort_by_keys(catobj, index);
+						else
+							_m_sort(catobj);
+					}
+
+					//Only the grams of the inserted item are added, the items after it are renumbered.
+					if(catobj.grams.ready())
+					{
+						catobj.grams.shift(index, true);
+						_m_add_grams(catobj.grams, catobj, index);
+					}
 
+					//Only the inserted item is evaluated, the results of the other items are moved with them.
+					if(filter_)
+					{
+						catobj.passed.insert(catobj.passed.begin() + index, filter_(cat, catobj, index) ? 1 : 0);
+						_m_make_shown(catobj);
+					}
 					return true;
 				}
 
 				category::container::value_type& at(size_type cat, size_type index)
 				{
-					if(sorted_index_ != npos)
+					if(indexed())
 						index = absolute(cat, index);
 					return _m_at(cat)->items.at(index);
 				}
 
 				const category::container::value_type& at(size_type cat, size_type index) const
 				{
-					if(sorted_index_ != npos)
+					if(indexed())
 						index = absolute(cat, index);
 					return _m_at(cat)->items.at(index);
 				}
@@ -502,6 +1134,9 @@ namespace nana{ namespace gui{
 					auto& catobj = *_m_at(cat);
 					catobj.items.clear();
 					catobj.sorted.clear();
+					catobj.keys.clear();
+					catobj.columns.clear();
+					_m_clear_filtered(catobj);
 				}
 
 				void clear()
@@ -510,13 +1145,16 @@ namespace nana{ namespace gui{
 					{
 						m.items.clear();
 						m.sorted.clear();
+						m.keys.clear();
+						m.columns.clear();
+						_m_clear_filtered(m);
 					}
 				}
 
 				std::pair<size_type, size_type> advance(size_type categ, size_type index, size_type n)
 				{
 					std::pair<size_type, size_type> dpos(npos, npos);
-					if(categ >= size_categ() || (index != npos && index >= size_item(categ))) return dpos;
+					if(categ >= size_categ() || (index != npos && index >= size_shown(categ))) return dpos;
 
 					dpos.first = categ;
 					dpos.second = index;
@@ -537,7 +1175,7 @@ namespace nana{ namespace gui{
 						}
 						else
 						{
-							size_type rest = size_item(dpos.first) - dpos.second - 1;
+							size_type rest = size_shown(dpos.first) - dpos.second - 1;
 							if(rest == 0)
 							{
 								if(dpos.first + 1 == size_categ())
@@ -589,10 +1227,10 @@ namespace nana{ namespace gui{
 					if(index == npos)
 					{
 						if(i->expand)
-							n = i->items.size();
+							n = _m_size_shown(*i);
 					}
 					else
-						n = i->items.size() - (index + 1);
+						n = _m_size_shown(*i) - (index + 1);
 
 					for(++i, ++cat; i != list_.end(); ++i, ++cat)
 					{
@@ -600,7 +1238,7 @@ namespace nana{ namespace gui{
 						if(cat != to_cat)
 						{
 							if(i->expand)
-								n += i->items.size();
+								n += _m_size_shown(*i);
 						}
 						else
 						{
@@ -619,8 +1257,8 @@ namespace nana{ namespace gui{
 					{
 						auto i = list_.cbegin();
 						std::advance(i, cat);
-						if(pos < i->items.size() && (sub < i->items[pos].texts.size()))
-							return i->items[pos].texts[sub];
+						if(pos < i->items.size())
+							return i->columns.str(pos, sub);
 					}
 					return nana::string();
 				}
@@ -630,40 +1268,26 @@ namespace nana{ namespace gui{
 					auto & catobj = *_m_at(cat);
 					if((subitem < header_size) && (index < catobj.items.size()))
 					{
-						auto & cont = catobj.items[index].texts;
-						if(subitem < cont.size())
-						{
-							cont[subitem] = str;
-							if(sorted_index_ == subitem)
-								sort();
-						}
-						else
-						{	//If the index of specified sub item is over the number of sub items that item contained,
-							//it fills the non-exist items.
-							cont.resize(subitem);
-							cont.emplace_back(str);
-						}
-					}
-				}
+						//Only the grams of the item are indexed again.
+						const bool regram = catobj.grams.ready();
+						if(regram)
+							_m_remove_grams(catobj.grams, catobj, index);
 
-				void text(size_type cat, size_type index, size_type subitem, nana::string&& str, size_type header_size)
-				{
-					auto & catobj = *_m_at(cat);
+						//If the index of specified sub item is over the number of sub items that item contained,
+						//it fills the non-exist items.
+						catobj.columns.assign(index, subitem, str);
 
-					if((subitem < header_size) && (index < catobj.items.size()))
-					{
-						auto & cont = catobj.items[index].texts;
-						if(subitem < cont.size())
+						if(regram)
+							_m_add_grams(catobj.grams, catobj, index);
+
+						_m_update_key(catobj, index, subitem);
+						if(sorted_index_ == subitem)
+							sort(cat, index);
+
+						if(filter_)
 						{
-							cont[subitem] = std::move(str);
-							if(sorted_index_ == subitem)
-								sort();
-						}
-						else
-						{	//If the index of specified sub item is over the number of sub items that item contained,
-							//it fills the non-exist items.
-							cont.resize(subitem);
-							cont.emplace_back(std::move(str));
+							catobj.passed[index] = (filter_(cat, catobj, index) ? 1 : 0);
+							_m_make_shown(catobj);
 						}
 					}
 				}
@@ -673,9 +1297,32 @@ namespace nana{ namespace gui{
 					auto & catobj = *_m_at(cat);
 					if(index < catobj.items.size())
 					{
+						if(catobj.grams.ready())
+						{
+							_m_remove_grams(catobj.grams, catobj, index);
+							catobj.grams.shift(index, false);
+						}
+
 						catobj.items.erase(catobj.items.begin() + index);
-						catobj.sorted.erase(std::find(catobj.sorted.begin(), catobj.sorted.end(), catobj.items.size()));
-						sort();
+						catobj.columns.erase(index);
+
+						//The order of the other items is kept, the items after the erased item are moved forward.
+						catobj.sorted.erase(std::find(catobj.sorted.begin(), catobj.sorted.end(), index));
+						for(auto & pos : catobj.sorted)
+						{
+							if(pos > index)
+								--pos;
+						}
+
+						for(auto & keys : catobj.keys)
+						{
+							if(index < keys.size())
+								keys.erase(keys.begin() + index);
+						}
+
+						if(filter_)
+							catobj.passed.erase(catobj.passed.begin() + index);
+						_m_make_shown(catobj);
 					}
 				}
 
@@ -688,6 +1335,9 @@ namespace nana{ namespace gui{
 					{
 						i->items.clear();
 						i->sorted.clear();
+						i->keys.clear();
+						i->columns.clear();
+						_m_clear_filtered(*i);
 					}
 					else
 						list_.erase(i);
@@ -699,6 +1349,9 @@ namespace nana{ namespace gui{
 					auto i = list_.begin();
 					i->items.clear();
 					i->sorted.clear();
+					i->keys.clear();
+					i->columns.clear();
+					_m_clear_filtered(*i);
 					if(list_.size() > 1)
 						list_.erase(++i, list_.end());
 				}
@@ -735,7 +1388,7 @@ namespace nana{ namespace gui{
 					for(auto & i : list_)
 					{
 						if(i.expand)
-							n += i.items.size();
+							n += _m_size_shown(i);
 					}
 					return n;
 				}
@@ -830,7 +1483,7 @@ namespace nana{ namespace gui{
 						bool good = false;
 						for(std::size_t i = 0, size = list_.size(); i < size; ++i)
 						{
-							if(size_item(i))
+							if(size_shown(i))
 							{
 								spos.first = i;
 								spos.second = 0;
@@ -848,7 +1501,7 @@ namespace nana{ namespace gui{
 						{
 							if(good(spos.first))
 							{
-								if(size_item(spos.first) > spos.second)
+								if(size_shown(spos.first) > spos.second)
 								{
 									++spos.second;
 								}
@@ -876,9 +1529,9 @@ namespace nana{ namespace gui{
 									else
 										--spos.first;
 								}
-								while(0 == size_item(spos.first));
+								while(0 == size_shown(spos.first));
 
-								spos.second = size_item(spos.first) - 1;
+								spos.second = size_shown(spos.first) - 1;
 							}
 							else
 								--spos.second;
@@ -910,6 +1563,12 @@ namespace nana{ namespace gui{
 					return _m_at(cat)->items.size();
 				}
 
+				//Returns the number of items of a category that are displayed.
+				size_type size_shown(size_type cat) const
+				{
+					return _m_size_shown(*_m_at(cat));
+				}
+
 				bool categ_checked(size_type cat) const
 				{
 					auto & items = _m_at(cat)->items;
@@ -981,7 +1640,7 @@ namespace nana{ namespace gui{
 				std::pair<size_type, size_type> last() const
 				{
 					auto & catobj = *list_.rbegin();
-					size_type n = catobj.items.size();
+					size_type n = _m_size_shown(catobj);
 					size_type cat = list_.size() - 1;
 					if(cat == 0)
 					{
@@ -1005,7 +1664,7 @@ namespace nana{ namespace gui{
 				bool good(size_type cat, size_type index) const
 				{
 					if(cat < list_.size())
-						return index < size_item(cat);
+						return index < size_shown(cat);
 					return false;
 				}
 
@@ -1018,7 +1677,7 @@ namespace nana{ namespace gui{
 						if(index != npos)
 						{
 							auto i = _m_at(cat);
-							if(index >= i->items.size())
+							if(index >= _m_size_shown(*i))
 							{
 								if(++i != list_.end())
 								{
@@ -1030,134 +1689,533 @@ namespace nana{ namespace gui{
 							}
 						}
 
-						item.first = cat;
-						item.second = index;
-						return true;
+						item.first = cat;
+						item.second = index;
+						return true;
+					}
+					return false;
+				}
+
+				//Translate relative position into absolute position
+				size_type absolute(size_type cat, size_type index) const
+				{
+					if(filter_)
+					{
+						auto & shown = _m_at(cat)->shown;
+						return (index < shown.size() ? shown[index] : npos);
+					}
+					return (sorted_index_ == npos ? index : _m_at(cat)->sorted[index]);
+				}
+
+				bool forward(size_type cat, size_type index, size_type offs, std::pair<size_type, size_type>& item) const
+				{
+					std::pair<size_type, size_type> good;
+					if(good_item(cat, index, good) == false)
+						return false;
+
+					cat = good.first;
+					index = good.second;
+
+					if(offs == 0)
+					{
+						item.first = cat;
+						item.second = index;
+						return true;
+					}
+
+					if(list_.size() <= cat) return false;
+
+					//this is a category, so...
+					if(npos == index)
+					{
+						//because the first is a category, and offs must not be 0, the category would not be candidated.
+						//the algorithm above to calc the offset item is always starting with a item.
+						--offs;
+						index = 0;
+					}
+
+					auto icat = _m_at(cat);
+
+					if(_m_size_shown(*icat) <= index) return false;
+
+					if(icat->expand)
+					{
+						std::size_t item_size = _m_size_shown(*icat) - index;
+						if(offs < item_size)
+						{
+							item.first = cat;
+							item.second = offs + index;
+							return true;
+						}
+						else
+							offs -= item_size;
+					}
+
+					++cat;
+					++icat;
+					for(; icat != list_.end(); ++icat, ++cat)
+					{
+						if(offs-- == 0)
+						{
+							item.first = cat;
+							item.second = npos;
+							return true;
+						}
+
+						if(icat->expand)
+						{
+							if(offs < _m_size_shown(*icat))
+							{
+								item.first = cat;
+								item.second = offs;
+								return true;
+							}
+							else
+								offs -= _m_size_shown(*icat);
+						}
+					}
+					return false;
+				}
+
+				bool backward(size_type categ, size_type index, size_type offs, std::pair<size_type, size_type>& item) const
+				{
+					if(offs == 0)
+					{
+						item.first = categ;
+						item.second = index;
+					}
+
+					if(categ < list_.size())
+					{
+						auto i = _m_at(categ);
+						size_type n = (index == npos ? 1 : index + 2);
+						if(n <= offs)
+						{
+							offs -= n;
+						}
+						else
+						{
+							n -=offs;
+							item.first = categ;
+							item.second = (n == 1 ? npos : n - 2);
+							return true;
+						}
+
+						while(i != list_.cbegin())
+						{
+							--i;
+							--categ;
+
+							n = (i->expand ? _m_size_shown(*i) : 0) + 1;
+
+							if(n > offs)
+							{
+								n -=offs;
+								item.first = categ;
+								item.second = (n == 1 ? npos : n - 2);
+								return true;
+							}
+							else
+								offs -= n;
+						}
+					}
+					return false;
+				}
+			private:
+				//Sorts the items appended from the index into a sorted category. If the keys of the column are extracted,
+				//a few appended items are inserted at their positions found by a binary search, because the other items
+				//are in order. Otherwise, the whole category is sorted.
+				void _m_sort_appended(category& cat, std::size_t from)
+				{
+					enum{incremental_items = 16};
+
+					if(_m_key_extractor() && (cat.items.size() - from <= incremental_items) && _m_parallel_keys(cat, sorted_index_))
+					{
+						//The appended items are at the end of the order, they are taken off and inserted one by one.
+						auto less = _m_key_less(cat);
+						cat.sorted.resize(from);
+						for(std::size_t i = from, size = cat.items.size(); i < size; ++i)
+							cat.sorted.insert(std::upper_bound(cat.sorted.begin(), cat.sorted.end(), i, less), i);
+						return;
+					}
+					_m_sort(cat);
+				}
+
+				//Sorts the items of a category by the column of sorted_index_.
+				void _m_sort(category& cat)
+				{
+					auto weak_ordering_comp = fetch_ordering_comparer(sorted_index_);
+					if(!weak_ordering_comp && fetch_key_extractor(sorted_index_))
+						_m_sort_by_keys(cat, npos);
+					else if(weak_ordering_comp)
+					{
+						//The comparer takes the strings, the texts of the column are copied out of the column_store once.
+						std::vector<nana::string> texts;
+						texts.reserve(cat.items.size());
+						for(std::size_t i = 0, size = cat.items.size(); i < size; ++i)
+							texts.emplace_back(cat.columns.str(i, sorted_index_));
+
+						std::sort(std::begin(cat.sorted), std::end(cat.sorted), [&cat, &texts, &weak_ordering_comp, this](std::size_t x, std::size_t y){
+								//The predicate must be a strict weak ordering.
+								//!comp(x, y) != comp(x, y)
+								return weak_ordering_comp(texts[x], cat.items[x].anyobj, texts[y], cat.items[y].anyobj, sorted_reverse_);
+							});
+					}
+					else
+					{	//No user-defined comparer is provided, and default comparer is applying.
+						std::sort(std::begin(cat.sorted), std::end(cat.sorted), [&cat, this](std::size_t x, std::size_t y){
+								auto a = cat.columns.text(x, sorted_index_);
+								auto b = cat.columns.text(y, sorted_index_);
+								return (sorted_reverse_ ? b < a : a < b);
+							});
+					}
+				}
+
+				void _m_filter_all()
+				{
+					size_type index = 0;
+					for(auto & cat : list_)
+						_m_filter(index++, cat);
+				}
+
+				//Evaluates the filter for all the items of a category. A large category is split into
+				//blocks that are evaluated by multiple threads, therefore the filter must be thread-safe.
+				void _m_filter(size_type cat_index, category& cat)
+				{
+					if(nullptr == filter_)
+					{
+						_m_clear_filtered(cat);
+						return;
+					}
+
+					const std::size_t size = cat.items.size();
+					cat.passed.assign(size, 0);
+
+					//Only the candidates found by the n-gram index are evaluated for a text filter.
+					std::vector<std::size_t> candidates;
+					if(grams_enabled_ && text_.size())
+					{
+						if(false == cat.grams.ready())
+						{
+							for(std::size_t i = 0; i < size; ++i)
+								_m_add_grams(cat.grams, cat, i);
+							cat.grams.ready(true);
+						}
+
+						if(cat.grams.candidates(text_, candidates))
+						{
+							for(auto i : candidates)
+								cat.passed[i] = (filter_(cat_index, cat, i) ? 1 : 0);
+							_m_make_shown(cat);
+							return;
+						}
+					}
+
+					_m_evaluate(cat_index, cat, 0);
+					_m_make_shown(cat);
+				}
+
+				//Evaluates the filter for the items from the specified index to the end of a category. A large range is split
+				//into blocks, the blocks are evaluated by the threads of a pool which is created for the first large range.
+				void _m_evaluate(size_type cat_index, category& cat, std::size_t from)
+				{
+					const std::size_t size = cat.items.size();
+					const unsigned threads = std::thread::hardware_concurrency();
+					if((size - from < parallel_filter_threshold) || (threads < 2))
+					{
+						for(std::size_t i = from; i < size; ++i)
+							cat.passed[i] = (filter_(cat_index, cat, i) ? 1 : 0);
+						return;
+					}
+
+					if(nullptr == pool_)
+						pool_.reset(new nana::threads::pool(threads - 1));
+
+					const std::size_t block = (size - from + threads - 1) / threads;
+					std::vector<std::exception_ptr> excepts(threads);
+					auto routine = [this, &cat, &excepts, cat_index, from, block, size](unsigned thr)
+					{
+						try
+						{
+							const std::size_t end = (std::min)(size, from + block * (thr + 1));
+							for(std::size_t i = from + block * thr; i < end; ++i)
+								cat.passed[i] = (filter_(cat_index, cat, i) ? 1 : 0);
+						}
+						catch(...)
+						{
+							excepts[thr] = std::current_exception();
+						}
+					};
+
+					//The pool waits for its tasks by polling, the blocks are counted down for a prompt wakeup.
+					std::mutex mutex;
+					std::condition_variable done;
+					unsigned rest = threads - 1;
+					for(unsigned thr = 1; thr < threads; ++thr)
+					{
+						pool_->push([&routine, &mutex, &done, &rest, thr]
+						{
+							routine(thr);
+							std::lock_guard<std::mutex> lock(mutex);
+							if(0 == --rest)
+								done.notify_one();
+						});
+					}
+
+					routine(0);
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						done.wait(lock, [&rest]{ return (0 == rest); });
+					}
+
+					for(auto & ex : excepts)
+					{
+						if(ex)
+							std::rethrow_exception(ex);
+					}
+				}
+
+				//Evaluates the filter for an item which is appended to the end of a category.
+				void _m_filter_appended(size_type cat_index, category& cat)
+				{
+					const std::size_t index = cat.items.size() - 1;
+					if(cat.grams.ready())
+						_m_add_grams(cat.grams, cat, index);
+
+					if(filter_)
+					{
+						bool pass = filter_(cat_index, cat, index);
+						cat.passed.push_back(pass ? 1 : 0);
+
+						//The appended item is the last one in the order of display, because the sort is not applied to it.
+						if(pass)
+							cat.shown.push_back(index);
+					}
+				}
+
+				//Makes the indexes of the items to display from the results of the filter.
+				void _m_make_shown(category& cat)
+				{
+					if(nullptr == filter_)
+						return;
+
+					cat.shown.clear();
+					if(sorted_index_ != npos)
+					{
+						for(auto i : cat.sorted)
+						{
+							if(cat.passed[i])
+								cat.shown.push_back(i);
+						}
+					}
+					else
+					{
+						for(std::size_t i = 0, size = cat.passed.size(); i < size; ++i)
+						{
+							if(cat.passed[i])
+								cat.shown.push_back(i);
+						}
+					}
+				}
+
+				void _m_clear_filtered(category& cat)
+				{
+					cat.passed.clear();
+					cat.shown.clear();
+					cat.grams.reset();
+				}
+
+				//Invokes fn with every text of an item which is searched by the text filter.
+				template<typename Function>
+				void _m_filter_texts(const category& cat, std::size_t index, Function fn) const
+				{
+					if(text_columns_.empty())
+					{
+						cat.columns.find_text(index, [this, &fn](const column_store::text_ref& t)
+						{
+							fn(this->_m_text_for_filter(t));
+							return false;
+						});
+					}
+					else
+					{
+						for(auto c : text_columns_)
+						{
+							if(cat.columns.exists(index, c))
+								fn(_m_text_for_filter(cat.columns.text(index, c)));
+						}
+					}
+				}
+
+				void _m_add_grams(ngram_index& grams, const category& cat, std::size_t index) const
+				{
+					_m_filter_texts(cat, index, [&grams, index](const nana::string& text){ grams.add(index, text); });
+				}
+
+				void _m_remove_grams(ngram_index& grams, const category& cat, std::size_t index) const
+				{
+					_m_filter_texts(cat, index, [&grams, index](const nana::string& text){ grams.remove(index, text); });
+				}
+
+				bool _m_contains(const category& cat, std::size_t index) const
+				{
+					if(text_columns_.empty())
+						return cat.columns.find_text(index, [this](const column_store::text_ref& t){ return this->_m_contains(t); });
+
+					for(auto c : text_columns_)
+					{
+						if(cat.columns.exists(index, c) && _m_contains(cat.columns.text(index, c)))
+							return true;
 					}
 					return false;
 				}
 
-				//Translate relative position into absolute position
-				size_type absolute(size_type cat, size_type index) const
+				bool _m_contains(const column_store::text_ref& text) const
 				{
-					return (sorted_index_ == npos ? index : _m_at(cat)->sorted[index]);
+					if(text_case_)
+						return (std::search(text.begin, text.end, text_.cbegin(), text_.cend()) != text.end);
+
+					//The text of the filter is folded, the characters of the cell are folded while they are compared.
+					auto & ct = *ctype_;
+					return (std::search(text.begin, text.end, text_.cbegin(), text_.cend(), [&ct](nana::char_t a, nana::char_t b)
+								{
+									return (ct.tolower(a) == b);
+								}) != text.end);
 				}
 
-				bool forward(size_type cat, size_type index, size_type offs, std::pair<size_type, size_type>& item) const
+				//Returns the text of a cell for the n-gram index, it is folded if the filter ignores case.
+				nana::string _m_text_for_filter(const column_store::text_ref& text) const
 				{
-					std::pair<size_type, size_type> good;
-					if(good_item(cat, index, good) == false)
-						return false;
+					nana::string folded = text.str();
+					if(false == text_case_)
+						_m_fold(folded);
+					return folded;
+				}
+				static void _m_fold(nana::string& text)
+				{
+					if(text.size())
+						std::use_facet<std::ctype<nana::char_t> >(std::locale()).tolower(&text[0], &text[0] + text.size());
+				}
 
-					cat = good.first;
-					index = good.second;
+				//Returns the key extractor of the sorted column, it is empty if the column is sorted by a comparer or by the texts.
+				sort_key_extractors::function_type _m_key_extractor() const
+				{
+					return (fetch_ordering_comparer(sorted_index_) ? nullptr : fetch_key_extractor(sorted_index_));
+				}
 
-					if(offs == 0)
-					{
-						item.first = cat;
-						item.second = index;
-						return true;
-					}
+				//Returns true if the keys of a column are extracted for all the items of a category.
+				static bool _m_parallel_keys(const category& cat, std::size_t col)
+				{
+					return ((col < cat.keys.size()) && (cat.keys[col].size() == cat.items.size()) && cat.items.size());
+				}
 
-					if(list_.size() <= cat) return false;
+				//Compares the items of a category by the keys of the sorted column.
+				struct key_less
+				{
+					const std::vector<sort_key> * keys;
+					bool reverse;
 
-					//this is a category, so...
-					if(npos == index)
+					bool operator()(std::size_t x, std::size_t y) const
 					{
-						//because the first is a category, and offs must not be 0, the category would not be candidated.
-						//the algorithm above to calc the offset item is always starting with a item.
-						--offs;
-						index = 0;
+						return (reverse ? (*keys)[y] < (*keys)[x] : (*keys)[x] < (*keys)[y]);
 					}
+				};
 
-					auto icat = _m_at(cat);
-
-					if(icat->items.size() <= index) return false;
+				key_less _m_key_less(const category& cat) const
+				{
+					key_less less = {&cat.keys[sorted_index_], sorted_reverse_};
+					return less;
+				}
 
-					if(icat->expand)
+				//Extracts the keys of the items appended from the index, for the columns whose keys are extracted.
+				//The keys of a column that are not parallel to the items are dropped.
+				void _m_append_keys(category& cat, std::size_t from)
+				{
+					for(std::size_t col = 0; col < cat.keys.size(); ++col)
 					{
-						std::size_t item_size = icat->items.size() - index;
-						if(offs < item_size)
+						auto & keys = cat.keys[col];
+						auto extractor = (keys.size() == from ? fetch_key_extractor(col) : nullptr);
+						if(!extractor)
 						{
-							item.first = cat;
-							item.second = offs + index;
-							return true;
+							keys.clear();
+							continue;
 						}
-						else
-							offs -= item_size;
+
+						for(std::size_t i = from, size = cat.items.size(); i < size; ++i)
+							keys.push_back(extractor(cat.columns.str(i, col), cat.items[i].anyobj));
 					}
+				}
 
-					++cat;
-					++icat;
-					for(; icat != list_.end(); ++icat, ++cat)
+				//Extracts the keys of an inserted item, for the columns whose keys are extracted.
+				void _m_insert_keys(category& cat, std::size_t index)
+				{
+					for(std::size_t col = 0; col < cat.keys.size(); ++col)
 					{
-						if(offs-- == 0)
-						{
-							item.first = cat;
-							item.second = npos;
-							return true;
-						}
-
-						if(icat->expand)
+						auto & keys = cat.keys[col];
+						auto extractor = (keys.size() + 1 == cat.items.size() ? fetch_key_extractor(col) : nullptr);
+						if(!extractor)
 						{
-							if(offs < icat->items.size())
-							{
-								item.first = cat;
-								item.second = offs;
-								return true;
-							}
-							else
-								offs -= icat->items.size();
+							keys.clear();
+							continue;
 						}
+						keys.insert(keys.begin() + index, extractor(cat.columns.str(index, col), cat.items[index].anyobj));
 					}
-					return false;
 				}
 
-				bool backward(size_type categ, size_type index, size_type offs, std::pair<size_type, size_type>& item) const
+				//Extracts the key of a cell again after its text is changed.
+				void _m_update_key(category& cat, std::size_t index, std::size_t col)
 				{
-					if(offs == 0)
+					if(_m_parallel_keys(cat, col))
 					{
-						item.first = categ;
-						item.second = index;
+						auto extractor = fetch_key_extractor(col);
+						if(extractor)
+							cat.keys[col][index] = extractor(cat.columns.str(index, col), cat.items[index].anyobj);
+						else
+							cat.keys[col].clear();
 					}
+				}
 
-					if(categ < list_.size())
+				//Sorts the items of a category by the sort keys, it runs over the keys only. The keys of the column
+				//are extracted only if they are not extracted for all the items, such as the first sort by the column.
+				//If index is not npos, only the item is moved to its position, because the other items are still in order.
+				void _m_sort_by_keys(category& cat, size_type index)
+				{
+					if(!_m_parallel_keys(cat, sorted_index_))
 					{
-						auto i = _m_at(categ);
-						size_type n = (index == npos ? 1 : index + 2);
-						if(n <= offs)
-						{
-							offs -= n;
-						}
-						else
-						{
-							n -=offs;
-							item.first = categ;
-							item.second = (n == 1 ? npos : n - 2);
-							return true;
-						}
-
-						while(i != list_.cbegin())
-						{
-							--i;
-							--categ;
+						if(cat.keys.size() <= sorted_index_)
+							cat.keys.resize(sorted_index_ + 1);
+
+						auto extractor = fetch_key_extractor(sorted_index_);
+						auto & keys = cat.keys[sorted_index_];
+						keys.clear();
+						keys.reserve(cat.items.size());
+						for(std::size_t i = 0, size = cat.items.size(); i < size; ++i)
+							keys.push_back(extractor(cat.columns.str(i, sorted_index_), cat.items[i].anyobj));
+						index = npos;
+					}
 
-							n = (i->expand ? i->items.size() : 0) + 1;
+					if(cat.items.empty())
+						return;
 
-							if(n > offs)
-							{
-								n -=offs;
-								item.first = categ;
-								item.second = (n == 1 ? npos : n - 2);
-								return true;
-							}
-							else
-								offs -= n;
+					auto less = _m_key_less(cat);
+					if((npos != index) && (index < cat.items.size()))
+					{
+						auto i = std::find(cat.sorted.begin(), cat.sorted.end(), index);
+						if(i != cat.sorted.end())
+						{
+							cat.sorted.erase(i);
+							cat.sorted.insert(std::upper_bound(cat.sorted.begin(), cat.sorted.end(), index, less), index);
+							return;
 						}
 					}
-					return false;
+					std::sort(cat.sorted.begin(), cat.sorted.end(), less);
 				}
-			private:
+
+				size_type _m_size_shown(const category& cat) const
+				{
+					return (filter_ ? cat.shown.size() : cat.items.size());
+				}
+
 				container::iterator _m_at(size_type index)
 				{
 					if(index >= list_.size())
@@ -1183,6 +2241,15 @@ namespace nana{ namespace gui{
 				std::size_t sorted_index_;		//It stands for the index of header which is used for sorting.
 				bool		sorted_reverse_;
 				container list_;
+
+				filter_type filter_;
+				nana::string text_;							//The text of the text filter, it is folded if the filter ignores case.
+				std::vector<size_type> text_columns_;
+				bool text_case_;
+				std::locale locale_;						//The locale which the text of the text filter is folded by.
+				const std::ctype<nana::char_t> * ctype_;
+				bool grams_enabled_;
+				std::unique_ptr<nana::threads::pool> pool_;	//The threads which evaluate the filter for a large category.
 			};//end class es_lister
 
 			//struct essence_t
@@ -1196,6 +2263,8 @@ namespace nana{ namespace gui{
 				enum class where_t{unknown = -1, header, lister, checker};
 
 				nana::paint::graphics *graph;
+				widgets::detail::scroll_store lister_store;	//It keeps the drawn items for scrolling.
+				bool scrolling;		//The refresh is caused by a vertical scrolling only.
 				bool auto_draw;
 				bool checkable;
 				bool if_image;
@@ -1215,7 +2284,7 @@ namespace nana{ namespace gui{
 																//if where == lister || where == checker, 'second' indicates the offset to the scroll offset_y which stands for the first item displayed in lister.
 																//if where == unknown, 'second' ignored.
 
-				struct
+				struct scroll_part
 				{
 					static const unsigned scale = 16;
 					int offset_x;
@@ -1226,13 +2295,14 @@ namespace nana{ namespace gui{
 				}scroll;
 
 				essence_t()
-					:	graph(nullptr), auto_draw(true), checkable(false), if_image(false),
+					:	graph(nullptr), scrolling(false), auto_draw(true), checkable(false), if_image(false),
 						header_size(25), item_size(24), text_height(0), suspension_width(0),
 						ptr_state(state_t::normal)
 				{
 					scroll.offset_x = 0;
 					pointer_where.first = where_t::unknown;
 					lister.fetch_ordering_comparer = std::bind(&es_header::fetch_comp, &header, std::placeholders::_1);
+					lister.fetch_key_extractor = std::bind(&es_header::fetch_key_extractor, &header, std::placeholders::_1);
 				}
 
 				nana::upoint scroll_y() const
@@ -1245,7 +2315,7 @@ namespace nana{ namespace gui{
 					if(pos.x < lister.size_categ())
 					{
 						scroll.offset_y.x = pos.x;
-						size_type number = lister.size_item(pos.x);
+						size_type number = lister.size_shown(pos.x);
 						if(pos.y < number)
 							scroll.offset_y.y = pos.y;
 						else if(number)
@@ -1307,6 +2377,7 @@ namespace nana{ namespace gui{
 
 				void update()
 				{
+					lister_store.invalidate();
 					if(auto_draw && lister.wd_ptr())
 					{
 						adjust_scroll_life();
@@ -1411,6 +2482,7 @@ namespace nana{ namespace gui{
 				{
 					if(auto_draw != ad)
 					{
+						lister_store.invalidate();
 						auto_draw = ad;
 						if(ad)
 						{
@@ -1539,6 +2611,12 @@ namespace nana{ namespace gui{
 					return false;
 				}
 
+				//Returns the position of the first displayed item in pixels, it is the origin of the lister_store.
+				long long lister_origin() const
+				{
+					return static_cast<long long>(lister.distance(0, 0, scroll.offset_y.x, scroll.offset_y.y)) * item_size;
+				}
+
 				void header_seq(std::vector<es_header::size_type> &seqs, unsigned lister_w)const
 				{
 					int x = - (scroll.offset_x);
@@ -1558,6 +2636,7 @@ namespace nana{ namespace gui{
 					if(ei.identifier == events::mouse_move::identifier && ei.mouse.left_button == false) return;
 
 					bool update = false;
+					bool vertical = false;
 					if(ei.window == scroll.v.handle())
 					{
 						std::pair<size_type, size_type> item;
@@ -1568,6 +2647,7 @@ namespace nana{ namespace gui{
 								scroll.offset_y.x = static_cast<nana::upoint::value_type>(item.first);
 								scroll.offset_y.y = static_cast<nana::upoint::value_type>(item.second);
 								update = true;
+								vertical = true;
 							}
 						}
 					}
@@ -1581,7 +2661,11 @@ namespace nana{ namespace gui{
 					}
 
 					if(update)
+					{
+						scrolling = vertical;
 						API::refresh_window(lister.wd_ptr()->handle());
+						scrolling = false;
+					}
 				}
 			};
 
@@ -1808,29 +2892,82 @@ namespace nana{ namespace gui{
 
 				void draw(const nana::rectangle& rect) const
 				{
-					typedef es_lister::container::value_type::container container;
+					//The lister_store keeps the items without the highlighted item.
+					if(_m_draw(rect, rect, false))
+					{
+						essence_->lister_store.painted(*essence_->graph, rect, essence_->lister_origin());
+						_m_draw_tracker(rect);
+					}
+					else
+						essence_->lister_store.invalidate();
+				}
+
+				//Draws the lister after a vertical scrolling, only the items which are not kept by the lister_store are drawn.
+				//It returns false if the lister should be drawn entirely.
+				bool scroll(const nana::rectangle& rect) const
+				{
+					if(0 == essence_->number_of_lister_items(true))
+						return false;
+
+					if(false == essence_->lister_store.scroll(*essence_->graph, rect, essence_->lister_origin(), [this, &rect](const nana::rectangle& strip)
+						{
+							_m_draw(rect, strip, false);
+						}))
+						return false;
+
+					_m_draw_tracker(rect);
+					return true;
+				}
+			private:
+				//Draws the highlighted item
+				void _m_draw_tracker(const nana::rectangle& rect) const
+				{
+					auto & ptr_where = essence_->pointer_where;
+					if((ptr_where.first == essence_t::where_t::lister || ptr_where.first == essence_t::where_t::checker) && ptr_where.second != npos)
+					{
+						nana::rectangle strip(rect.x, rect.y + static_cast<int>(ptr_where.second * essence_->item_size), rect.width, essence_->item_size);
+						if(strip.y < rect.y + static_cast<int>(rect.height))
+						{
+							if(strip.y + strip.height > rect.y + rect.height)
+								strip.height = rect.y + rect.height - strip.y;
+							_m_draw(rect, strip, true);
+						}
+					}
+				}
 
+				//Draws the items which are in the strip, the strip is a part of rect.
+				//It returns false if there is nothing to be drawn.
+				bool _m_draw(const nana::rectangle& rect, const nana::rectangle& strip, bool tracking) const
+				{
 					size_type n = essence_->number_of_lister_items(true);
-					if(0 == n)return;
+					if(0 == n)return false;
 					widget * wdptr = essence_->lister.wd_ptr();
 					nana::color_t bkcolor = wdptr->background();
 					nana::color_t txtcolor = wdptr->foreground();
 
 					unsigned header_w = essence_->header.pixels();
 					if(header_w - essence_->scroll.offset_x < rect.width)
-						essence_->graph->rectangle(rect.x + header_w - essence_->scroll.offset_x, rect.y, rect.width - (header_w - essence_->scroll.offset_x), rect.height, bkcolor, true);
+						essence_->graph->rectangle(rect.x + header_w - essence_->scroll.offset_x, strip.y, rect.width - (header_w - essence_->scroll.offset_x), strip.height, bkcolor, true);
 
 					es_lister & lister = essence_->lister;
 					//The Tracker indicates the item where mouse placed.
 					std::pair<es_lister::size_type, es_lister::size_type> tracker(npos, npos);
 					auto & ptr_where = essence_->pointer_where;
-					if((ptr_where.first == essence_t::where_t::lister || ptr_where.first == essence_t::where_t::checker) && ptr_where.second != npos)
+					if(tracking && (ptr_where.first == essence_t::where_t::lister || ptr_where.first == essence_t::where_t::checker) && ptr_where.second != npos)
 						lister.forward(essence_->scroll.offset_y.x, essence_->scroll.offset_y.y, ptr_where.second, tracker);
 
 					std::vector<es_header::size_type> subitems;
 					essence_->header_seq(subitems, rect.width);
 
-					if(subitems.size() == 0) return;
+					if(subitems.size() == 0) return false;
+
+					//Only the items which intersect the strip are drawn.
+					const int strip_end = strip.y + static_cast<int>(strip.height);
+					const int item_size = static_cast<int>(essence_->item_size);
+					auto in_strip = [&strip, strip_end, item_size](int y)
+					{
+						return (y + item_size > strip.y && y < strip_end);
+					};
 
 					int x = essence_->item_xpos(rect);
 					int y = rect.y;
@@ -1852,31 +2989,16 @@ namespace nana{ namespace gui{
 							item_idx = 0;
 						}
 
-						//Test whether the sort is enabled.
-						if(essence_->lister.sort_index() != npos)
+						std::size_t size = lister.size_shown(catg_idx);
+						for(std::size_t offs = essence_->scroll.offset_y.y; offs < size; ++offs, ++item_idx)
 						{
-							std::size_t size = i_categ->items.size();
-							for(std::size_t offs = essence_->scroll.offset_y.y; offs < size; ++offs, ++item_idx)
-							{
-								if(n-- == 0)	break;
-								state = (tracker.first == catg_idx && tracker.second == item_idx	?
-									essence_t::state_t::highlighted : essence_t::state_t::normal);
-
-								_m_draw_item(i_categ->items[lister.absolute(catg_idx, offs)], x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
-								y += essence_->item_size;
-							}
-						}
-						else
-						{
-							for(auto i = i_categ->items.cbegin() + essence_->scroll.offset_y.y; i != i_categ->items.cend(); ++i, ++item_idx)
-							{
-								if(n-- == 0)	break;
-								state = (tracker.first == catg_idx && tracker.second == item_idx	?
-									essence_t::state_t::highlighted : essence_t::state_t::normal);
+							if(n-- == 0)	break;
+							state = (tracker.first == catg_idx && tracker.second == item_idx	?
+								essence_t::state_t::highlighted : essence_t::state_t::normal);
 
-								_m_draw_item(*i, x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
-								y += essence_->item_size;
-							}
+							if(in_strip(y))
+								_m_draw_item(*i_categ, lister.absolute(catg_idx, offs), x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
+							y += essence_->item_size;
 						}
 						++i_categ;
 						++catg_idx;
@@ -1890,47 +3012,33 @@ namespace nana{ namespace gui{
 						state = (tracker.second == npos && tracker.first == catg_idx ?
 								essence_t::state_t::highlighted : essence_t::state_t::normal);
 
-						_m_draw_categ(*i_categ, rect.x - essence_->scroll.offset_x, y, txtoff, header_w, rect, bkcolor, state);
+						if(in_strip(y))
+							_m_draw_categ(*i_categ, rect.x - essence_->scroll.offset_x, y, txtoff, header_w, rect, bkcolor, state);
 						y += essence_->item_size;
 
 						if(false == i_categ->expand) continue;
 
-						//Test whether the sort is enabled.
-						if(essence_->lister.sort_index() != npos)
-						{
-							std::size_t size = i_categ->items.size();
-							for(std::size_t pos = 0; pos < size; ++pos)
-							{
-								if(n-- == 0)	break;
-								state = (tracker.first == catg_idx && tracker.second == item_idx	?
-									essence_t::state_t::highlighted : essence_t::state_t::normal);
-
-								_m_draw_item(i_categ->items[lister.absolute(catg_idx, pos)], x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
-								y += essence_->item_size;
-								++item_idx;
-							}
-						}
-						else
+						std::size_t size = lister.size_shown(catg_idx);
+						for(std::size_t pos = 0; pos < size; ++pos)
 						{
-							for(auto & m : i_categ->items)
-							{
-								if(n-- == 0) break;
-
-								state = (tracker.first == catg_idx && tracker.second == item_idx ?
-										essence_t::state_t::highlighted : essence_t::state_t::normal);
-
-								_m_draw_item(m, x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
-								y += essence_->item_size;
+							if(n-- == 0)	break;
+							state = (tracker.first == catg_idx && tracker.second == item_idx	?
+								essence_t::state_t::highlighted : essence_t::state_t::normal);
 
-								++item_idx;
-							}
+							if(in_strip(y))
+								_m_draw_item(*i_categ, lister.absolute(catg_idx, pos), x, y, txtoff, header_w, rect, subitems, bkcolor, txtcolor, state);
+							y += essence_->item_size;
+							++item_idx;
 						}
 					}
 
-					if(y < rect.y + static_cast<int>(rect.height))
-						essence_->graph->rectangle(rect.x, y, rect.width, rect.y + rect.height - y, bkcolor, true);
+					if(y < strip.y)
+						y = strip.y;
+					if(y < strip_end)
+						essence_->graph->rectangle(rect.x, y, rect.width, strip_end - y, bkcolor, true);
+					return true;
 				}
-			private:
+
 				void _m_draw_categ(const es_lister::category& categ, int x, int y, int txtoff, unsigned width, const nana::rectangle& r, nana::color_t bkcolor, essence_t::state_t state) const
 				{
 					bool sel = categ.select();
@@ -1948,7 +3056,8 @@ namespace nana{ namespace gui{
 					graph->string(x + 20, y + txtoff, 0x3399, categ.text);
 
 					std::stringstream ss;
-					ss<<'('<<static_cast<unsigned>(categ.items.size())<<')';
+					//The passed is empty if the filter is not applied.
+					ss<<'('<<static_cast<unsigned>(categ.passed.empty() ? categ.items.size() : categ.shown.size())<<')';
 					nana::string str = nana::charset(ss.str());
 
 					unsigned str_w = graph->text_extent_size(str).width;
@@ -1966,8 +3075,9 @@ namespace nana{ namespace gui{
 					}
 				}
 
-				void _m_draw_item(const es_lister::item_t& item, int x, int y, int txtoff, unsigned width, const nana::rectangle& r, const std::vector<size_type>& seqs, nana::color_t bkcolor, nana::color_t txtcolor, essence_t::state_t state) const
+				void _m_draw_item(const es_lister::category& cat, size_type pos, int x, int y, int txtoff, unsigned width, const nana::rectangle& r, const std::vector<size_type>& seqs, nana::color_t bkcolor, nana::color_t txtcolor, essence_t::state_t state) const
 				{
+					auto & item = cat.items[pos];
 					if(item.flags.selected)
 						bkcolor = 0xD5EFFC;
 					else if((item.bkcolor & 0xFF000000) == 0)
@@ -1995,7 +3105,7 @@ namespace nana{ namespace gui{
 					{
 						const es_header::item_t & header = essence_->header.get_item(index);
 
-						if((item.texts.size() > index) && (header.pixels > 5))
+						if(cat.columns.exists(pos, index) && (header.pixels > 5))
 						{
 							int ext_w = 0;
 							if(first && essence_->checkable)
@@ -2023,14 +3133,18 @@ namespace nana{ namespace gui{
 								crook_renderer_.check(item.flags.checked ?  state::checked : state::unchecked);
 								crook_renderer_.draw(*graph, bkcolor, txtcolor, chkarea, estate);
 							}
-							nana::size ts = graph->text_extent_size(item.texts[index]);
+							auto text = cat.columns.text(pos, index);
+							nana::size ts;
+							if(text.size())
+								ts = graph->text_extent_size(text.begin, text.size());
 
 							if((0 == index) && essence_->if_image)
 							{
 								ext_w += 18;
 								item.img.stretch(nana::rectangle(), *graph, nana::rectangle(item_xpos + 5, y + img_off, 16, 16));
 							}
-							graph->string(item_xpos + 5 + ext_w, y + txtoff, txtcolor, item.texts[index]);
+							if(text.size())
+								graph->string(item_xpos + 5 + ext_w, y + txtoff, txtcolor, text.begin, text.size());
 
 							if(ts.width + 5 + ext_w > header.pixels)
 							{//The text is painted over the next subitem
@@ -2103,6 +3217,18 @@ namespace nana{ namespace gui{
 					_m_draw_border();
 				}
 
+				//Draws the listbox after a vertical scrolling, the items which are still visible are not drawn again.
+				void trigger::_m_draw_scrolled()
+				{
+					nana::rectangle r;
+
+					if(essence_->header.visible() && essence_->rect_header(r))
+						drawer_header_->draw(r);
+					if(essence_->rect_lister(r) && (false == drawer_lister_->scroll(r)))
+						drawer_lister_->draw(r);
+					_m_draw_border();
+				}
+
 				void trigger::_m_draw_border()
 				{
 					auto & graph = *essence_->graph;
@@ -2154,7 +3280,10 @@ namespace nana{ namespace gui{
 
 				void trigger::refresh(graph_reference)
 				{
-					draw();
+					if(essence_->scrolling)
+						_m_draw_scrolled();
+					else
+						draw();
 				}
 
 				void trigger::mouse_move(graph_reference graph, const eventinfo& ei)
@@ -2335,7 +3464,7 @@ namespace nana{ namespace gui{
 				{
 					if(essence_->wheel(ei.wheel.upwards))
 					{
-						draw();
+						_m_draw_scrolled();
 						essence_->adjust_scroll_value();
 						API::lazy_refresh();
 					}
@@ -2630,7 +3759,7 @@ namespace nana{ namespace gui{
 					auto wd = ess_->lister.wd_ptr();
 					if(wd && !(API::empty_window(wd->handle())))
 					{
-						auto & m = ess_->lister.at(pos_, ess_->lister.size_item(pos_) - 1);
+						auto & m = ess_->lister.at_abs(pos_, ess_->lister.size_item(pos_) - 1);
 						m.bkcolor = wd->background();
 						m.fgcolor = wd->foreground();
 						ess_->update();
@@ -2643,13 +3772,32 @@ namespace nana{ namespace gui{
 					auto wd = ess_->lister.wd_ptr();
 					if(wd && !(API::empty_window(wd->handle())))
 					{
-						auto & m = ess_->lister.at(pos_, ess_->lister.size_item(pos_) - 1);
+						auto & m = ess_->lister.at_abs(pos_, ess_->lister.size_item(pos_) - 1);
 						m.bkcolor = wd->background();
 						m.fgcolor = wd->foreground();
 						ess_->update();
 					}
 				}
 
+				void cat_proxy::append_bulk(std::vector<std::vector<nana::string> >&& rows)
+				{
+					if(rows.empty())
+						return;
+
+					color_t bkcolor = 0xFF000000, fgcolor = 0xFF000000;
+					auto wd = ess_->lister.wd_ptr();
+					bool visible = (wd && !(API::empty_window(wd->handle())));
+					if(visible)
+					{
+						bkcolor = wd->background();
+						fgcolor = wd->foreground();
+					}
+
+					ess_->lister.push_back(pos_, std::move(rows), bkcolor, fgcolor);
+					if(visible)
+						ess_->update();
+				}
+
 				//Behavior of a container
 				item_proxy cat_proxy::begin() const
 				{
@@ -2686,6 +3834,13 @@ namespace nana{ namespace gui{
 					return ess_->lister.size_item(pos_);
 				}
 
+				std::size_t cat_proxy::displayed(std::size_t display_pos) const
+				{
+					if(display_pos >= ess_->lister.size_shown(pos_))
+						return npos;
+					return ess_->lister.absolute(pos_, display_pos);
+				}
+
 				// Behavior of Iterator
 				cat_proxy& cat_proxy::operator=(const cat_proxy& r)
 				{
@@ -2830,7 +3985,7 @@ namespace nana{ namespace gui{
 				window wd = handle();
 				if(false == API::empty_window(wd))
 				{
-					auto & item = ess.lister.at(cat, index);
+					auto & item = ess.lister.at_abs(cat, index);
 					item.bkcolor = API::background(wd);
 					item.fgcolor = API::foreground(wd);
 					ess.update();
@@ -2937,6 +4092,90 @@ namespace nana{ namespace gui{
 			get_drawer_trigger().essence().header.get_item(sub).weak_ordering = std::move(strick_ordering);
 		}
 
+		void listbox::filter(std::function<bool(item_proxy)> pred)
+		{
+			auto & ess = get_drawer_trigger().essence();
+			if(pred)
+			{
+				auto ess_ptr = &ess;
+				ess.lister.filter([ess_ptr, pred](size_type cat, const drawerbase::listbox::es_lister::category&, size_type index)
+					{
+						return pred(item_proxy(ess_ptr, cat, index));
+					});
+			}
+			else
+				ess.lister.filter(nullptr);
+
+			ess.scroll_y(nana::upoint(0, 0));
+			ess.update();
+		}
+
+		void listbox::filter(const nana::string& text, const std::vector<size_type>& columns, bool case_sensitive)
+		{
+			auto & ess = get_drawer_trigger().essence();
+			ess.lister.filter(text, columns, case_sensitive);
+			ess.scroll_y(nana::upoint(0, 0));
+			ess.update();
+		}
+
+		void listbox::filter_regex(const nana::string& pattern, const std::vector<size_type>& columns)
+		{
+			auto & ess = get_drawer_trigger().essence();
+			ess.lister.filter(std::basic_regex<nana::char_t>(pattern), columns);
+			ess.scroll_y(nana::upoint(0, 0));
+			ess.update();
+		}
+
+		void listbox::clear_filter()
+		{
+			auto & ess = get_drawer_trigger().essence();
+			if(ess.lister.filtered())
+			{
+				ess.lister.filter(nullptr);
+				ess.scroll_y(nana::upoint(0, 0));
+				ess.update();
+			}
+		}
+
+		bool listbox::filtered() const
+		{
+			return get_drawer_trigger().essence().lister.filtered();
+		}
+
+		void listbox::filter_index(bool enable)
+		{
+			get_drawer_trigger().essence().lister.filter_index(enable);
+		}
+
+		void listbox::sort_col(size_type sub, bool reverse)
+		{
+			auto & ess = get_drawer_trigger().essence();
+			ess.lister.sort_index(sub, reverse);
+			ess.update();
+		}
+
+		auto listbox::sort_col() const -> size_type
+		{
+			return get_drawer_trigger().essence().lister.sort_index();
+		}
+
+		void listbox::set_sort_key(size_type sub, sort_kinds::t kind)
+		{
+			set_sort_key(sub, drawerbase::listbox::sort_key_extractors::fetch(kind));
+		}
+
+		void listbox::set_sort_key(size_type sub, std::function<sort_key(const nana::string&, nana::any*)> key_extractor)
+		{
+			auto & ess = get_drawer_trigger().essence();
+			ess.header.get_item(sub).key_extractor = std::move(key_extractor);
+			ess.lister.reset_keys(sub);
+			if(ess.lister.sort_index() == sub)
+			{
+				ess.lister.sort();
+				ess.update();
+			}
+		}
+
 		auto listbox::selected() const -> selection
 		{
 			selection s;
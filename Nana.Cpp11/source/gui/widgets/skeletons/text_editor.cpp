@@ -1222,9 +1222,7 @@ namespace nana{	namespace gui{	namespace widgets
 		void text_editor::_m_draw_string(int top, unsigned color, std::size_t textline, bool if_mask) const
 		{
 			const string_type& linestr = textbase_.getline(textline);
-			unicode_bidi bidi;
-			std::vector<unicode_bidi::entity> reordered;
-			bidi.linestr(linestr.c_str(), linestr.size(), reordered);
+			const std::vector<unicode_bidi::entity> & reordered = bidi_.linestr(linestr.c_str(), linestr.size());
 
 			int x = text_area_.area.x - points_.offset.x;
 			int xend = text_area_.area.x + static_cast<int>(text_area_.area.width);
@@ -1565,9 +1563,7 @@ namespace nana{	namespace gui{	namespace widgets
 				x += (points_.offset.x - text_area_.area.x);
 				if(x > 0)
 				{
-					unicode_bidi bidi;
-					std::vector<unicode_bidi::entity> reordered;
-					bidi.linestr(lnstr.c_str(), lnstr.size(), reordered);
+					const std::vector<unicode_bidi::entity> & reordered = bidi_.linestr(lnstr.c_str(), lnstr.size());
 
 					int xbeg = 0;
 					for(auto & ent : reordered)
@@ -1629,11 +1625,8 @@ namespace nana{	namespace gui{	namespace widgets
 
 		unsigned text_editor::_m_pixels_by_char(std::size_t textline, std::size_t pos) const
 		{
-			unicode_bidi bidi;
-			std::vector<unicode_bidi::entity> reordered;
-
 			const nana::string& lnstr = textbase_.getline(textline);
-			bidi.linestr(lnstr.c_str(), lnstr.size(), reordered);
+			const std::vector<unicode_bidi::entity> & reordered = bidi_.linestr(lnstr.c_str(), lnstr.size());
 			const nana::char_t * ch = (pos <= lnstr.size() ? lnstr.c_str() + pos : 0);
 
 			unsigned text_w = 0;
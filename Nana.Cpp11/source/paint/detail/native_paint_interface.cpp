@@ -163,7 +163,8 @@ namespace detail
 			return nana::size(size.cx, size.cy);
 #elif defined(NANA_X11)
 	#if defined(NANA_UNICODE)
-		std::string utf8str = nana::charset(nana::string(text, len));
+		std::string utf8str;
+		nana::utf::append_utf8(utf8str, text, len);
 		XGlyphInfo ext;
 		XftFont * fs = reinterpret_cast<XftFont*>(dw->font->handle);
 		::XftTextExtentsUtf8(nana::detail::platform_spec::instance().open_display(), fs,
@@ -201,7 +202,8 @@ namespace detail
 		::TextOut(dw->context, x, y, str, static_cast<int>(len));
 #elif defined(NANA_X11)
 	#if defined(NANA_UNICODE)
-		std::string utf8str = nana::charset(nana::string(str, len));
+		std::string utf8str;
+		nana::utf::append_utf8(utf8str, str, len);
 		XftFont * fs = reinterpret_cast<XftFont*>(dw->font->handle);
 		::XftDrawStringUtf8(dw->xftdraw, &(dw->xft_fgcolor), fs, x, y + fs->ascent,
 							reinterpret_cast<XftChar8*>(const_cast<char*>(utf8str.c_str())), utf8str.size());
@@ -459,10 +459,8 @@ namespace paint
 #if defined NANA_UNICODE
 			if(handle_ && handle_->context && str.size())
 			{
-				std::vector<unicode_bidi::entity> reordered;
 				unicode_bidi bidi;
-				bidi.linestr(str.c_str(), str.size(), reordered);
-				for(auto & i: reordered)
+				for(auto & i: bidi.linestr(str.c_str(), str.size()))
 				{
 					nana::size t = text_extent_size(i.begin, i.end - i.begin);
 					sz.width += t.width;
@@ -521,9 +519,7 @@ namespace paint
 		{
 			int origin_x = x;
 			unicode_bidi bidi;
-			std::vector<unicode_bidi::entity> reordered;
-			bidi.linestr(str, len, reordered);
-			for(auto & i : reordered)
+			for(auto & i : bidi.linestr(str, len))
 			{
 				string(x, y, col, i.begin, i.end - i.begin);
 				x += static_cast<int>(text_extent_size(i.begin, i.end - i.begin).width);
@@ -15,6 +15,22 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <cstring>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <chrono>
+
+#if defined(NANA_MINGW) && defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_mutex.hpp>
+#else
+	#include <mutex>
+#endif
+
+#if defined(NANA_X11)
+	#include <X11/extensions/Xrender.h>
+#endif
 
 #include <nana/paint/detail/image_impl_interface.hpp>
 #include <nana/paint/pixel_buffer.hpp>
@@ -23,6 +39,10 @@
 #endif
 #include <nana/paint/detail/image_bmp.hpp>
 #include <nana/paint/detail/image_ico.hpp>
+#include <nana/paint/detail/image_presentation.hpp>
+#include <nana/paint/detail/native_paint_interface.hpp>
+#include <nana/paint/detail/image_process_provider.hpp>
+#include <nana/gui/layout_utility.hpp>
 
 namespace nana
 {
@@ -122,6 +142,507 @@ namespace paint
 			//end struct handle_deleter
 #endif
 		//end class image_ico
+
+		//class image_presentation
+			//The server_image is created with the presentation and lives as long as it, so the pointer is never changed
+			//while other threads are pasting the image. Its members are accessed under the platform_scope_guard.
+			struct image_presentation::server_image
+			{
+#if defined(NANA_X11)
+				Pixmap	pixmap;		//It is 0 if the pixels are not uploaded.
+				Picture	picture;	//It refers to the pixmap when the image has alpha channel.
+				nana::size	size;
+
+				server_image()
+					: pixmap(0), picture(0)
+				{}
+#endif
+			};
+
+#if defined(NANA_X11)
+			namespace
+			{
+				//The counters are accessed under the platform_scope_guard.
+				image::presentation_statistics& presentation_counters(double*& upload_seconds)
+				{
+					static image::presentation_statistics counters = {0, 0, 0, 0.0};
+					static double seconds = 0.0;
+					upload_seconds = &seconds;
+					return counters;
+				}
+
+				//Returns the format of 32bit ARGB pictures, or nullptr if the XRender extension is not available.
+				XRenderPictFormat * argb_format(Display* disp)
+				{
+					static bool queried = false;
+					static XRenderPictFormat * format = nullptr;
+					if(!queried)
+					{
+						queried = true;
+						int event_base, error_base;
+						if(::XRenderQueryExtension(disp, &event_base, &error_base))
+							format = ::XRenderFindStandardFormat(disp, PictStandardARGB32);
+					}
+					return format;
+				}
+			}
+#endif
+
+			image_presentation::image_presentation()
+				: impl_(new server_image)
+			{}
+
+			image_presentation::~image_presentation()
+			{
+#if defined(NANA_X11)
+				//No other thread refers to a presentation which is being destroyed, the display is not touched
+				//if nothing was uploaded, an image may be destroyed after the platform_spec.
+				if(impl_->pixmap)
+					release();
+#endif
+				delete impl_;
+			}
+
+			bool image_presentation::paste(const pixel_buffer& pixbuf, const nana::rectangle& src_r, drawable_type dw, int x, int y)
+			{
+#if defined(NANA_X11)
+				if(nullptr == dw || pixbuf.empty())
+					return false;
+
+				auto & spec = nana::detail::platform_spec::instance();
+				Display * disp = spec.open_display();
+
+				nana::detail::platform_scope_guard psg;
+
+				const nana::size pxsize = pixbuf.size();
+				if(impl_->pixmap && (impl_->size != pxsize))
+					release();
+
+				XRenderPictFormat * format = nullptr;
+				if(pixbuf.alpha_channel())
+				{
+					format = argb_format(disp);
+					if(nullptr == format)
+						return false;
+				}
+
+				double * upload_seconds;
+				auto & counters = presentation_counters(upload_seconds);
+				if(0 == impl_->pixmap)
+				{
+					auto begin = std::chrono::steady_clock::now();
+
+					const unsigned depth = (format ? 32 : spec.screen_depth());
+					Pixmap pixmap = ::XCreatePixmap(disp, spec.root_window(), pxsize.width, pxsize.height, depth);
+					if(0 == pixmap)
+						return false;
+
+					//The premultiplied pixels are required by XRender, the opaque pixels are uploaded as they are.
+					std::vector<pixel_rgb_t> premultiplied;
+					const pixel_rgb_t * pixels = pixbuf.raw_ptr(0);
+					if(format)
+					{
+						premultiplied.assign(pixels, pixels + pxsize.width * pxsize.height);
+						for(auto & px : premultiplied)
+						{
+							const unsigned alpha = px.u.element.alpha_channel;
+							px.u.element.red = static_cast<unsigned char>(px.u.element.red * alpha / 255);
+							px.u.element.green = static_cast<unsigned char>(px.u.element.green * alpha / 255);
+							px.u.element.blue = static_cast<unsigned char>(px.u.element.blue * alpha / 255);
+						}
+						pixels = premultiplied.data();
+					}
+
+					XImage * img = ::XCreateImage(disp, (format ? nullptr : spec.screen_visual()), depth, ZPixmap, 0, 0, pxsize.width, pxsize.height, 32, 0);
+					if(nullptr == img)
+					{
+						::XFreePixmap(disp, pixmap);
+						return false;
+					}
+					img->data = const_cast<char*>(reinterpret_cast<const char*>(pixels));
+
+					GC gc = ::XCreateGC(disp, pixmap, 0, nullptr);
+					::XPutImage(disp, pixmap, gc, img, 0, 0, 0, 0, pxsize.width, pxsize.height);
+					::XFreeGC(disp, gc);
+
+					img->data = nullptr;	//Set null pointer to avoid XDestroyImage destroyes the buffer.
+					XDestroyImage(img);
+
+					impl_->pixmap = pixmap;
+					impl_->picture = (format ? ::XRenderCreatePicture(disp, pixmap, format, 0, nullptr) : 0);
+					impl_->size = pxsize;
+
+					++counters.uploads;
+					counters.upload_bytes += pixbuf.bytes();
+					*upload_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+					if(*upload_seconds > 0.0)
+						counters.bytes_per_second = counters.upload_bytes / *upload_seconds;
+				}
+				else
+					++counters.cached_pastes;
+
+				if(0 == impl_->picture)
+				{
+					::XCopyArea(disp, impl_->pixmap, dw->pixmap, dw->context, src_r.x, src_r.y, src_r.width, src_r.height, x, y);
+					return true;
+				}
+
+				nana::rectangle s_good_r, d_good_r;
+				if(gui::overlap(src_r, pxsize, nana::rectangle(x, y, src_r.width, src_r.height), paint::detail::drawable_size(dw), s_good_r, d_good_r))
+				{
+					XRenderPictFormat * dw_format = ::XRenderFindVisualFormat(disp, spec.screen_visual());
+					if(nullptr == dw_format)
+						return false;
+
+					Picture dw_picture = ::XRenderCreatePicture(disp, dw->pixmap, dw_format, 0, nullptr);
+					::XRenderComposite(disp, PictOpOver, impl_->picture, 0, dw_picture,
+										s_good_r.x, s_good_r.y, 0, 0, d_good_r.x, d_good_r.y, d_good_r.width, d_good_r.height);
+					::XRenderFreePicture(disp, dw_picture);
+				}
+				return true;
+#else
+				return false;
+#endif
+			}
+
+			void image_presentation::release()
+			{
+#if defined(NANA_X11)
+				Display * disp = nana::detail::platform_spec::instance().open_display();
+				nana::detail::platform_scope_guard psg;
+				if(impl_->pixmap)
+				{
+					if(impl_->picture)
+						::XRenderFreePicture(disp, impl_->picture);
+					::XFreePixmap(disp, impl_->pixmap);
+					impl_->pixmap = 0;
+					impl_->picture = 0;
+				}
+#endif
+			}
+
+			image::presentation_statistics image_presentation::statistics()
+			{
+#if defined(NANA_X11)
+				nana::detail::platform_scope_guard psg;
+				double * upload_seconds;
+				return presentation_counters(upload_seconds);
+#else
+				image::presentation_statistics counters = {0, 0, 0, 0.0};
+				return counters;
+#endif
+			}
+		//end class image_presentation
+
+		namespace
+		{
+			//class variant_store
+			//	The variant_store keeps the stretched results and the half-size levels of all images. The least
+			//	recently used ones are discarded when the size of them exceeds the capacity.
+			class variant_store
+			{
+			public:
+				struct key_type
+				{
+					const scaled_variants * owner;
+					const void * algorithm;	//The stretch algorithm, it is nullptr for a half-size level.
+					nana::rectangle src_r;	//The level number is stored in src_r.x for a half-size level.
+					nana::size dimension;
+
+					bool operator<(const key_type& rhs) const
+					{
+						if(owner != rhs.owner)	return (owner < rhs.owner);
+						if(algorithm != rhs.algorithm)	return (algorithm < rhs.algorithm);
+						if(src_r.x != rhs.src_r.x)	return (src_r.x < rhs.src_r.x);
+						if(src_r.y != rhs.src_r.y)	return (src_r.y < rhs.src_r.y);
+						if(src_r.width != rhs.src_r.width)	return (src_r.width < rhs.src_r.width);
+						if(src_r.height != rhs.src_r.height)	return (src_r.height < rhs.src_r.height);
+						if(dimension.width != rhs.dimension.width)	return (dimension.width < rhs.dimension.width);
+						return (dimension.height < rhs.dimension.height);
+					}
+				};
+
+				struct variant
+				{
+					pixel_buffer pixels;
+					image_presentation presentation;
+				};
+
+				typedef std::shared_ptr<variant> variant_ptr;
+
+				variant_store()
+					: capacity_(16 * 1024 * 1024), bytes_(0)
+				{}
+
+				static variant_store& instance()
+				{
+					//The store is not destroyed at exit, because an image may be destroyed after static objects.
+					static variant_store * object = new variant_store;
+					return *object;
+				}
+
+				std::size_t capacity() const
+				{
+					return capacity_;
+				}
+
+				void capacity(std::size_t bytes)
+				{
+					std::vector<variant_ptr> discarded;
+					std::lock_guard<decltype(mutex_)> lock(mutex_);
+					capacity_ = bytes;
+					_m_shrink(discarded);
+				}
+
+				variant_ptr find(const key_type& key)
+				{
+					std::lock_guard<decltype(mutex_)> lock(mutex_);
+					auto i = table_.find(key);
+					if(i == table_.end())
+						return nullptr;
+
+					//Move the entry to the front, it is the most recently used.
+					entries_.splice(entries_.begin(), entries_, i->second);
+					return i->second->second;
+				}
+
+				void insert(const key_type& key, const variant_ptr& v)
+				{
+					//The discarded variants are destroyed after unlocking, because releasing a server-side
+					//copy locks the platform.
+					std::vector<variant_ptr> discarded;
+					std::lock_guard<decltype(mutex_)> lock(mutex_);
+					if(table_.count(key))
+						return;
+
+					bytes_ += v->pixels.bytes();
+					entries_.push_front(std::make_pair(key, v));
+					table_[key] = entries_.begin();
+					_m_shrink(discarded);
+				}
+
+				void erase(const scaled_variants* owner)
+				{
+					std::vector<variant_ptr> discarded;
+					std::lock_guard<decltype(mutex_)> lock(mutex_);
+					for(auto i = entries_.begin(); i != entries_.end();)
+					{
+						if(i->first.owner == owner)
+						{
+							bytes_ -= i->second->pixels.bytes();
+							discarded.push_back(i->second);
+							table_.erase(i->first);
+							i = entries_.erase(i);
+						}
+						else
+							++i;
+					}
+				}
+			private:
+				void _m_shrink(std::vector<variant_ptr>& discarded)
+				{
+					while((bytes_ > capacity_) && entries_.size())
+					{
+						bytes_ -= entries_.back().second->pixels.bytes();
+						discarded.push_back(entries_.back().second);
+						table_.erase(entries_.back().first);
+						entries_.pop_back();
+					}
+				}
+			private:
+				std::mutex mutex_;
+				std::size_t capacity_;
+				std::size_t bytes_;
+				std::list<std::pair<key_type, variant_ptr>> entries_;
+				std::map<key_type, std::list<std::pair<key_type, variant_ptr>>::iterator> table_;
+			};//end class variant_store
+
+			//Copies a rectangle of pixels into a new pixel buffer.
+			void copy_pixels(const pixel_buffer& src, const nana::rectangle& r, pixel_buffer& dst)
+			{
+				dst.open(r.width, r.height);
+				for(unsigned row = 0; row < r.height; ++row)
+					memcpy(dst.raw_ptr(row), src.raw_ptr(r.y + row) + r.x, r.width * sizeof(pixel_rgb_t));
+			}
+
+			//Makes a half-size level by averaging every 2x2 pixels. The colors of the pixels with alpha channel are
+			//weighted by their alpha, otherwise the colors of the transparent pixels darken the edges of the image.
+			void make_half_level(const pixel_buffer& src, pixel_buffer& dst)
+			{
+				const nana::size sz = src.size();
+				const unsigned width = (sz.width > 1 ? sz.width / 2 : 1);
+				const unsigned height = (sz.height > 1 ? sz.height / 2 : 1);
+				const bool alpha = src.alpha_channel();
+
+				dst.open(width, height);
+				dst.alpha_channel(alpha);
+				for(unsigned row = 0; row < height; ++row)
+				{
+					const pixel_rgb_t * s0 = src.raw_ptr(row * 2 < sz.height ? row * 2 : sz.height - 1);
+					const pixel_rgb_t * s1 = src.raw_ptr(row * 2 + 1 < sz.height ? row * 2 + 1 : sz.height - 1);
+					pixel_rgb_t * d = dst.raw_ptr(row);
+					for(unsigned x = 0; x < width; ++x, ++d)
+					{
+						const unsigned x0 = x * 2;
+						const unsigned x1 = (x0 + 1 < sz.width ? x0 + 1 : x0);
+						const pixel_rgb_t * px[4] = {s0 + x0, s0 + x1, s1 + x0, s1 + x1};
+
+						if(false == alpha)
+						{
+							d->u.element.red = static_cast<unsigned char>((px[0]->u.element.red + px[1]->u.element.red + px[2]->u.element.red + px[3]->u.element.red + 2) >> 2);
+							d->u.element.green = static_cast<unsigned char>((px[0]->u.element.green + px[1]->u.element.green + px[2]->u.element.green + px[3]->u.element.green + 2) >> 2);
+							d->u.element.blue = static_cast<unsigned char>((px[0]->u.element.blue + px[1]->u.element.blue + px[2]->u.element.blue + px[3]->u.element.blue + 2) >> 2);
+							d->u.element.alpha_channel = static_cast<unsigned char>((px[0]->u.element.alpha_channel + px[1]->u.element.alpha_channel + px[2]->u.element.alpha_channel + px[3]->u.element.alpha_channel + 2) >> 2);
+							continue;
+						}
+
+						//Premultiply the colors by the alpha, average them, and then divide them by the average alpha.
+						unsigned red = 0, green = 0, blue = 0, alpha_sum = 0;
+						for(auto p : px)
+						{
+							const unsigned a = p->u.element.alpha_channel;
+							red += p->u.element.red * a;
+							green += p->u.element.green * a;
+							blue += p->u.element.blue * a;
+							alpha_sum += a;
+						}
+
+						if(alpha_sum)
+						{
+							d->u.element.red = static_cast<unsigned char>((red + alpha_sum / 2) / alpha_sum);
+							d->u.element.green = static_cast<unsigned char>((green + alpha_sum / 2) / alpha_sum);
+							d->u.element.blue = static_cast<unsigned char>((blue + alpha_sum / 2) / alpha_sum);
+						}
+						else
+							d->u.element.red = d->u.element.green = d->u.element.blue = 0;
+						d->u.element.alpha_channel = static_cast<unsigned char>((alpha_sum + 2) >> 2);
+					}
+				}
+			}
+
+			//Stretches the pixels with the selected algorithm. The algorithm blends the pixels with alpha channel into
+			//the target, therefore the colors and the alpha channel are stretched separately for the cached result.
+			void stretch_pixels(const pixel_buffer& src, const nana::rectangle& src_r, pixel_buffer& dst, const nana::size& dimension)
+			{
+				auto algorithm = *detail::image_process_provider::instance().stretch();
+				const nana::rectangle dst_r(dimension);
+
+				dst.open(dimension.width, dimension.height);
+				if(false == src.alpha_channel())
+				{
+					algorithm->process(src, src_r, dst, dst_r);
+					return;
+				}
+
+				pixel_buffer opaque;
+				copy_pixels(src, src_r, opaque);
+				algorithm->process(opaque, nana::rectangle(0, 0, src_r.width, src_r.height), dst, dst_r);
+
+				//Stretch the alpha channel as a gray image.
+				for(unsigned row = 0; row < src_r.height; ++row)
+				{
+					for(auto i = opaque.raw_ptr(row), end = i + src_r.width; i != end; ++i)
+						i->u.element.red = i->u.element.green = i->u.element.blue = i->u.element.alpha_channel;
+				}
+
+				pixel_buffer alpha(dimension.width, dimension.height);
+				algorithm->process(opaque, nana::rectangle(0, 0, src_r.width, src_r.height), alpha, dst_r);
+
+				for(unsigned row = 0; row < dimension.height; ++row)
+				{
+					const pixel_rgb_t * a = alpha.raw_ptr(row);
+					for(auto i = dst.raw_ptr(row), end = i + dimension.width; i != end; ++i, ++a)
+						i->u.element.alpha_channel = a->u.element.red;
+				}
+				dst.alpha_channel(true);
+			}
+		}//end unnamed namespace
+
+		//class scaled_variants
+			scaled_variants::~scaled_variants()
+			{
+				release();
+			}
+
+			void scaled_variants::stretch(const pixel_buffer& pixbuf, const nana::rectangle& src_r, drawable_type dw, const nana::rectangle& r)
+			{
+				if(nullptr == dw || pixbuf.empty() || 0 == r.width || 0 == r.height)
+					return;
+
+				const nana::size pxsize = pixbuf.size();
+
+				//The whole target of the visible part of source, it may be partially out of the drawable.
+				nana::rectangle good_src_r, good_dst_r;
+				if(false == gui::overlap(src_r, nana::rectangle(pxsize), good_src_r))
+					return;
+				gui::zoom(src_r, good_src_r, r, good_dst_r);
+				if(0 == good_dst_r.width || 0 == good_dst_r.height)
+					return;
+
+				auto & store = variant_store::instance();
+
+				//A result which takes a large part of the capacity is not cached.
+				const std::size_t bytes = static_cast<std::size_t>(good_dst_r.width) * good_dst_r.height * sizeof(pixel_rgb_t);
+				if(bytes > store.capacity() / 4)
+				{
+					pixbuf.stretch(src_r, dw, r);
+					return;
+				}
+
+				variant_store::key_type key;
+				key.owner = this;
+				key.algorithm = *detail::image_process_provider::instance().stretch();
+				key.src_r = good_src_r;
+				key.dimension = good_dst_r;
+
+				auto v = store.find(key);
+				if(nullptr == v)
+				{
+					//Scale down from the smallest half-size level which is not smaller than the target.
+					const pixel_buffer * level = &pixbuf;
+					nana::rectangle level_r = good_src_r;
+					variant_store::variant_ptr level_holder;
+					for(int n = 1; (level_r.width >= good_dst_r.width * 2) && (level_r.height >= good_dst_r.height * 2); ++n)
+					{
+						variant_store::key_type level_key;
+						level_key.owner = this;
+						level_key.algorithm = nullptr;
+						level_key.src_r.x = n;
+						auto next = store.find(level_key);
+						if(nullptr == next)
+						{
+							next = std::make_shared<variant_store::variant>();
+							make_half_level(*level, next->pixels);
+							store.insert(level_key, next);
+						}
+
+						level_holder = next;
+						level = &next->pixels;
+						level_r.x /= 2;
+						level_r.y /= 2;
+						level_r.width = (level_r.width > 1 ? level_r.width / 2 : 1);
+						level_r.height = (level_r.height > 1 ? level_r.height / 2 : 1);
+					}
+
+					v = std::make_shared<variant_store::variant>();
+					stretch_pixels(*level, level_r, v->pixels, good_dst_r);
+					store.insert(key, v);
+				}
+
+				if(false == v->presentation.paste(v->pixels, nana::rectangle(0, 0, good_dst_r.width, good_dst_r.height), dw, good_dst_r.x, good_dst_r.y))
+					v->pixels.paste(nana::rectangle(0, 0, good_dst_r.width, good_dst_r.height), dw, good_dst_r.x, good_dst_r.y);
+			}
+
+			void scaled_variants::release()
+			{
+				variant_store::instance().erase(this);
+			}
+
+			void scaled_variants::capacity(std::size_t bytes)
+			{
+				variant_store::instance().capacity(bytes);
+			}
+		//end class scaled_variants
 	}
 
 	image::image_impl_interface::~image_impl_interface()
@@ -181,9 +702,15 @@ namespace paint
 		}
 
 		bool image::open(const nana::string& filename)
+		{
+			return open(filename, progress_handler());
+		}
+
+		bool image::open(const nana::string& filename, const progress_handler& handler)
 		{
 			image_ptr_.reset();
 			image::image_impl_interface * helper = nullptr;
+			bool incremental = false;	//Whether the helper reports the progress by itself.
 
 			if(filename.size())
 			{
@@ -201,7 +728,12 @@ namespace paint
 					}
 #if defined(NANA_ENABLE_PNG)
 					else if(STR(".PNG") == suffix)
-						helper = new detail::image_png;
+					{
+						auto png = new detail::image_png;
+						png->progress(handler);
+						helper = png;
+						incremental = true;
+					}
 #endif
 				}
 				
@@ -226,7 +758,19 @@ namespace paint
 				if(helper)
 				{
 					image_ptr_ = std::shared_ptr<image_impl_interface>(helper);
-					return helper->open(filename.data());
+					if(false == helper->open(filename.data()))
+						return false;
+
+					if(handler && !incremental)
+					{
+						decode_progress dp;
+						dp.dimension = helper->size();
+						dp.rows = dp.dimension.height;
+						dp.pass = 0;
+						dp.passes = 1;
+						handler(dp);
+					}
+					return true;
 				}
 			}
 			return false;
@@ -269,6 +813,16 @@ namespace paint
 			if(image_ptr_)
 				image_ptr_->stretch(r_src, dst, r_dst);			
 		}
+
+		image::presentation_statistics image::statistics()
+		{
+			return detail::image_presentation::statistics();
+		}
+
+		void image::stretch_cache_capacity(std::size_t bytes)
+		{
+			detail::scaled_variants::capacity(bytes);
+		}
 	//end class image
 
 }//end namespace paint
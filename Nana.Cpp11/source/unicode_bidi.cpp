@@ -1,4 +1,11 @@
 #include <nana/unicode_bidi.hpp>
+#include <cstring>
+#include <cwchar>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define NANA_UNICODE_BIDI_SSE2
+#endif
 
 namespace nana
 {
@@ -617,15 +624,101 @@ namespace nana
 			return ON;
 		}
 
+		//class lookup_table
+		//	A two-level table of the types of the BMP, it is built from bidi_char_type. The first level maps
+		//	the high byte of a code point to a block of 256 types, the identical blocks are shared.
+		class lookup_table
+		{
+		public:
+			lookup_table()
+			{
+				unsigned char block[256];
+				for(unsigned high = 0; high < 256; ++high)
+				{
+					for(unsigned low = 0; low < 256; ++low)
+						block[low] = static_cast<unsigned char>(bidi_char_type(static_cast<wchar_t>((high << 8) | low)));
+
+					const std::size_t blocks = blocks_.size() / 256;
+					std::size_t pos = 0;
+					while((pos < blocks) && memcmp(&blocks_[pos * 256], block, 256))
+						++pos;
+
+					if(pos == blocks)
+						blocks_.insert(blocks_.end(), block, block + 256);
+					index_[high] = static_cast<unsigned char>(pos);
+				}
+			}
+
+			t type(wchar_t ch) const
+			{
+				const unsigned code = static_cast<unsigned>(ch);
+				if(code > 0xFFFF)
+					return ON;
+				return static_cast<t>(blocks_[(static_cast<std::size_t>(index_[code >> 8]) << 8) | (code & 0xFF)]);
+			}
+		private:
+			unsigned char index_[256];
+			std::vector<unsigned char> blocks_;
+		};
+
+		static const lookup_table table;
+
+		//The characters below U+0590 are neither right-to-left nor arabic numbers nor explicit embeddings.
+		const unsigned ltr_bound = 0x0590;
+
+		//Returns the number of the leading characters which are less than ltr_bound.
+		std::size_t ltr_run(const wchar_t* p, const wchar_t* end)
+		{
+			const wchar_t * const begin = p;
+#if defined(NANA_UNICODE_BIDI_SSE2) && (WCHAR_MAX > 0xFFFF)
+			const __m128i bound = _mm_set1_epi32(ltr_bound);
+			for(; end - p >= 4; p += 4)
+			{
+				//The code points are positive, the signed comparison is safe.
+				if(_mm_movemask_epi8(_mm_cmplt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), bound)) != 0xFFFF)
+					break;
+			}
+#elif defined(NANA_UNICODE_BIDI_SSE2)
+			const __m128i bound = _mm_set1_epi16(static_cast<short>(ltr_bound - 1));
+			const __m128i zero = _mm_setzero_si128();
+			for(; end - p >= 8; p += 8)
+			{
+				//A code unit is less than the bound if the saturated subtraction is zero.
+				__m128i v = _mm_subs_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), bound);
+				if(_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) != 0xFFFF)
+					break;
+			}
+#endif
+			while((p != end) && (static_cast<unsigned>(*p) < ltr_bound))
+				++p;
+			return static_cast<std::size_t>(p - begin);
+		}
 	}
 
 	//class unicode_bidi
 		void unicode_bidi::linestr(const char_type* str, std::size_t len, std::vector<entity> & reordered)
+		{
+			reordered = linestr(str, len);
+		}
+
+		auto unicode_bidi::linestr(const char_type* str, std::size_t len) -> const std::vector<entity>&
 		{
 			levels_.clear();
+			reordered_.clear();
 			const char_type * end = str + len;
 
-			std::vector<remember> stack;
+			if(_m_pure_ltr(str, end))
+			{
+				if(len)
+				{
+					entity e = {str, end, bidi_char::L, 0};
+					reordered_.push_back(e);
+				}
+				return reordered_;
+			}
+
+			std::vector<remember> & stack = stack_;
+			stack.clear();
 			
 			remember cur = {0, directional_override_status::neutral};
 			cur.level = _m_paragraph_level(str, end);
@@ -667,7 +760,8 @@ namespace nana
 						++cur.level;
 					continue;
 				case PDF:
-					if(cur.level)
+					//A PDF without a matching embedding is ignored.
+					if(stack.size())
 					{
 						if(begin_character)
 						{
@@ -722,7 +816,28 @@ namespace nana
 			_m_resolve_weak_types();
 			_m_resolve_neutral_types();
 			_m_resolve_implicit_levels();
-			_m_reordering_resolved_levels(str, reordered);
+			_m_reordering_resolved_levels(str, reordered_);
+			return reordered_;
+		}
+
+		bool unicode_bidi::_m_pure_ltr(const char_type * begin, const char_type * end)
+		{
+			for(begin += bidi_charmap::ltr_run(begin, end); begin != end; ++begin)
+			{
+				if(LRE <= *begin && *begin <= RLO)
+					return false;
+
+				switch(bidi_charmap::table.type(*begin))
+				{
+				case bidi_charmap::R:
+				case bidi_charmap::AL:
+				case bidi_charmap::AN:
+					return false;
+				default:
+					break;
+				}
+			}
+			return true;
 		}
 
 		unsigned unicode_bidi::_m_paragraph_level(const char_type * begin, const char_type * end)
@@ -1086,7 +1201,7 @@ namespace nana
 		
 		unicode_bidi::bidi_char unicode_bidi::_m_char_dir(char_type ch)
 		{
-			bidi_charmap::t type = bidi_charmap::bidi_char_type(ch);
+			bidi_charmap::t type = bidi_charmap::table.type(ch);
 			if (type < bidi_charmap::PDF)
 				return static_cast<bidi_char>(type);
 			if (type < bidi_charmap::B)
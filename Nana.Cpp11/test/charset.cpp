@@ -0,0 +1,212 @@
+#include "catch.hpp"
+#include <nana/charset.hpp>
+#include <nana/system/timepiece.hpp>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	std::u32string decode(const std::string& utf8)
+	{
+		std::u32string dst;
+		nana::utf::append_utf32(dst, utf8.data(), utf8.size());
+		return dst;
+	}
+
+	std::string encode(const std::u32string& utf32)
+	{
+		std::string dst;
+		nana::utf::append_utf8(dst, utf32.data(), utf32.size());
+		return dst;
+	}
+
+	bool valid(const std::string& utf8)
+	{
+		return nana::utf::validate_utf8(utf8.data(), utf8.size());
+	}
+
+	const char32_t fffd = 0xFFFD;
+}
+
+TEST_CASE("Decodes and encodes well-formed UTF-8", "[charset]")
+{
+	//A, e with acute, euro sign, grinning face: 1, 2, 3 and 4 bytes.
+	const std::string utf8 = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+	const std::u32string utf32 = {U'A', 0xE9, 0x20AC, 0x1F600};
+
+	CHECK(valid(utf8));
+	CHECK(decode(utf8) == utf32);
+	CHECK(encode(utf32) == utf8);
+
+	std::wstring wstr;
+	nana::utf::append_wstring(wstr, utf8.data(), utf8.size());
+	std::string back;
+	nana::utf::append_utf8(back, wstr.data(), wstr.size());
+	CHECK(back == utf8);
+
+	//The boundaries of the lengths and the range.
+	const std::u32string bounds = {0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xE000, 0xFFFF, 0x10000, 0x10FFFF};
+	CHECK(decode(encode(bounds)) == bounds);
+	CHECK(valid(encode(bounds)));
+}
+
+TEST_CASE("Appends to the existing contents", "[charset]")
+{
+	std::u32string dst = U"ab";
+	nana::utf::append_utf32(dst, "c\xC3\xA9", 3);
+	CHECK(dst == std::u32string({U'a', U'b', U'c', 0xE9}));
+
+	std::string bytes = "x";
+	const std::u32string code = {0xE9};
+	nana::utf::append_utf8(bytes, code.data(), code.size());
+	CHECK(bytes == "x\xC3\xA9");
+}
+
+TEST_CASE("Rejects overlong forms", "[charset]")
+{
+	//Every byte of an overlong form is replaced, the leads C0 and C1 are never valid.
+	CHECK_FALSE(valid("\xC0\x80"));
+	CHECK(decode("\xC0\x80") == std::u32string(2, fffd));
+
+	CHECK_FALSE(valid("\xC1\xBF"));
+	CHECK(decode("\xC1\xBF") == std::u32string(2, fffd));
+
+	CHECK_FALSE(valid("\xE0\x80\x80"));
+	CHECK(decode("\xE0\x80\x80") == std::u32string(3, fffd));
+
+	CHECK_FALSE(valid("\xE0\x9F\xBF"));
+	CHECK(decode("\xE0\x9F\xBF") == std::u32string(3, fffd));
+
+	CHECK_FALSE(valid("\xF0\x8F\xBF\xBF"));
+	CHECK(decode("\xF0\x8F\xBF\xBF") == std::u32string(4, fffd));
+
+	//The shortest forms of the same code points are valid.
+	CHECK(valid("\xDF\xBF\xE0\xA0\x80\xF0\x90\x80\x80"));
+}
+
+TEST_CASE("Rejects surrogates and code points out of range", "[charset]")
+{
+	CHECK_FALSE(valid("\xED\xA0\x80"));
+	CHECK(decode("\xED\xA0\x80") == std::u32string(3, fffd));
+
+	CHECK_FALSE(valid("\xED\xBF\xBF"));
+	CHECK(decode("a\xED\xBF\xBF" "b") == std::u32string({U'a', fffd, fffd, fffd, U'b'}));
+
+	//U+110000 and the leads F5 to FF.
+	CHECK_FALSE(valid("\xF4\x90\x80\x80"));
+	CHECK(decode("\xF4\x90\x80\x80") == std::u32string(4, fffd));
+	CHECK_FALSE(valid("\xF5\x80\x80\x80"));
+	CHECK_FALSE(valid("\xFF"));
+	CHECK(decode("\xFE\xFF") == std::u32string(2, fffd));
+
+	//The surrogates and the code points out of range are encoded as U+FFFD.
+	const std::u32string codes = {0xD800, 0xDFFF, 0x110000};
+	CHECK(encode(codes) == "\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD");
+}
+
+TEST_CASE("Replaces truncated sequences", "[charset]")
+{
+	//A lead without enough bytes is replaced, then the continuation bytes are replaced one by one.
+	CHECK_FALSE(valid("\xE2\x82"));
+	CHECK(decode("\xE2\x82") == std::u32string(2, fffd));
+
+	CHECK_FALSE(valid("\xF0\x9F\x98"));
+	CHECK(decode("\xF0\x9F\x98") == std::u32string(3, fffd));
+
+	CHECK_FALSE(valid("\xC3"));
+	CHECK(decode("ab\xC3") == std::u32string({U'a', U'b', fffd}));
+
+	//A sequence which is interrupted by an ASCII byte does not swallow it.
+	CHECK_FALSE(valid("\xE2\x82" "A"));
+	CHECK(decode("\xE2\x82" "A") == std::u32string({fffd, fffd, U'A'}));
+
+	//A stray continuation byte.
+	CHECK_FALSE(valid("a\x80" "b"));
+	CHECK(decode("a\x80" "b") == std::u32string({U'a', fffd, U'b'}));
+}
+
+TEST_CASE("An encoded replacement character is valid", "[charset]")
+{
+	CHECK(valid("\xEF\xBF\xBD"));
+	CHECK(decode("\xEF\xBF\xBD") == std::u32string(1, fffd));
+}
+
+TEST_CASE("Counts the leading ASCII bytes across the SIMD blocks", "[charset]")
+{
+	for(std::size_t len = 0; len < 70; ++len)
+	{
+		std::string s(len, 'a');
+		s += "\xC3\xA9";
+		s += std::string(20, 'b');
+		CHECK(nana::utf::ascii_prefix(s.data(), s.size()) == len);
+		CHECK(valid(s));
+
+		std::u32string expected(len, U'a');
+		expected += 0xE9;
+		expected += std::u32string(20, U'b');
+		CHECK(decode(s) == expected);
+		CHECK(encode(expected) == s);
+	}
+
+	const std::string ascii(100, 'z');
+	CHECK(nana::utf::ascii_prefix(ascii.data(), ascii.size()) == ascii.size());
+}
+
+TEST_CASE("Converts UTF-8 by the charset", "[charset]")
+{
+	const std::string utf8 = "A\xC3\xA9\xE2\x82\xAC";
+	std::wstring wstr = nana::charset(utf8, nana::unicode::utf8);
+	CHECK(wstr == L"A\u00E9\u20AC");
+	CHECK(nana::charset(wstr).to_bytes(nana::unicode::utf8) == utf8);
+}
+
+TEST_CASE("Transcodes UTF-8 texts", "[.][benchmark][charset]")
+{
+	const std::size_t bytes = 16 * 1024 * 1024;
+	const unsigned times = 10;
+
+	const char * const samples[] = {
+		"The quick brown fox jumps over the lazy dog. ",
+		"Gr\xC3\xBC\xC3\x9F" "e aus K\xC3\xB6ln, \xC3\xA9t\xC3\xA9 \xC3\xA0 Paris. ",
+		"\xE4\xB8\xAD\xE6\x96\x87\xE6\x96\x87\xE6\x9C\xAC\xE7\x9A\x84\xE6\xB5\x8B\xE8\xAF\x95\xE3\x80\x82"
+	};
+	const char * const names[] = {"ASCII", "Latin", "CJK"};
+
+	std::stringstream ss;
+	for(int k = 0; k < 3; ++k)
+	{
+		std::string text;
+		while(text.size() < bytes)
+			text += samples[k];
+
+		nana::system::timepiece tmpiece;
+		std::wstring wstr;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+		{
+			wstr.clear();
+			nana::utf::append_wstring(wstr, text.data(), text.size());
+		}
+		const double decode_ms = tmpiece.calc() / times;
+
+		std::string back;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+		{
+			back.clear();
+			nana::utf::append_utf8(back, wstr.data(), wstr.size());
+		}
+		const double encode_ms = tmpiece.calc() / times;
+		REQUIRE(back == text);
+
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+			REQUIRE(nana::utf::validate_utf8(text.data(), text.size()));
+		const double validate_ms = tmpiece.calc() / times;
+
+		const double mb = text.size() / (1024.0 * 1024.0);
+		ss<<names[k]<<": "<<mb * 1000 / decode_ms<<" MB/s to wide, "<<mb * 1000 / encode_ms<<" MB/s to UTF-8, "
+			<<mb * 1000 / validate_ms<<" MB/s validated\n";
+	}
+	WARN(ss.str());
+}
@@ -0,0 +1,49 @@
+#include "catch.hpp"
+#include <nana/gui/wvl.hpp>
+#include <nana/system/timepiece.hpp>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	//Raises an event repeatedly, it returns the number of events per second.
+	double dispatch(nana::gui::window wd, unsigned times)
+	{
+		nana::gui::eventinfo ei;
+		ei.mouse.x = ei.mouse.y = 0;
+		ei.mouse.left_button = ei.mouse.right_button = ei.mouse.mid_button = false;
+		ei.mouse.shift = ei.mouse.ctrl = false;
+
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+			nana::gui::API::raise_event<nana::gui::events::mouse_move>(wd, ei);
+		const double ms = tmpiece.calc();
+		return (ms > 0 ? times * 1000.0 / ms : 0);
+	}
+}
+
+TEST_CASE("Dispatches events to 0, 1 and 10 handlers", "[.][benchmark][events]")
+{
+	nana::gui::form fm;
+	const unsigned times = 200000;
+
+	std::size_t calls = 0;
+	std::stringstream ss;
+	std::vector<nana::gui::event_handle> handles;
+	const std::size_t counts[] = {0, 1, 10};
+	for(auto count : counts)
+	{
+		while(handles.size() < count)
+			handles.push_back(fm.make_event<nana::gui::events::mouse_move>([&calls]{ ++calls; }));
+
+		calls = 0;
+		const double rate = dispatch(fm, times);
+		CHECK(calls == count * times);
+		ss<<count<<" handlers: "<<rate<<" mouse_move events per second through API::raise_event\n";
+	}
+	WARN(ss.str());
+
+	for(auto h : handles)
+		nana::gui::API::umake_event(h);
+}
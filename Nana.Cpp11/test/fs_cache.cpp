@@ -0,0 +1,259 @@
+#include "catch.hpp"
+#include <nana/config.hpp>
+
+#if defined(NANA_LINUX)
+#include <nana/gui/detail/fs_cache.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+
+namespace
+{
+	using nana::gui::detail::fs_cache;
+	using nana::gui::detail::item_fs;
+
+	//A temporary directory which is removed with its contents.
+	class temp_dir
+	{
+	public:
+		temp_dir()
+		{
+			char name[] = "/tmp/nana_fs_cache_XXXXXX";
+			if(::mkdtemp(name))
+				path_ = name;
+		}
+
+		~temp_dir()
+		{
+			if(path_.size())
+				_m_remove(path_);
+		}
+
+		bool good() const
+		{
+			return (path_.size() != 0);
+		}
+
+		//The path which is used by the cache, it ends with a slash.
+		nana::string path() const
+		{
+			return nana::charset(path_ + "/");
+		}
+
+		void make_file(const std::string& name) const
+		{
+			std::ofstream ofs(path_ + "/" + name);
+			ofs<<name;
+		}
+
+		void make_dir(const std::string& name) const
+		{
+			::mkdir((path_ + "/" + name).c_str(), 0755);
+		}
+
+		void remove(const std::string& name) const
+		{
+			_m_remove(path_ + "/" + name);
+		}
+	private:
+		static void _m_remove(const std::string& path)
+		{
+			DIR * dir = ::opendir(path.c_str());
+			if(nullptr == dir)
+			{
+				std::remove(path.c_str());
+				return;
+			}
+
+			while(auto ent = ::readdir(dir))
+			{
+				const std::string name = ent->d_name;
+				if(name != "." && name != "..")
+					_m_remove(path + "/" + name);
+			}
+			::closedir(dir);
+			::rmdir(path.c_str());
+		}
+	private:
+		std::string path_;
+	};
+
+	//Watches a directory and stores the listing of its entries, like a filebox which scans it.
+	void cache_listing(fs_cache& cache, const temp_dir& dir, const std::vector<std::string>& names)
+	{
+		cache.watch(dir.path());
+
+		std::vector<item_fs> items;
+		for(auto & name : names)
+		{
+			item_fs m;
+			if(fs_cache::stat_entry(dir.path(), nana::charset(name), m))
+				nana::gui::detail::insert_fs(items, m);
+		}
+		cache.store(dir.path(), items);
+	}
+
+	std::vector<nana::string> names_of(const std::vector<item_fs>& items)
+	{
+		std::vector<nana::string> names;
+		for(auto & m : items)
+			names.push_back(m.name);
+		return names;
+	}
+
+	bool directories_first(const std::vector<item_fs>& items)
+	{
+		return std::is_partitioned(items.begin(), items.end(), [](const item_fs& m){ return m.directory; });
+	}
+}
+
+TEST_CASE("Applies the changes of a cached directory to its listing", "[fs_cache]")
+{
+	temp_dir dir;
+	REQUIRE(dir.good());
+	dir.make_file("a");
+	dir.make_file("b");
+	dir.make_dir("d");
+
+	fs_cache cache;
+	std::vector<item_fs> items;
+	CHECK_FALSE(cache.fetch(dir.path(), items));
+
+	cache_listing(cache, dir, {"a", "b", "d"});
+	REQUIRE(cache.fetch(dir.path(), items));
+	CHECK(names_of(items) == std::vector<nana::string>({STR("d"), STR("a"), STR("b")}));
+
+	//A new directory is inserted before the files, a new file is appended.
+	dir.make_file("c");
+	dir.remove("a");
+	dir.make_dir("e");
+
+	REQUIRE(cache.fetch(dir.path(), items));
+	CHECK(names_of(items) == std::vector<nana::string>({STR("d"), STR("e"), STR("b"), STR("c")}));
+	CHECK(directories_first(items));
+
+	//An entry which is replaced by a directory is moved among the directories.
+	dir.remove("b");
+	dir.make_dir("b");
+
+	REQUIRE(cache.fetch(dir.path(), items));
+	CHECK(names_of(items) == std::vector<nana::string>({STR("d"), STR("e"), STR("b"), STR("c")}));
+	CHECK(items[2].directory);
+
+	//The hidden entries are not reported.
+	dir.make_file(".hidden");
+	REQUIRE(cache.fetch(dir.path(), items));
+	CHECK(4 == items.size());
+}
+
+TEST_CASE("Drops a directory which is changed too much", "[fs_cache]")
+{
+	temp_dir dir;
+	REQUIRE(dir.good());
+
+	fs_cache cache;
+	const std::size_t listener = cache.listen();
+	cache_listing(cache, dir, {});
+
+	std::vector<item_fs> items;
+	REQUIRE(cache.fetch(dir.path(), items));
+	CHECK(items.empty());
+
+	for(int i = 0; i < 100; ++i)
+		dir.make_file("f" + std::to_string(i));
+
+	std::vector<fs_cache::change> changes;
+	cache.poll(listener, changes);
+	REQUIRE(1 == changes.size());
+	CHECK(changes[0].path == dir.path());
+	CHECK(changes[0].name.empty());
+	CHECK_FALSE(cache.fetch(dir.path(), items));
+}
+
+TEST_CASE("Queues the changes for every listener", "[fs_cache]")
+{
+	temp_dir dir;
+	REQUIRE(dir.good());
+
+	fs_cache cache;
+	const std::size_t first = cache.listen();
+	const std::size_t second = cache.listen();
+	CHECK(first != second);
+	cache_listing(cache, dir, {});
+
+	dir.make_file("x");
+
+	//The events are read by the first poll, the changes are kept for the second listener until it polls.
+	std::vector<fs_cache::change> changes;
+	cache.poll(first, changes);
+	REQUIRE(1 == changes.size());
+	CHECK(changes[0].path == dir.path());
+	CHECK(changes[0].name == STR("x"));
+
+	changes.clear();
+	cache.poll(first, changes);
+	CHECK(changes.empty());
+
+	cache.poll(second, changes);
+	REQUIRE(1 == changes.size());
+	CHECK(changes[0].name == STR("x"));
+
+	//A listener which is removed is not queued.
+	cache.unlisten(second);
+	dir.make_file("y");
+
+	changes.clear();
+	cache.poll(first, changes);
+	REQUIRE(1 == changes.size());
+	CHECK(changes[0].name == STR("y"));
+
+	changes.clear();
+	cache.poll(second, changes);
+	CHECK(changes.empty());
+}
+
+TEST_CASE("Drops every listing when the events overflow", "[fs_cache]")
+{
+	temp_dir busy, quiet;
+	REQUIRE(busy.good());
+	REQUIRE(quiet.good());
+
+	std::size_t max_events = 16384;
+	std::ifstream ifs("/proc/sys/fs/inotify/max_queued_events");
+	ifs>>max_events;
+
+	fs_cache cache;
+	const std::size_t listener = cache.listen();
+	cache_listing(cache, busy, {});
+	cache_listing(cache, quiet, {});
+
+	//Every new file makes two events, IN_CREATE and IN_CLOSE_WRITE, the queue of inotify overflows.
+	for(std::size_t i = 0; i < max_events / 2 + 16; ++i)
+		busy.make_file("f" + std::to_string(i));
+
+	std::vector<fs_cache::change> changes;
+	cache.poll(listener, changes);
+
+	//Every cached directory is reported as changed, the unchanged one included.
+	bool busy_changed = false, quiet_changed = false;
+	for(auto & ch : changes)
+	{
+		CHECK(ch.name.empty());
+		busy_changed |= (ch.path == busy.path());
+		quiet_changed |= (ch.path == quiet.path());
+	}
+	CHECK(busy_changed);
+	CHECK(quiet_changed);
+
+	std::vector<item_fs> items;
+	CHECK_FALSE(cache.fetch(busy.path(), items));
+	CHECK_FALSE(cache.fetch(quiet.path(), items));
+
+	//A directory is cached again after it is dropped.
+	cache_listing(cache, quiet, {});
+	CHECK(cache.fetch(quiet.path(), items));
+}
+#endif
@@ -0,0 +1,156 @@
+#include "catch.hpp"
+#include <nana/paint/image.hpp>
+#include <nana/system/timepiece.hpp>
+#include <nana/charset.hpp>
+#include "utility.hpp"
+#include <png.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//Draws a grid of thumbnails of the image, it returns the milliseconds per redraw.
+	double redraw_grid(const nana::paint::image& img, nana::paint::graphics& graph, unsigned redraws)
+	{
+		const unsigned columns = 8, rows = 6;
+		const unsigned thumb_w = graph.width() / columns, thumb_h = graph.height() / rows;
+
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		for(unsigned n = 0; n < redraws; ++n)
+		{
+			for(unsigned r = 0; r < rows; ++r)
+				for(unsigned c = 0; c < columns; ++c)
+					img.stretch(nana::rectangle(img.size()), graph, nana::rectangle(c * thumb_w, r * thumb_h, thumb_w, thumb_h));
+		}
+		return tmpiece.calc() / redraws;
+	}
+
+	//Writes an 8-bit RGBA PNG file of a gradient, it is compressed fast because only the decoding is measured.
+	bool write_png(const char* file, unsigned width, unsigned height)
+	{
+		FILE * fp = std::fopen(file, "wb");
+		if(nullptr == fp)
+			return false;
+
+		png_structp png_ptr = ::png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+		png_infop info_ptr = (png_ptr ? ::png_create_info_struct(png_ptr) : nullptr);
+		bool written = false;
+		if(info_ptr && !setjmp(png_jmpbuf(png_ptr)))
+		{
+			::png_init_io(png_ptr, fp);
+			::png_set_compression_level(png_ptr, 1);
+			::png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+			::png_write_info(png_ptr, info_ptr);
+
+			std::vector<png_byte> row(width * 4);
+			for(unsigned y = 0; y < height; ++y)
+			{
+				for(unsigned x = 0; x < width; ++x)
+				{
+					row[x * 4] = static_cast<png_byte>(x * 255 / width);
+					row[x * 4 + 1] = static_cast<png_byte>(y * 255 / height);
+					row[x * 4 + 2] = static_cast<png_byte>((x ^ y) & 0xFF);
+					row[x * 4 + 3] = 0xFF;
+				}
+				::png_write_row(png_ptr, row.data());
+			}
+			::png_write_end(png_ptr, nullptr);
+			written = true;
+		}
+		if(png_ptr)
+			::png_destroy_write_struct(&png_ptr, (info_ptr ? &info_ptr : nullptr));
+		std::fclose(fp);
+		return written;
+	}
+
+	//Returns a size in kB of /proc/self/status, such as VmRSS or VmHWM, or 0 if it is not available.
+	std::size_t status_kb(const std::string& name)
+	{
+		std::ifstream ifs("/proc/self/status");
+		std::string line;
+		while(std::getline(ifs, line))
+		{
+			if(line.compare(0, name.size() + 1, name + ":") == 0)
+				return std::stoul(line.substr(name.size() + 1));
+		}
+		return 0;
+	}
+
+	//Resets the peak resident size of the process to the current one, it returns false if it is not supported.
+	bool reset_peak_memory()
+	{
+		std::ofstream ofs("/proc/self/clear_refs");
+		ofs<<"5";
+		ofs.flush();
+		return ofs.good();
+	}
+}
+
+TEST_CASE("Redraws a grid of thumbnails", "[.][benchmark][image]")
+{
+	const char* file = "nana_test_thumbnail.bmp";
+	test::write_bmp(file, 1600, 1200);
+
+	nana::paint::image img;
+	REQUIRE(img.open(nana::charset(std::string(file))));
+
+	nana::paint::graphics graph(1024, 576);
+	const unsigned redraws = 20;
+
+	//The capacity 0 disables the stretch cache, every redraw stretches the full size image.
+	nana::paint::image::stretch_cache_capacity(0);
+	double uncached = redraw_grid(img, graph, redraws);
+
+	nana::paint::image::stretch_cache_capacity(16 * 1024 * 1024);
+	redraw_grid(img, graph, 1);
+	double cached = redraw_grid(img, graph, redraws);
+
+	WARN("thumbnail grid of 48: "<<uncached<<" ms per redraw uncached, "<<cached<<" ms per redraw cached");
+
+	img.close();
+	std::remove(file);
+}
+
+TEST_CASE("Decodes an 8k x 8k PNG file", "[.][benchmark][image]")
+{
+	const char* file = "nana_test_8k.png";
+	const unsigned side = 8192;
+	REQUIRE(write_png(file, side, side));
+
+	nana::paint::image img;
+	nana::system::timepiece tmpiece;
+	double first_rows = 0;
+	unsigned reports = 0;
+
+	const bool peak_supported = reset_peak_memory();
+	const std::size_t rss_before = status_kb("VmRSS");
+
+	tmpiece.start();
+	REQUIRE(img.open(nana::charset(std::string(file)), [&](const nana::paint::image::decode_progress& dp)
+	{
+		if(0 == reports++)
+			first_rows = tmpiece.calc();
+		CHECK(dp.dimension.width == side);
+	}));
+	const double total = tmpiece.calc();
+	const std::size_t peak = status_kb("VmHWM");
+
+	REQUIRE(img.size() == nana::size(side, side));
+	CHECK(reports == side / 64);
+
+	const double image_mb = side * side * 4 / (1024.0 * 1024.0);
+	if(peak_supported && peak >= rss_before)
+	{
+		const double peak_mb = (peak - rss_before) / 1024.0;
+		WARN(side<<"x"<<side<<" PNG: "<<first_rows<<" ms to the first 64 rows, "<<total<<" ms to decode, peak memory "
+			<<peak_mb<<" MB for a "<<image_mb<<" MB image ("<<peak_mb / image_mb<<"x)");
+	}
+	else
+		WARN(side<<"x"<<side<<" PNG: "<<first_rows<<" ms to the first 64 rows, "<<total<<" ms to decode, the peak memory is not available");
+
+	img.close();
+	std::remove(file);
+}
@@ -0,0 +1,88 @@
+#include "catch.hpp"
+#include <nana/gui/wvl.hpp>
+#include <nana/gui/timer.hpp>
+#include <nana/gui/image_loader.hpp>
+#include <nana/charset.hpp>
+#include "utility.hpp"
+#include <string>
+#include <vector>
+#include <cstdio>
+
+TEST_CASE("Scrolls a gallery while thousands of loads are in flight", "[image_loader]")
+{
+	using nana::gui::image_loader;
+
+	const std::size_t files = 20, loads = 3000, visible = 40, step = 25;
+
+	std::vector<std::string> names;
+	for(std::size_t i = 0; i < files; ++i)
+	{
+		names.push_back("nana_test_loader_" + std::to_string(i) + ".bmp");
+		test::write_bmp(names.back().c_str(), 64 + i, 64);
+	}
+
+	nana::gui::form fm;
+	nana::paint::graphics view(visible * 16, 16);
+
+	std::vector<unsigned> delivered(loads, 0);
+	std::vector<char> canceled(loads, 0);
+	std::size_t failed_images = 0;
+
+	image_loader loader(fm);
+	std::vector<image_loader::ticket> tickets;
+	for(std::size_t i = 0; i < loads; ++i)
+	{
+		tickets.push_back(loader.load(nana::charset(names[i % files]), image_loader::priority::background, [i, &delivered, &failed_images](const nana::paint::image& img)
+		{
+			++delivered[i];
+			if(img.empty())
+				++failed_images;
+		}));
+	}
+
+	//Every tick scrolls the view, the loads scrolled out are canceled and the visible loads are raised.
+	std::size_t top = 0;
+	std::size_t ticks = 0;
+	nana::gui::timer scroller;
+	scroller.interval(5);
+	scroller.make_tick([&]
+	{
+		++ticks;
+		if(top < loads)
+		{
+			for(std::size_t i = top; i < top + step && i < loads; ++i)
+			{
+				if(image_loader::state::pending == tickets[i].status() || image_loader::state::decoding == tickets[i].status())
+				{
+					tickets[i].cancel();
+					canceled[i] = (image_loader::state::canceled == tickets[i].status());
+				}
+			}
+			top += step;
+
+			for(std::size_t i = top; i < top + visible && i < loads; ++i)
+			{
+				tickets[i].priority(image_loader::priority::visible);
+				tickets[i].draw(view, nana::rectangle(static_cast<int>(i - top) * 16, 0, 16, 16));
+			}
+		}
+		else if(0 == loader.outstanding() || ticks > 20000)
+			fm.close();
+	});
+	scroller.enable(true);
+
+	nana::gui::exec();
+
+	CHECK(0 == loader.outstanding());
+	CHECK(0 == failed_images);
+	for(std::size_t i = 0; i < loads; ++i)
+	{
+		if(canceled[i])
+			CHECK(0 == delivered[i]);
+		else
+			CHECK(1 == delivered[i]);
+	}
+
+	for(auto & name : names)
+		std::remove(name.c_str());
+}
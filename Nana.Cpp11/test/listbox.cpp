@@ -0,0 +1,370 @@
+#include "catch.hpp"
+#include <nana/gui/wvl.hpp>
+#include <nana/gui/widgets/listbox.hpp>
+#include <nana/system/timepiece.hpp>
+#include "utility.hpp"
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::vector<std::vector<nana::string> > make_rows(std::size_t from, std::size_t count)
+	{
+		std::vector<std::vector<nana::string> > rows;
+		rows.reserve(count);
+		for(std::size_t i = from; i < from + count; ++i)
+		{
+			rows.emplace_back();
+			rows.back().push_back(std::to_wstring((i * 7919) % 1000003));
+			rows.back().push_back(STR("Item ") + std::to_wstring(i));
+		}
+		return rows;
+	}
+
+	typedef nana::gui::listbox::sort_key sort_key;
+
+	//Returns the texts of a column of the items of the first category, in the order of display.
+	std::vector<nana::string> displayed_texts(nana::gui::listbox& lsbox, std::size_t col = 0)
+	{
+		std::vector<nana::string> texts;
+		auto cat = lsbox.at(0);
+		for(std::size_t i = 0; i < cat.size(); ++i)
+		{
+			const std::size_t pos = cat.displayed(i);
+			if(pos == nana::npos)
+				break;
+			texts.push_back(cat.at(pos).text(col));
+		}
+		return texts;
+	}
+
+	//Appends the texts one by one, every text is an item which is put in the order if the listbox is sorted.
+	void append_texts(nana::gui::listbox& lsbox, const std::vector<nana::string>& texts)
+	{
+		for(auto & text : texts)
+			lsbox.at(0).append_bulk(std::vector<std::vector<nana::string> >(1, std::vector<nana::string>(1, text)));
+	}
+
+	//A key extractor which makes an integer key for a number and a text key for the others.
+	sort_key number_or_text(const nana::string& text, nana::any*)
+	{
+		if(text.size() && text.find_first_not_of(STR("0123456789")) == text.npos)
+			return sort_key(std::stoll(text));
+		return sort_key(text);
+	}
+
+	//A listbox which draws itself into the graphics of its window, the graphics is off-screen and
+	//the drawing is not copied to the screen.
+	class render_listbox
+		: public nana::gui::listbox
+	{
+	public:
+		render_listbox(nana::gui::window wd, const nana::rectangle& r)
+			: nana::gui::listbox(wd, r)
+		{}
+
+		void render()
+		{
+			nana::gui::drawer_trigger & trigger = get_drawer_trigger();
+			trigger.refresh(graph());
+		}
+
+		nana::paint::graphics& graph()
+		{
+			return *nana::gui::API::dev::window_graphics(handle());
+		}
+	};
+}
+
+TEST_CASE("Compares the sort keys of the kinds", "[listbox]")
+{
+	CHECK(sort_key::kinds::integer == sort_key(42).kind());
+	CHECK(sort_key::kinds::integer == sort_key(42ULL).kind());
+	CHECK(sort_key::kinds::real == sort_key(0.5).kind());
+	CHECK(sort_key::kinds::text == sort_key(nana::string(STR("a"))).kind());
+	CHECK(sort_key::kinds::integer == sort_key().kind());
+
+	//The integers beyond 2^53 are not rounded to doubles.
+	const long long big = 9007199254740992LL;
+	CHECK(sort_key(big) < sort_key(big + 1));
+	CHECK(sort_key(big + 1) < sort_key(big + 2));
+	CHECK(-1 == sort_key(-big - 1).compare(sort_key(-big)));
+
+	//An integer and a floating-point number are compared exactly.
+	CHECK(0 == sort_key(2).compare(sort_key(2.0)));
+	CHECK(sort_key(1) < sort_key(1.5));
+	CHECK(sort_key(-1.5) < sort_key(-1));
+	CHECK(sort_key(9007199254740992.0) < sort_key(big + 1));
+	CHECK(sort_key(big + 1) < sort_key(9007199254740994.0));
+	CHECK(sort_key(9223372036854775807LL) < sort_key(1e19));
+	CHECK(sort_key(-1e19) < sort_key(-9223372036854775807LL - 1));
+
+	//A NaN is greater than any number, and the numbers come before the texts.
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	CHECK(sort_key(1e300) < sort_key(nan));
+	CHECK(sort_key(9223372036854775807LL) < sort_key(nan));
+	CHECK(0 == sort_key(nan).compare(sort_key(nan)));
+	CHECK(sort_key(nan) < sort_key(nana::string()));
+	CHECK(sort_key(9223372036854775807LL) < sort_key(nana::string(STR("0"))));
+
+	CHECK(sort_key(nana::string(STR("ab"))) < sort_key(nana::string(STR("b"))));
+	CHECK(0 == sort_key(nana::string(STR("ab"))).compare(sort_key(nana::string(STR("ab")))));
+}
+
+TEST_CASE("Sorts the items by the kinds of the sort keys", "[listbox]")
+{
+	nana::gui::form fm;
+	nana::gui::listbox lsbox(fm, nana::rectangle(0, 0, 400, 300));
+	lsbox.append_header(STR("Key"));
+
+	//The texts are compared by characters, the numbers by their values.
+	append_texts(lsbox, {STR("10"), STR("9"), STR("100"), STR("-2")});
+	lsbox.sort_col(0);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("-2"), STR("10"), STR("100"), STR("9")}));
+
+	lsbox.set_sort_key(0, nana::gui::listbox::sort_kinds::integer);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("-2"), STR("9"), STR("10"), STR("100")}));
+
+	//The integers which are not representable by doubles are in order.
+	lsbox.clear();
+	append_texts(lsbox, {STR("9007199254740993"), STR("9007199254740992"), STR("9007199254740994")});
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("9007199254740992"), STR("9007199254740993"), STR("9007199254740994")}));
+
+	lsbox.clear();
+	lsbox.set_sort_key(0, nana::gui::listbox::sort_kinds::real);
+	append_texts(lsbox, {STR("1e3"), STR("-0.5"), STR("1.5"), STR("0.25")});
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("-0.5"), STR("0.25"), STR("1.5"), STR("1e3")}));
+
+	lsbox.clear();
+	lsbox.set_sort_key(0, nana::gui::listbox::sort_kinds::datetime);
+	append_texts(lsbox, {STR("2014-1-5 10:00"), STR("2013-12-31 23:59:59"), STR("2014-01-05 9:30")});
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("2013-12-31 23:59:59"), STR("2014-01-05 9:30"), STR("2014-1-5 10:00")}));
+}
+
+TEST_CASE("Sorts the numbers before the texts", "[listbox]")
+{
+	nana::gui::form fm;
+	nana::gui::listbox lsbox(fm, nana::rectangle(0, 0, 400, 300));
+	lsbox.append_header(STR("Key"));
+	lsbox.set_sort_key(0, number_or_text);
+
+	append_texts(lsbox, {STR("b"), STR("12"), STR("a"), STR("3")});
+	lsbox.sort_col(0);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("3"), STR("12"), STR("a"), STR("b")}));
+
+	lsbox.sort_col(0, true);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("b"), STR("a"), STR("12"), STR("3")}));
+	lsbox.sort_col(0);
+
+	//The appended and inserted items are put in the order, the other items keep their keys.
+	append_texts(lsbox, {STR("5"), STR("0")});
+	lsbox.at(0).append_bulk(std::vector<std::vector<nana::string> >({{STR("ab")}, {STR("100")}}));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("0"), STR("3"), STR("5"), STR("12"), STR("100"), STR("a"), STR("ab"), STR("b")}));
+
+	lsbox.insert(0, 1, STR("7"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("0"), STR("3"), STR("5"), STR("7"), STR("12"), STR("100"), STR("a"), STR("ab"), STR("b")}));
+
+	//A changed text is moved to its position, an erased item does not change the order of the others.
+	lsbox.at(0).at(0).text(0, STR("4"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("0"), STR("3"), STR("4"), STR("5"), STR("7"), STR("12"), STR("100"), STR("a"), STR("ab")}));
+
+	lsbox.erase(lsbox.at(0).at(2));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("0"), STR("3"), STR("4"), STR("5"), STR("7"), STR("100"), STR("a"), STR("ab")}));
+}
+
+TEST_CASE("Filters the items by a text", "[listbox]")
+{
+	nana::gui::form fm;
+	nana::gui::listbox lsbox(fm, nana::rectangle(0, 0, 400, 300));
+	lsbox.append_header(STR("Name"));
+	lsbox.append_header(STR("Note"));
+
+	auto fruits = lsbox.at(0);
+	fruits.append_bulk(std::vector<std::vector<nana::string> >({
+		{STR("Apple"), STR("red")}, {STR("Banana"), STR("yellow")}, {STR("Pineapple"), STR("APPLE-like")}, {STR("Cherry"), STR("red")}}));
+
+	//The text filter ignores case by default and searches all the columns.
+	lsbox.filter(STR("apple"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Apple"), STR("Pineapple")}));
+
+	lsbox.filter(STR("APPLE"), std::vector<std::size_t>(), true);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Pineapple")}));
+
+	lsbox.filter(STR("red"), std::vector<std::size_t>(1, 0));
+	CHECK(displayed_texts(lsbox).empty());
+
+	//The appended, inserted and changed items are evaluated by the filter.
+	lsbox.filter(STR("an"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Banana")}));
+
+	append_texts(lsbox, {STR("Mango"), STR("Kiwi")});
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Banana"), STR("Mango")}));
+
+	lsbox.insert(0, 0, STR("Orange"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Orange"), STR("Banana"), STR("Mango")}));
+
+	fruits.at(5).text(0, STR("Grape"));
+	fruits.at(6).text(0, STR("Banana"));
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Orange"), STR("Banana"), STR("Banana")}));
+
+	//The filter keeps the order of the sort.
+	lsbox.sort_col(0);
+	CHECK(displayed_texts(lsbox) == std::vector<nana::string>({STR("Banana"), STR("Banana"), STR("Orange")}));
+
+	lsbox.clear_filter();
+	CHECK(7 == displayed_texts(lsbox).size());
+}
+
+TEST_CASE("Filters the items by the n-gram index", "[listbox]")
+{
+	nana::gui::form fm;
+	nana::gui::listbox indexed(fm, nana::rectangle(0, 0, 400, 300));
+	nana::gui::listbox scanned(fm, nana::rectangle(0, 0, 400, 300));
+
+	std::vector<nana::string> texts;
+	for(std::size_t i = 0; i < 500; ++i)
+		texts.push_back(STR("Item ") + std::to_wstring((i * 7919) % 1009));
+
+	for(auto lsbox : {&indexed, &scanned})
+	{
+		lsbox->append_header(STR("Text"));
+		append_texts(*lsbox, texts);
+	}
+	indexed.filter_index(true);
+
+	//The index gives the same results as the scan, the texts shorter than a trigram are scanned.
+	const nana::string searched[] = {STR("100"), STR("ITEM 5"), STR("99"), STR("7"), STR("m 1"), STR("none")};
+	for(auto & text : searched)
+	{
+		indexed.filter(text);
+		scanned.filter(text);
+		CHECK(displayed_texts(indexed) == displayed_texts(scanned));
+	}
+
+	//The index is kept up to date with the items which are inserted, erased and changed.
+	indexed.filter(STR("100"));
+	scanned.filter(STR("100"));
+	for(auto lsbox : {&indexed, &scanned})
+	{
+		lsbox->insert(0, 3, STR("Item 1000"));
+		lsbox->erase(lsbox->at(0).at(10));
+		lsbox->at(0).at(20).text(0, STR("Item 5100"));
+		append_texts(*lsbox, {STR("Item 10077"), STR("Item 8")});
+	}
+	CHECK(displayed_texts(indexed) == displayed_texts(scanned));
+
+	const std::size_t found = displayed_texts(indexed).size();
+	CHECK(found > 3);
+
+	for(auto & text : searched)
+	{
+		indexed.filter(text);
+		scanned.filter(text);
+		CHECK(displayed_texts(indexed) == displayed_texts(scanned));
+	}
+}
+
+TEST_CASE("Filters a large category by a predicate", "[listbox]")
+{
+	nana::gui::form fm;
+	nana::gui::listbox lsbox(fm, nana::rectangle(0, 0, 400, 300));
+	lsbox.append_header(STR("Number"));
+
+	//The category is large enough to be evaluated by multiple threads.
+	const std::size_t total = 100000;
+	lsbox.at(0).append_bulk(make_rows(0, total));
+
+	for(int round = 0; round < 3; ++round)
+	{
+		const std::size_t mod = 3 + round;
+		lsbox.filter([mod](nana::gui::listbox::item_proxy ip)
+			{
+				return (0 == ip.pos().second % mod);
+			});
+		const std::size_t expected = (total + mod - 1) / mod;
+		CHECK(expected == displayed_texts(lsbox).size());
+	}
+
+	//An exception thrown by the predicate in a thread is rethrown to the caller.
+	auto throwing = [](nana::gui::listbox::item_proxy ip) -> bool
+	{
+		if(ip.pos().second == 77777)
+			throw std::runtime_error("filter");
+		return true;
+	};
+	CHECK_THROWS_AS(lsbox.filter(throwing), std::runtime_error&);
+}
+
+TEST_CASE("Loads a million rows into a listbox", "[.][benchmark][listbox]")
+{
+	const std::size_t total = 1000000, singles = 10000, loaded = total + singles;
+
+	nana::gui::form fm;
+	nana::gui::listbox lsbox(fm, nana::rectangle(0, 0, 600, 400));
+	lsbox.append_header(STR("Number"));
+	lsbox.append_header(STR("Text"));
+	lsbox.set_sort_key(0, nana::gui::listbox::sort_kinds::integer);
+
+	std::stringstream ss;
+	const bool sorted[] = {false, true};
+	for(auto sort : sorted)
+	{
+		lsbox.clear();
+		lsbox.sort_col(sort ? 0 : nana::npos);
+
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		lsbox.at(0).append_bulk(make_rows(0, total));
+		const double bulk = tmpiece.calc();
+		REQUIRE(total == lsbox.size_item(0));
+
+		//The rows are appended one by one to the loaded listbox.
+		auto rows = make_rows(total, singles);
+		tmpiece.start();
+		for(auto & row : rows)
+		{
+			std::vector<std::vector<nana::string> > one(1, std::move(row));
+			lsbox.at(0).append_bulk(std::move(one));
+		}
+		const double single = tmpiece.calc();
+		REQUIRE(loaded == lsbox.size_item(0));
+
+		ss<<(sort ? "sorted: " : "unsorted: ")<<bulk<<" ms to append "<<total<<" rows at once, "
+			<<single * 1000 / singles<<" us per row appended one by one\n";
+	}
+	WARN(ss.str());
+}
+
+TEST_CASE("Renders the visible rows of a listbox", "[.][benchmark][listbox]")
+{
+	const unsigned frames = 200;
+
+	nana::gui::form fm(nana::rectangle(0, 0, 1000, 1200));
+	render_listbox lsbox(fm, nana::rectangle(0, 0, 1000, 1200));
+	for(int i = 0; i < 4; ++i)
+		lsbox.append_header(STR("Column ") + std::to_wstring(i), 240);
+
+	std::vector<std::vector<nana::string> > rows;
+	for(std::size_t i = 0; i < 10000; ++i)
+	{
+		rows.emplace_back();
+		for(int col = 0; col < 4; ++col)
+			rows.back().push_back(STR("Cell ") + std::to_wstring(i) + STR(", ") + std::to_wstring(col));
+	}
+	lsbox.at(0).append_bulk(std::move(rows));
+
+	nana::system::timepiece tmpiece;
+	tmpiece.start();
+	for(unsigned n = 0; n < frames; ++n)
+		lsbox.render();
+	const double ms = tmpiece.calc() / frames;
+
+	//A row is 6 pixels taller than the text, the number of rows is approximate because the header is not excluded.
+	const unsigned visible = 1200 / (lsbox.graph().text_extent_size(STR("jH")).height + 6);
+	std::stringstream ss;
+	ss<<ms<<" ms to render a frame, "<<ms * 1000 / visible<<" us per row of 4 cells";
+	WARN(ss.str());
+}
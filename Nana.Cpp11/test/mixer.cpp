@@ -0,0 +1,194 @@
+#include "catch.hpp"
+#include <nana/audio/player.hpp>
+#include <nana/audio/mixer.hpp>
+#include <nana/system/timepiece.hpp>
+#include <nana/charset.hpp>
+#include <sstream>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+namespace
+{
+	void put(std::ofstream& ofs, unsigned value, std::size_t bytes)
+	{
+		for(std::size_t i = 0; i < bytes; ++i)
+			ofs.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+
+	//Writes a stereo PCM WAV file of 44100Hz, the samples are written in the specified bits.
+	void write_wav(const char* file, const std::vector<int>& samples, unsigned bits)
+	{
+		const unsigned bytes = static_cast<unsigned>(samples.size()) * (bits / 8);
+		std::ofstream ofs(file, std::ios::binary);
+		ofs.write("RIFF", 4);
+		put(ofs, 36 + bytes, 4);
+		ofs.write("WAVEfmt ", 8);
+		put(ofs, 16, 4);
+		put(ofs, 1, 2);
+		put(ofs, 2, 2);
+		put(ofs, 44100, 4);
+		put(ofs, 44100 * 2 * (bits / 8), 4);
+		put(ofs, 2 * (bits / 8), 2);
+		put(ofs, bits, 2);
+		ofs.write("data", 4);
+		put(ofs, bytes, 4);
+		for(auto s : samples)
+			put(ofs, static_cast<unsigned>(s), bits / 8);
+	}
+
+	//Reads the 16-bit samples of a WAV file written by mixer::output_file.
+	std::vector<short> read_wav16(const char* file)
+	{
+		std::ifstream ifs(file, std::ios::binary);
+		ifs.seekg(0, std::ios::end);
+		const std::size_t size = static_cast<std::size_t>(ifs.tellg());
+		std::vector<short> samples(size > 44 ? (size - 44) / 2 : 0);
+		ifs.seekg(44, std::ios::beg);
+		if(samples.size())
+			ifs.read(reinterpret_cast<char*>(samples.data()), samples.size() * 2);
+		return samples;
+	}
+
+	//Waits for the completion handlers, it returns false if they are not all invoked in time.
+	struct completion
+	{
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::size_t count;
+
+		completion()
+			: count(0)
+		{}
+
+		nana::audio::player::complete_handler handler()
+		{
+			return [this]
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				++count;
+				cond.notify_all();
+			};
+		}
+
+		bool wait(std::size_t expected, unsigned milliseconds)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			return cond.wait_for(lock, std::chrono::milliseconds(milliseconds), [this, expected]{ return count >= expected; });
+		}
+	};
+}
+
+TEST_CASE("Converts 24-bit samples with their signs", "[mixer]")
+{
+	const char* in = "nana_test_mixer_24.wav";
+	const char* out = "nana_test_mixer_out.wav";
+
+	//Full scale and half scale of both signs, in 24-bit two's complement.
+	const int pattern[] = {0x400000, 0xC00000, 0x7FFFFF, 0x800000, 0, 0xFFFFFF};
+	const short expected[] = {16383, -16383, 32766, -32767, 0, 0};
+
+	std::vector<int> samples;
+	for(int i = 0; i < 1000; ++i)
+		samples.insert(samples.end(), pattern, pattern + 6);
+	write_wav(in, samples, 24);
+
+	REQUIRE(nana::audio::mixer::output_file(nana::charset(std::string(out))));
+	{
+		nana::string file = nana::charset(std::string(in));
+		nana::audio::player pl(file);
+		pl.play();
+	}
+
+	//Changing the output finishes the file.
+	nana::audio::mixer::output_null(false);
+
+	auto mixed = read_wav16(out);
+	REQUIRE(mixed.size() >= samples.size());
+	for(std::size_t i = 0; i < samples.size(); ++i)
+		REQUIRE(expected[i % 6] == mixed[i]);
+
+	std::remove(in);
+	std::remove(out);
+}
+
+TEST_CASE("Invokes the completion handler when a sound is finished", "[mixer]")
+{
+	const char* in = "nana_test_mixer_short.wav";
+	write_wav(in, std::vector<int>(44100 / 10 * 2, 0x1000), 16);
+
+	nana::audio::mixer::output_null(false);
+
+	completion done;
+	nana::string file = nana::charset(std::string(in));
+	nana::audio::player pl(file);
+	for(int i = 0; i < 8; ++i)
+		REQUIRE(pl.play_async(0.5f, done.handler()));
+
+	CHECK(done.wait(8, 5000));
+	pl.close();
+	std::remove(in);
+}
+
+TEST_CASE("Stopping the sounds invokes their handlers and unblocks play", "[mixer]")
+{
+	const char* in = "nana_test_mixer_long.wav";
+	write_wav(in, std::vector<int>(44100 * 30 * 2, 0), 16);
+
+	//A paced output plays the 30 seconds in real time.
+	nana::audio::mixer::output_null(true);
+
+	completion done;
+	nana::string file = nana::charset(std::string(in));
+	nana::audio::player pl(file);
+	REQUIRE(pl.play_async(1.0f, done.handler()));
+
+	nana::system::timepiece tmpiece;
+	tmpiece.start();
+	std::thread blocked([&pl]{ pl.play(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	nana::audio::mixer::stop_all();
+	blocked.join();
+
+	CHECK(tmpiece.calc() < 10000);
+	CHECK(done.wait(1, 1000));
+	CHECK(0 == nana::audio::mixer::statistics().voices);
+
+	nana::audio::mixer::output_null(false);
+	pl.close();
+	std::remove(in);
+}
+
+TEST_CASE("Mixes many voices", "[.][benchmark][mixer]")
+{
+	const char* in = "nana_test_mixer_bench.wav";
+	write_wav(in, std::vector<int>(44100 * 2 * 2, 0x1000), 16);
+
+	nana::audio::mixer::output_null(false);
+	auto before = nana::audio::mixer::statistics();
+
+	completion done;
+	const std::size_t voices = 64;
+	nana::string file = nana::charset(std::string(in));
+	nana::audio::player pl(file);
+	for(std::size_t i = 0; i < voices; ++i)
+		pl.play_async(1.0f / voices, done.handler());
+	REQUIRE(done.wait(voices, 60000));
+
+	auto after = nana::audio::mixer::statistics();
+	const double periods = static_cast<double>(after.periods - before.periods);
+	if(periods)
+	{
+		std::stringstream ss;
+		ss<<voices<<" voices: "<<(after.mix_seconds - before.mix_seconds) / periods * 1000<<" ms to mix a period of "<<after.period_seconds * 1000<<" ms";
+		WARN(ss.str());
+	}
+
+	pl.close();
+	std::remove(in);
+}
@@ -0,0 +1,69 @@
+#include "catch.hpp"
+#include <nana/gui/wvl.hpp>
+#include <nana/gui/place.hpp>
+#include <nana/gui/widgets/button.hpp>
+#include <nana/gui/widgets/label.hpp>
+#include <nana/system/timepiece.hpp>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	//Resizes the form repeatedly, it returns the milliseconds per resize.
+	double resize(nana::gui::form& fm, unsigned times, bool width, bool height)
+	{
+		const nana::size origin = fm.size();
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+		{
+			const unsigned delta = n % 64;
+			fm.size(origin.width + (width ? delta : 0), origin.height + (height ? delta : 0));
+		}
+		const double ms = tmpiece.calc();
+		fm.size(origin.width, origin.height);
+		return ms / times;
+	}
+}
+
+TEST_CASE("Resizes a window which is laid out by place", "[.][benchmark][place]")
+{
+	const unsigned times = 2000;
+
+	nana::gui::form fm(nana::rectangle(0, 0, 1000, 800));
+	nana::gui::place plc(fm);
+	plc.div("<vertical <toolbar weight=30><<sidebar vertical weight=200><content vertical>><status weight=24>>");
+
+	std::vector<std::unique_ptr<nana::gui::widget> > widgets;
+	auto add = [&](const char* field, nana::gui::widget* wd)
+	{
+		widgets.emplace_back(wd);
+		plc.field(field)<<wd->handle();
+	};
+
+	for(int i = 0; i < 40; ++i)
+		add("toolbar", new nana::gui::button(fm, STR("Tool")));
+	for(int i = 0; i < 40; ++i)
+		add("sidebar", new nana::gui::label(fm, STR("Entry")));
+	for(int i = 0; i < 20; ++i)
+		add("content", new nana::gui::button(fm, STR("Content")));
+	add("status", new nana::gui::label(fm, STR("Ready")));
+	plc.collocate();
+
+	//A change of the height keeps the area of the toolbar, a change of the width keeps the area of the sidebar.
+	const double heights = resize(fm, times, false, true);
+	const double widths = resize(fm, times, true, false);
+	const double both = resize(fm, times, true, true);
+
+	nana::system::timepiece tmpiece;
+	tmpiece.start();
+	for(unsigned n = 0; n < times; ++n)
+		plc.collocate();
+	const double full = tmpiece.calc() / times;
+
+	std::stringstream ss;
+	ss<<widgets.size()<<" widgets, ms per resize: "<<heights<<" height only, "<<widths<<" width only, "
+		<<both<<" both, "<<full<<" per collocate of the whole tree";
+	WARN(ss.str());
+}
@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include <nana/gui/widgets/detail/scroll_store.hpp>
+#include <nana/paint/pixel_buffer.hpp>
+#include <nana/system/timepiece.hpp>
+#include <sstream>
+#include <string>
+#include <ctime>
+
+namespace
+{
+	const unsigned row_height = 20;
+
+	//Paints the rows of the content which are in the rectangle r of the view, the top of the view is the origin.
+	void paint_rows(nana::paint::graphics& graph, const nana::rectangle& r, long long origin)
+	{
+		const long long first = (origin + r.y) / row_height;
+		const long long last = (origin + r.y + r.height - 1) / row_height;
+		for(long long row = first; row <= last; ++row)
+		{
+			const int y = static_cast<int>(row * row_height - origin);
+			graph.rectangle(r.x, y, r.width, row_height, (row & 1 ? 0xF0F0F0 : 0xFFFFFF), true);
+			graph.string(r.x + 4, y + 2, 0x0, STR("Row ") + std::to_wstring(row) + STR(" of the content which is scrolled"));
+		}
+	}
+
+	//Scrolls through the content by steps, it returns the milliseconds of CPU time per scroll.
+	double scroll_through(nana::paint::graphics& graph, const nana::rectangle& view, long long total, int step, bool stored)
+	{
+		nana::gui::widgets::detail::scroll_store store;
+		std::clock_t start = std::clock();
+		std::size_t scrolls = 0;
+		for(long long origin = 0; origin + view.height <= total; origin += step, ++scrolls)
+		{
+			//Clip each painted rectangle, so that a row painted for the exposed area does not overwrite the copied rows.
+			auto painter = [&graph, origin](const nana::rectangle& r)
+			{
+				nana::paint::graphics part(r.width, r.height);
+				nana::rectangle local(0, 0, r.width, r.height);
+				paint_rows(part, local, origin + r.y);
+				graph.bitblt(r, part, nana::point());
+			};
+
+			if(false == (stored && store.scroll(graph, view, origin, painter)))
+			{
+				painter(view);
+				if(stored)
+					store.painted(graph, view, origin);
+			}
+		}
+		return (scrolls ? (std::clock() - start) * 1000.0 / CLOCKS_PER_SEC / scrolls : 0);
+	}
+}
+
+TEST_CASE("A scrolled view matches a view painted at once", "[scroll_store]")
+{
+	const nana::rectangle view(0, 0, 300, 200);
+	nana::paint::graphics scrolled(view.width, view.height), painted(view.width, view.height);
+
+	nana::gui::widgets::detail::scroll_store store;
+	paint_rows(scrolled, view, 0);
+	store.painted(scrolled, view, 0);
+
+	//Small steps which are kept in the band, and a jump which moves the band.
+	const long long origins[] = {7, 30, 13, 220, 190, 900, 880};
+	for(auto origin : origins)
+	{
+		REQUIRE(store.scroll(scrolled, view, origin, [&scrolled, origin](const nana::rectangle& r)
+		{
+			nana::paint::graphics part(r.width, r.height);
+			paint_rows(part, nana::rectangle(0, 0, r.width, r.height), origin + r.y);
+			scrolled.bitblt(r, part, nana::point());
+		}));
+
+		paint_rows(painted, view, origin);
+
+		nana::paint::pixel_buffer a(scrolled.handle(), view), b(painted.handle(), view);
+		for(unsigned y = 0; y < view.height; ++y)
+			for(unsigned x = 0; x < view.width; ++x)
+				REQUIRE(a.pixel(x, y).u.color == b.pixel(x, y).u.color);
+	}
+}
+
+TEST_CASE("Scrolls a long view with and without the store", "[.][benchmark][scroll_store]")
+{
+	const nana::rectangle view(0, 0, 600, 400);
+	nana::paint::graphics graph(view.width, view.height);
+	const long long total = 20000LL * row_height;
+
+	//A wheel step scrolls 3 rows, a drag of the scrollbar scrolls a few pixels.
+	std::stringstream ss;
+	const int steps[] = {3 * row_height, 4};
+	for(auto step : steps)
+	{
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		double full = scroll_through(graph, view, total / (step < 10 ? 20 : 1), step, false);
+		double full_wall = tmpiece.calc();
+
+		tmpiece.start();
+		double stored = scroll_through(graph, view, total / (step < 10 ? 20 : 1), step, true);
+		double stored_wall = tmpiece.calc();
+
+		ss<<"step "<<step<<"px: "<<full<<" ms CPU per scroll repainting the view ("<<full_wall<<" ms total), "
+			<<stored<<" ms CPU per scroll with the store ("<<stored_wall<<" ms total)\n";
+	}
+	WARN(ss.str());
+}
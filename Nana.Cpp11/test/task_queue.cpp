@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include <nana/gui/detail/task_queue.hpp>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	//A channel whose wakes fail while the window is not available, like a post_task msg to a destroyed window.
+	class test_channel
+		: public nana::gui::detail::post_channel
+	{
+	public:
+		test_channel()
+			: available(true), wakes(0)
+		{}
+
+		bool available;
+		std::atomic<std::size_t> wakes;
+	private:
+		bool wake()
+		{
+			if(false == available)
+				return false;
+			++wakes;
+			return true;
+		}
+	};
+}
+
+TEST_CASE("Wakes the thread once for the tasks which are posted before they are run", "[task_queue]")
+{
+	test_channel chn;
+	std::size_t runs = 0;
+
+	for(int i = 0; i < 10; ++i)
+		REQUIRE(chn.post(nullptr, 0, [&runs]{ ++runs; }));
+	CHECK(1u == chn.wakes.load());
+
+	CHECK(10u == chn.run());
+	CHECK(10u == runs);
+
+	chn.post(nullptr, 0, [&runs]{ ++runs; });
+	CHECK(2u == chn.wakes.load());
+	chn.run();
+}
+
+TEST_CASE("Tries to wake the thread again after a failed wake", "[task_queue]")
+{
+	test_channel chn;
+	chn.available = false;
+	chn.post(nullptr, 0, []{});
+	CHECK(0u == chn.wakes.load());
+
+	//The failed wake is not remembered as signaled.
+	chn.available = true;
+	chn.post(nullptr, 0, []{});
+	CHECK(1u == chn.wakes.load());
+
+	//The wake is lost, e.g. the window which receives it is destroyed, the rearm wakes the thread again.
+	chn.rearm();
+	CHECK(2u == chn.wakes.load());
+	CHECK(2u == chn.run());
+
+	chn.rearm();
+	CHECK(2u == chn.wakes.load());
+}
+
+TEST_CASE("Coalesces the tasks with the same owner and key", "[task_queue]")
+{
+	test_channel chn;
+	int owner_a, owner_b;
+	std::vector<int> ran;
+
+	chn.post(&owner_a, 1, [&ran]{ ran.push_back(1); });
+	chn.post(&owner_b, 1, [&ran]{ ran.push_back(2); });
+	chn.post(&owner_a, 1, [&ran]{ ran.push_back(3); });
+	chn.post(&owner_a, 0, [&ran]{ ran.push_back(4); });
+	chn.run();
+
+	REQUIRE(3u == ran.size());
+	CHECK(2 == ran[0]);
+	CHECK(3 == ran[1]);
+	CHECK(4 == ran[2]);
+}
+
+TEST_CASE("Discards the tasks which are posted to a closed channel", "[task_queue]")
+{
+	test_channel chn;
+	chn.close();
+	CHECK(false == chn.post(nullptr, 0, []{}));
+	CHECK(chn.empty());
+}
+
+TEST_CASE("Runs every task which is posted by many threads", "[task_queue]")
+{
+	test_channel chn;
+	const std::size_t producers = 4, tasks = 20000;
+	std::size_t runs = 0;
+	std::atomic<std::size_t> finished(0);
+
+	std::vector<std::thread> threads;
+	for(std::size_t i = 0; i < producers; ++i)
+	{
+		threads.push_back(std::thread([&chn, &runs, &finished, tasks]
+		{
+			for(std::size_t n = 0; n < tasks; ++n)
+				chn.post(nullptr, 0, [&runs]{ ++runs; });
+			++finished;
+		}));
+	}
+
+	while(finished < producers || (false == chn.empty()))
+		chn.run();
+
+	for(auto & t : threads)
+		t.join();
+
+	const std::size_t total = producers * tasks;
+	CHECK(total == runs);
+	CHECK(chn.wakes.load() <= total);
+}
@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include <nana/unicode_bidi.hpp>
+#include <nana/system/timepiece.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef nana::unicode_bidi::entity entity;
+
+	std::wstring entity_text(const entity& e)
+	{
+		return std::wstring(e.begin, e.end);
+	}
+
+	//Returns the level of every character of the line.
+	std::vector<unsigned> levels(const std::wstring& line, const std::vector<entity>& ents)
+	{
+		std::vector<unsigned> lv(line.size(), 99);
+		for(auto & e : ents)
+		{
+			for(auto p = e.begin; p != e.end; ++p)
+				lv[p - line.data()] = e.level;
+		}
+		return lv;
+	}
+
+	//Makes the lines of a corpus by repeating the words, every line is about 60 characters.
+	std::vector<std::wstring> make_corpus(const std::vector<std::wstring>& words, std::size_t lines)
+	{
+		std::vector<std::wstring> corpus;
+		std::size_t n = 0;
+		for(std::size_t i = 0; i < lines; ++i)
+		{
+			std::wstring line;
+			while(line.size() < 60)
+			{
+				line += words[n++ % words.size()];
+				line += L' ';
+			}
+			corpus.push_back(line);
+		}
+		return corpus;
+	}
+}
+
+TEST_CASE("Resolves a left-to-right line as a single entity", "[unicode_bidi]")
+{
+	const std::wstring str = L"The quick brown fox, 42 jumps.";
+	nana::unicode_bidi bidi;
+	auto & ents = bidi.linestr(str.data(), str.size());
+
+	REQUIRE(1 == ents.size());
+	CHECK(ents[0].begin == str.data());
+	CHECK(ents[0].end == str.data() + str.size());
+	CHECK(0 == ents[0].level);
+}
+
+TEST_CASE("Resolves the levels of right-to-left runs", "[unicode_bidi]")
+{
+	nana::unicode_bidi bidi;
+
+	//Hebrew only, the paragraph level is 1.
+	const std::wstring hebrew = L"\u05E9\u05DC\u05D5\u05DD";
+	auto & ents = bidi.linestr(hebrew.data(), hebrew.size());
+	REQUIRE(1 == ents.size());
+	CHECK(1 == ents[0].level);
+	CHECK(entity_text(ents[0]) == hebrew);
+
+	//A Hebrew word in a Latin line is at level 1, the Latin words and the spaces between them are at level 0.
+	const std::wstring mixed = L"abc \u05D0\u05D1 def";
+	std::vector<entity> reordered;
+	bidi.linestr(mixed.data(), mixed.size(), reordered);
+	CHECK(levels(mixed, reordered) == std::vector<unsigned>({0, 0, 0, 0, 1, 1, 0, 0, 0, 0}));
+
+	//The entities are in the visual order, the runs at level 0 around the Hebrew word keep their positions.
+	REQUIRE(reordered.size() > 2);
+	CHECK(entity_text(reordered.front()) == L"abc");
+	CHECK(entity_text(reordered.back()) == L"def");
+
+	//The context is reused, a following left-to-right line is not affected by the previous line.
+	const std::wstring latin = L"plain text";
+	auto & again = bidi.linestr(latin.data(), latin.size());
+	REQUIRE(1 == again.size());
+	CHECK(0 == again[0].level);
+}
+
+TEST_CASE("Resolves the lines of Latin, Hebrew and Arabic", "[.][benchmark][unicode_bidi]")
+{
+	const std::size_t lines = 20000;
+	const unsigned times = 10;
+
+	std::vector<std::vector<std::wstring> > corpora;
+	corpora.push_back(make_corpus({L"The", L"quick", L"brown", L"fox,", L"jumps", L"over", L"the", L"lazy", L"dog", L"1024."}, lines));
+	corpora.push_back(make_corpus({L"\u05E9\u05DC\u05D5\u05DD", L"\u05E2\u05D5\u05DC\u05DD,", L"\u05D6\u05D4\u05D5", L"\u05DE\u05D1\u05D7\u05DF", L"123", L"\u05E9\u05DC", L"\u05D8\u05E7\u05E1\u05D8."}, lines));
+	corpora.push_back(make_corpus({L"\u0645\u0631\u062D\u0628\u0627", L"\u0628\u0627\u0644\u0639\u0627\u0644\u0645,", L"\u0647\u0630\u0627", L"\u0627\u062E\u062A\u0628\u0627\u0631", L"\u0661\u0662\u0663", L"\u0644\u0644\u0646\u0635."}, lines));
+	const char * const names[] = {"Latin", "Hebrew", "Arabic"};
+
+	std::stringstream ss;
+	for(std::size_t k = 0; k < corpora.size(); ++k)
+	{
+		auto & corpus = corpora[k];
+		std::size_t entities = 0;
+
+		//A fresh context and result for every line, as the callers did before the context was reused.
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+		{
+			for(auto & line : corpus)
+			{
+				nana::unicode_bidi bidi;
+				std::vector<entity> reordered;
+				bidi.linestr(line.data(), line.size(), reordered);
+				entities += reordered.size();
+			}
+		}
+		const double fresh_ns = tmpiece.calc() * 1000000.0 / (times * corpus.size());
+
+		nana::unicode_bidi bidi;
+		tmpiece.start();
+		for(unsigned n = 0; n < times; ++n)
+		{
+			for(auto & line : corpus)
+				entities -= bidi.linestr(line.data(), line.size()).size();
+		}
+		const double reused_ns = tmpiece.calc() * 1000000.0 / (times * corpus.size());
+		CHECK(0 == entities);
+
+		ss<<names[k]<<": "<<fresh_ns<<" ns per line with a fresh context, "<<reused_ns<<" ns per line with a reused context\n";
+	}
+	WARN(ss.str());
+}
@@ -0,0 +1,47 @@
+#ifndef NANA_TEST_UTILITY_HPP
+#define NANA_TEST_UTILITY_HPP
+
+#include <vector>
+#include <fstream>
+
+namespace test
+{
+	//Writes a 24-bit BMP file of a gradient.
+	inline void write_bmp(const char* file, unsigned width, unsigned height)
+	{
+		const unsigned stride = (width * 3 + 3) & ~3u;
+		const unsigned bytes = stride * height;
+
+		unsigned char header[54] = {'B', 'M'};
+		auto put32 = [&header](std::size_t pos, unsigned value)
+		{
+			for(int i = 0; i < 4; ++i)
+				header[pos + i] = static_cast<unsigned char>(value >> (i * 8));
+		};
+		put32(2, 54 + bytes);
+		put32(10, 54);
+		put32(14, 40);
+		put32(18, width);
+		put32(22, height);
+		header[26] = 1;
+		header[28] = 24;
+		put32(34, bytes);
+
+		std::ofstream ofs(file, std::ios::binary);
+		ofs.write(reinterpret_cast<const char*>(header), sizeof header);
+
+		std::vector<char> row(stride);
+		for(unsigned y = 0; y < height; ++y)
+		{
+			for(unsigned x = 0; x < width; ++x)
+			{
+				row[x * 3] = static_cast<char>(x * 255 / width);
+				row[x * 3 + 1] = static_cast<char>(y * 255 / height);
+				row[x * 3 + 2] = static_cast<char>((x + y) & 0xFF);
+			}
+			ofs.write(row.data(), stride);
+		}
+	}
+}
+
+#endif
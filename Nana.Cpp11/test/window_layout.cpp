@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include <nana/gui/wvl.hpp>
+#include <nana/gui/widgets/panel.hpp>
+#include <nana/gui/drawing.hpp>
+#include <nana/gui/detail/bedrock.hpp>
+#include <nana/gui/detail/window_layout.hpp>
+#include <nana/system/timepiece.hpp>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	typedef nana::gui::detail::window_layout<nana::gui::detail::bedrock::core_window_t> window_layout;
+
+	bool same(const nana::rectangle& a, const nana::rectangle& b)
+	{
+		return (a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height);
+	}
+
+	//Moves a spot over the background for every frame, it returns the milliseconds per frame.
+	double animate(nana::gui::widget& background, unsigned frames, unsigned spot)
+	{
+		nana::gui::drawing dw(background);
+		const nana::size bgsize = background.size();
+
+		nana::system::timepiece tmpiece;
+		tmpiece.start();
+		for(unsigned n = 0; n < frames; ++n)
+		{
+			const int x = static_cast<int>((n * 7) % (bgsize.width - spot));
+			const int y = static_cast<int>((n * 3) % (bgsize.height - spot));
+			dw.clear();
+			dw.draw([x, y, spot](nana::paint::graphics& graph)
+			{
+				graph.rectangle(nana::rectangle(x, y, spot, spot), 0xFF4000, true);
+			});
+			nana::gui::API::refresh_window(background);
+		}
+		const double ms = tmpiece.calc();
+		dw.clear();
+		return ms / frames;
+	}
+}
+
+TEST_CASE("Retakes the effect of a glass window around the changed pixels", "[window_layout]")
+{
+	const nana::size dimension(200, 100);
+	nana::rectangle area, affected;
+
+	//The effect is taken for the changed area grown by twice the reach, and the changed area grown by the reach is copied back.
+	window_layout::effect_areas(nana::rectangle(50, 40, 10, 5), dimension, 3, area, affected);
+	CHECK(same(area, nana::rectangle(44, 34, 22, 17)));
+	CHECK(same(affected, nana::rectangle(47, 37, 16, 11)));
+
+	//The offset of the copied pixels in the effected pixels.
+	CHECK(3 == affected.x - area.x);
+	CHECK(3 == affected.y - area.y);
+
+	//Both areas are clipped to the window, and the offset is clipped with them.
+	window_layout::effect_areas(nana::rectangle(2, 0, 10, 1), dimension, 4, area, affected);
+	CHECK(same(area, nana::rectangle(0, 0, 20, 9)));
+	CHECK(same(affected, nana::rectangle(0, 0, 16, 5)));
+	CHECK(0 == affected.x - area.x);
+
+	window_layout::effect_areas(nana::rectangle(195, 90, 5, 10), dimension, 2, area, affected);
+	CHECK(same(area, nana::rectangle(191, 86, 9, 14)));
+	CHECK(same(affected, nana::rectangle(193, 88, 7, 12)));
+	CHECK(2 == affected.x - area.x);
+	CHECK(2 == affected.y - area.y);
+
+	//An effect which reaches the whole window is taken for the whole window.
+	window_layout::effect_areas(nana::rectangle(50, 40, 10, 5), dimension, 200, area, affected);
+	CHECK(same(area, nana::rectangle(dimension)));
+	CHECK(same(affected, nana::rectangle(dimension)));
+
+	//An effect without reach, such as the transparent, is retaken only for the changed area.
+	window_layout::effect_areas(nana::rectangle(50, 40, 10, 5), dimension, 0, area, affected);
+	CHECK(same(area, nana::rectangle(50, 40, 10, 5)));
+	CHECK(same(affected, nana::rectangle(50, 40, 10, 5)));
+}
+
+TEST_CASE("Animates a background under 20 glass panels", "[.][benchmark][window_layout]")
+{
+	const unsigned frames = 300;
+
+	nana::gui::form fm(nana::rectangle(0, 0, 1000, 800));
+	nana::gui::panel<true> background(fm, nana::rectangle(0, 0, 1000, 800));
+	background.background(0x2060A0);
+
+	std::vector<std::unique_ptr<nana::gui::panel<true> > > panels;
+	for(int i = 0; i < 20; ++i)
+	{
+		const int x = 20 + (i % 5) * 195;
+		const int y = 20 + (i / 5) * 195;
+		panels.emplace_back(new nana::gui::panel<true>(fm, nana::rectangle(x, y, 180, 180)));
+		nana::gui::API::effects_bground(*panels.back(), nana::gui::effects::bground_blur(2), 0);
+	}
+	fm.show();
+
+	const double small_spot = animate(background, frames, 40);
+	const double large_spot = animate(background, frames, 400);
+
+	std::stringstream ss;
+	ss<<panels.size()<<" blurred panels, ms per frame: "<<small_spot<<" with a 40x40 moving spot, "
+		<<large_spot<<" with a 400x400 moving spot";
+	WARN(ss.str());
+}